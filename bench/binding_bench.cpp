@@ -0,0 +1,87 @@
+#include <jsonbind.hpp>
+#include <jsonobject.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace jsonmini;
+
+struct Profile {
+    std::string firstName;
+    long age = 0;
+    bool employed = false;
+    std::vector<std::string> pets;
+    double popularityIndex = 0;
+};
+
+JSONMINI_FIELDS(Profile, firstName, age, employed, pets, popularityIndex)
+
+static std::string makeInput(size_t count) {
+    std::string json = "[";
+
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) json += ",";
+        json += "{\"firstName\": \"Felix " + std::to_string(i) + "\", \"age\": " + std::to_string(i % 90) +
+            ", \"employed\": " + (i % 2 ? "true" : "false") +
+            ", \"pets\": [\"dog\", \"cat\", \"parrot\"], \"popularityIndex\": 1.0343}";
+    }
+
+    return json + "]";
+}
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    const int rounds = 20;
+    std::string input = makeInput(10000);
+    size_t checksum = 0;
+
+    double treeMs = measure([&]() {
+        JsonObject obj;
+        obj << input.c_str();
+
+        std::vector<Profile> profiles;
+
+        for (auto& item : *obj.vector()) {
+            Profile profile;
+            profile.firstName = item["firstName"].str();
+            profile.age = item["age"].numberLong();
+            profile.employed = item["employed"].boolean();
+            profile.popularityIndex = item["popularityIndex"].number();
+
+            for (auto& pet : *item["pets"].vector()) {
+                profile.pets.push_back(pet.str());
+            }
+
+            profiles.push_back(profile);
+        }
+
+        checksum += profiles.size();
+    }, rounds);
+
+    double boundMs = measure([&]() {
+        std::vector<Profile> profiles;
+        decode(input, profiles);
+        checksum += profiles.size();
+    }, rounds);
+
+    double encodeMs = measure([&]() {
+        std::vector<Profile> profiles;
+        decode(input, profiles);
+        checksum += encode(profiles).size();
+    }, rounds) - boundMs;
+
+    std::cout << "input: " << input.size() << " bytes, checksum " << checksum << std::endl;
+    std::cout << "tree + manual copy: " << treeMs << " ms" << std::endl;
+    std::cout << "bound decode:       " << boundMs << " ms (" << treeMs / boundMs << "x)" << std::endl;
+    std::cout << "bound encode:       " << encodeMs << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func(i);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    const size_t pages = 10000;
+    JsonObject doc = JsonObject::makeArray();
+
+    for (size_t i = 0; i < pages; i++) {
+        doc[i] = page;
+    }
+
+    const int rounds = 50;
+    size_t size = 0;
+
+    // one leaf changes between two serializations, as in a document served again after a small update
+    auto run = [&](bool cache, bool min) {
+        doc.setSerializationCacheEnabled(cache);
+        doc.setMinificationEnabled(min);
+
+        std::stringstream warmup;
+        doc >> warmup;
+
+        return measure([&](int i) {
+            doc[(i * 7919) % pages]["name"] = (long)i;
+
+            std::stringstream out;
+            doc >> out;
+            size = out.str().size();
+        }, rounds);
+    };
+
+    double minSec = run(false, true);
+    double minCachedSec = run(true, true);
+    double minMb = size / (1024.0 * 1024.0);
+    double prettySec = run(false, false);
+    double prettyCachedSec = run(true, false);
+    double prettyMb = size / (1024.0 * 1024.0);
+
+    std::cout << "minified:        " << minSec * 1000 << " ms, " << minMb / minSec << " MB/s" << std::endl;
+    std::cout << "minified cached: " << minCachedSec * 1000 << " ms, " << minMb / minCachedSec << " MB/s" << std::endl;
+    std::cout << "pretty:          " << prettySec * 1000 << " ms, " << prettyMb / prettySec << " MB/s" << std::endl;
+    std::cout << "pretty cached:   " << prettyCachedSec * 1000 << " ms, " << prettyMb / prettyCachedSec << " MB/s" << std::endl;
+    std::cout << "cache held:      " << doc.footprint().cacheBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    // the same pages 2000 levels down, every level is on the path of a change
+    JsonObject deep = doc;
+    JsonObject* level = &deep;
+
+    for (int i = 0; i < 2000; i++) {
+        JsonObject next = JsonObject::makeMap();
+        next["id"] = (long)i;
+        next["down"] = std::move(*level);
+        *level = std::move(next);
+        level = &(*level)["down"];
+    }
+
+    deep.setMinificationEnabled(true);
+
+    auto runDeep = [&](bool cache) {
+        deep.setSerializationCacheEnabled(cache);
+
+        std::stringstream warmup;
+        deep >> warmup;
+
+        return measure([&](int i) {
+            (*level)[(i * 7919) % pages]["name"] = (long)i;
+
+            std::stringstream out;
+            deep >> out;
+            size = out.str().size();
+        }, rounds);
+    };
+
+    double deepSec = runDeep(false);
+    double deepCachedSec = runDeep(true);
+    double deepMb = size / (1024.0 * 1024.0);
+
+    std::cout << "deep:            " << deepSec * 1000 << " ms, " << deepMb / deepSec << " MB/s" << std::endl;
+    std::cout << "deep cached:     " << deepCachedSec * 1000 << " ms, " << deepMb / deepCachedSec << " MB/s" << std::endl;
+    std::cout << "deep cache held: " << deep.footprint().cacheBytes / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    return 0;
+}
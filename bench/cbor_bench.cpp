@@ -0,0 +1,69 @@
+#include <jsoncbor.hpp>
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    JsonObject doc = JsonObject::makeArray();
+
+    for (size_t i = 0; i < 10000; i++) {
+        doc[i] = page;
+        doc[i]["requestId"] = JsonObject((long)(5412985 + i));
+        doc[i]["popularity"] = JsonObject(i / 7.0);
+    }
+
+    const int rounds = 10;
+    std::string text, cbor;
+    size_t failures = 0;
+
+    double textEncodeMs = measure([&]() {
+        std::stringstream out;
+        doc >> out;
+        text = out.str();
+    }, rounds);
+
+    double cborEncodeMs = measure([&]() {
+        cbor.clear();
+        JsonCbor::encode(doc, cbor);
+    }, rounds);
+
+    double textDecodeMs = measure([&]() {
+        JsonObject obj;
+        if (!JsonObject::parse(text, obj)) failures++;
+    }, rounds);
+
+    double cborDecodeMs = measure([&]() {
+        JsonObject obj;
+        if (!JsonCbor::decode(cbor, obj)) failures++;
+    }, rounds);
+
+    std::cout << "size:   text " << text.size() << " bytes, CBOR " << cbor.size() << " bytes ("
+        << 100.0 * cbor.size() / text.size() << "%), failures " << failures << std::endl;
+    std::cout << "encode: text " << textEncodeMs << " ms, CBOR " << cborEncodeMs << " ms ("
+        << textEncodeMs / cborEncodeMs << "x)" << std::endl;
+    std::cout << "decode: text " << textDecodeMs << " ms, CBOR " << cborDecodeMs << " ms ("
+        << textDecodeMs / cborDecodeMs << "x)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    // multilingual strings the way ascii-only producers send them, emoji as surrogate pairs
+    const char* words[] = {
+        "\\u0420\\u0443\\u0441\\u0441\\u043a\\u0438\\u0439",
+        "\\u65e5\\u672c\\u8a9e",
+        "Fran\\u00e7ais",
+        "\\ud83d\\ude00\\ud83c\\udf89\\ud83d\\udc4d",
+        "\\u0627\\u0644\\u0639\\u0631\\u0628\\u064a\\u0629",
+        "line\\nbreak\\ttab \\\"quoted\\\" \\\\ slash\\/",
+        "\\ud83c\\uddeb\\ud83c\\uddf7 \\ud83c\\uddef\\ud83c\\uddf5"
+    };
+
+    std::string input = "[";
+
+    for (size_t i = 0; i < 100000; i++) {
+        if (i > 0) input += ',';
+        input += "{\"languages\":[\"";
+        input += words[i % 7];
+        input += "\",\"";
+        input += words[(i + 3) % 7];
+        input += "\"]}";
+    }
+
+    input += "]";
+
+    const double mb = input.size() / (1024.0 * 1024.0);
+    const int rounds = 10;
+
+    double streamSec = measure([&]() {
+        std::stringstream in(input);
+        JsonObject obj;
+        obj << in;
+    }, rounds);
+
+    double parseSec = measure([&]() {
+        JsonObject obj;
+        JsonObject::parse(input, obj);
+    }, rounds);
+
+    double validateSec = measure([&]() {
+        JsonObject::validate(input);
+    }, rounds);
+
+    std::cout << "input: " << mb << " MB" << std::endl;
+    std::cout << "stream parse: " << mb / streamSec << " MB/s" << std::endl;
+    std::cout << "parse:        " << mb / parseSec << " MB/s" << std::endl;
+    std::cout << "validate:     " << mb / validateSec << " MB/s" << std::endl;
+
+    return 0;
+}
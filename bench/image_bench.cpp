@@ -0,0 +1,78 @@
+#include <jsonimage.hpp>
+#include <jsonobject.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    JsonObject doc = JsonObject::makeArray();
+    for (int i = 0; i < 20000; i++) doc.vector()->push_back(page);
+
+    const char* textPath = "image_bench.json";
+    const char* imagePath = "image_bench.bin";
+
+    {
+        std::ofstream ofs(textPath);
+        doc.setMinificationEnabled(true);
+        doc >> ofs;
+    }
+
+    JsonImage::write(doc, imagePath);
+
+    const int rounds = 5;
+    long checksum = 0;
+
+    // cold start: load the document and read one deep field
+    double textSec = measure([&]() {
+        std::ifstream in(textPath);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+
+        JsonObject obj;
+        JsonObject::parse(buffer.str(), obj);
+        checksum += (*obj.get(12345)->get("requestId")).numberLong();
+    }, rounds);
+
+    double imageSec = measure([&]() {
+        JsonImage image;
+        image.open(imagePath);
+        checksum += image.root()[12345]["requestId"].numberLong();
+    }, rounds);
+
+    double verifySec = measure([&]() {
+        JsonImage image;
+        image.open(imagePath);
+        if (image.verify()) checksum += image.root()[12345]["requestId"].numberLong();
+    }, rounds);
+
+    std::cout << "checksum " << checksum << std::endl;
+    std::cout << "text parse + access:   " << textSec * 1000 << " ms" << std::endl;
+    std::cout << "image open + access:   " << imageSec * 1000 << " ms" << std::endl;
+    std::cout << "image verify + access: " << verifySec * 1000 << " ms" << std::endl;
+
+    std::remove(textPath);
+    std::remove(imagePath);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <jsonliteral.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace jsonmini;
+
+// heap blocks requested while a run is measured
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+static constexpr auto NOT_FOUND = JSONMINI_JSON(R"({
+    "error": {
+        "code": 404,
+        "message": "resource not found",
+        "details": ["check the path", "check the id"],
+        "retry": false
+    }
+})");
+
+template<class F>
+static void run(const char* label, size_t count, F func) {
+    size_t before = allocations;
+    auto begin = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < count; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << label << std::endl;
+    std::cout << "  " << count / elapsed.count() / 1000 << "k responses/s, "
+        << (double)(allocations - before) / count << " allocations per response" << std::endl;
+}
+
+int main() {
+    const size_t count = 1000000;
+    const std::string text(NOT_FOUND.minified());
+
+    // every response overwrites the start of one stream, its buffer keeps its capacity
+    std::ostringstream out;
+    out << std::string(4096, ' ');
+
+    run("parsed from text, then serialized", count, [&]() {
+        JsonObject obj;
+        JsonObject::parse(text, obj);
+
+        out.seekp(0);
+        obj >> out;
+    });
+
+    run("built with makeMap and operator [], then serialized", count, [&]() {
+        JsonObject obj = JsonObject::makeMap();
+        JsonObject& error = obj["error"];
+        error = JsonObject::makeMap();
+        error["code"] = 404L;
+        error["message"] = "resource not found";
+        error["details"] = JsonObject::makeArray();
+        error["details"][0] = "check the path";
+        error["details"][1] = "check the id";
+        error["retry"] = false;
+
+        out.seekp(0);
+        obj >> out;
+    });
+
+    run("compile-time literal, copied", count, [&]() {
+        out.seekp(0);
+        NOT_FOUND >> out;
+    });
+
+    return 0;
+}
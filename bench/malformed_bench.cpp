@@ -0,0 +1,69 @@
+#include <jsonobject.hpp>
+#include <jsonobjectexception.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace jsonmini;
+
+static std::vector<std::string> loadCases() {
+    std::ifstream ifs(MALFORMED_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    std::string text = ss.str();
+    std::vector<std::string> cases;
+    size_t begin = 0;
+
+    while (begin < text.size()) {
+        size_t end = text.find("\n\n", begin);
+        if (end == std::string::npos) end = text.size();
+        if (end > begin) cases.push_back(text.substr(begin, end - begin));
+        begin = end + 2;
+    }
+
+    return cases;
+}
+
+template<class F>
+static double measure(F func, size_t rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    const size_t rounds = 100000;
+    auto cases = loadCases();
+    size_t failures = 0;
+
+    double throwingNs = measure([&]() {
+        for (auto& json : cases) {
+            try {
+                JsonObject obj;
+                obj << json.c_str();
+            }
+            catch (JsonObjectException&) {
+                failures++;
+            }
+        }
+    }, rounds) / cases.size();
+
+    double parseNs = measure([&]() {
+        for (auto& json : cases) {
+            JsonObject obj;
+            if (!JsonObject::parse(json, obj)) failures++;
+        }
+    }, rounds) / cases.size();
+
+    std::cout << cases.size() << " malformed inputs, " << failures << " rejections" << std::endl;
+    std::cout << "operator << with exceptions: " << throwingNs << " ns/input" << std::endl;
+    std::cout << "JsonObject::parse:           " << parseNs << " ns/input (" << throwingNs / parseNs << "x)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+// the merge the gateway used to do by hand
+static void manualMerge(JsonObject& target, JsonObject& patch) {
+    if (!patch.isMap() || !target.isMap()) {
+        target = patch;
+        return;
+    }
+
+    for (auto& pair : *patch.map()) {
+        if (pair.second.isNull()) target.remove(pair.first);
+        else if (target.hasKey(pair.first)) manualMerge(target[pair.first], pair.second);
+        else target[pair.first] = pair.second;
+    }
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    JsonObject defaults = JsonObject::makeMap();
+    for (int i = 0; i < 50; i++) defaults["module" + std::to_string(i)] = page;
+
+    std::string overrideText = "{\"module3\":{\"requestId\":7,\"profiles\":null},\"module42\":{\"extra\":{\"on\":true}},\"module7\":null}";
+    JsonObject overrides;
+    JsonObject::parse(overrideText, overrides);
+
+    const int rounds = 2000;
+    size_t checksum = 0;
+
+    // a full per-request copy followed by a merge, the way the gateway worked before
+    double manualSec = measure([&]() {
+        JsonObject config;
+        std::stringstream text;
+        defaults >> text;
+        JsonObject::parse(text.str(), config);
+
+        JsonObject patch = overrides;
+        manualMerge(config, patch);
+        checksum += config.size();
+    }, 50);
+
+    double copySec = measure([&]() {
+        JsonObject config = defaults;
+        config.merge(overrides);
+        checksum += config.size();
+    }, rounds);
+
+    double moveSec = measure([&]() {
+        JsonObject config = defaults;
+        JsonObject patch;
+        JsonObject::parse(overrideText, patch);
+        config.merge(std::move(patch));
+        checksum += config.size();
+    }, rounds);
+
+    double parseMergeSec = measure([&]() {
+        JsonObject config = defaults;
+        JsonObject patch;
+        JsonObject::parse(overrideText, patch);
+        config.merge(patch);
+        checksum += config.size();
+    }, rounds);
+
+    double streamSec = measure([&]() {
+        JsonObject config = defaults;
+        config.mergeFrom(overrideText);
+        checksum += config.size();
+    }, rounds);
+
+    std::cout << "checksum " << checksum << std::endl;
+    std::cout << "deep copy + manual merge: " << manualSec * 1e6 << " us" << std::endl;
+    std::cout << "merge:                    " << copySec * 1e6 << " us" << std::endl;
+    std::cout << "parse + merge:            " << parseMergeSec * 1e6 << " us" << std::endl;
+    std::cout << "parse + merge(move):      " << moveSec * 1e6 << " us" << std::endl;
+    std::cout << "mergeFrom text:           " << streamSec * 1e6 << " us" << std::endl;
+
+    return 0;
+}
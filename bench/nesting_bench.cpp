@@ -0,0 +1,80 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+// deep documents need the depth limit raised, the default stops at 4096
+static void run(const char* label, const std::string& input, const JsonLimits& limits, int rounds) {
+    const double mb = input.size() / (1024.0 * 1024.0);
+
+    JsonObject doc;
+    JsonObject::parse(input, doc, limits);
+
+    double streamSec = measure([&]() {
+        std::stringstream in(input);
+        JsonObject obj;
+        obj.readStream(in, limits);
+    }, rounds);
+
+    double parseSec = measure([&]() {
+        JsonObject obj;
+        JsonObject::parse(input, obj, limits);
+    }, rounds);
+
+    double serializeSec = measure([&]() {
+        std::stringstream out;
+        doc >> out;
+    }, rounds);
+
+    std::cout << label << " (" << input.size() << " bytes)" << std::endl;
+    std::cout << "  stream parse: " << streamSec * 1000 << " ms, " << mb / streamSec << " MB/s" << std::endl;
+    std::cout << "  parse:        " << parseSec * 1000 << " ms, " << mb / parseSec << " MB/s" << std::endl;
+    std::cout << "  serialize:    " << serializeSec * 1000 << " ms, " << mb / serializeSec << " MB/s" << std::endl;
+}
+
+int main() {
+    const size_t depth = 10000;
+
+    JsonLimits deepLimits;
+    deepLimits.maxDepth = depth;
+
+    std::string arrays = std::string(depth, '[') + std::string(depth, ']');
+
+    std::string maps;
+    for (size_t i = 0; i < depth; i++) maps += "{\"a\":";
+    maps += "null";
+    maps += std::string(depth, '}');
+
+    std::string wideArray = "[";
+    for (size_t i = 0; i < 200000; i++) {
+        if (i > 0) wideArray += ',';
+        wideArray += (i % 3 == 0) ? std::to_string(i) : (i % 3 == 1) ? "\"item\"" : "true";
+    }
+    wideArray += "]";
+
+    std::string wideMap = "{";
+    for (size_t i = 0; i < 100000; i++) {
+        if (i > 0) wideMap += ',';
+        wideMap += "\"key" + std::to_string(i) + "\":" + std::to_string(i);
+    }
+    wideMap += "}";
+
+    run("nested arrays, depth 10000", arrays, deepLimits, 50);
+    run("nested maps, depth 10000", maps, deepLimits, 50);
+    run("wide array, 200000 items", wideArray, JsonLimits(), 10);
+    run("wide map, 100000 members", wideMap, JsonLimits(), 10);
+
+    return 0;
+}
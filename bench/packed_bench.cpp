@@ -0,0 +1,92 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+// non-const access to the items as nodes gives the tree one node per number
+static void unpackAll(JsonObject& obj) {
+    if (auto arr = obj.asVector()) {
+        for (auto& item : *arr) unpackAll(item);
+    }
+
+    if (auto map = obj.asMap()) {
+        for (auto& pair : *map) unpackAll(pair.second);
+    }
+}
+
+int main() {
+    // metrics series and a geo line, the numeric arrays make up nearly all of the text
+    std::string text = "{\"series\":[";
+
+    for (int s = 0; s < 50; s++) {
+        if (s > 0) text += ",";
+        text += "{\"name\":\"cpu" + std::to_string(s) + "\",\"timestamps\":[";
+
+        for (int i = 0; i < 2000; i++) text += (i > 0 ? "," : "") + std::to_string(1700000000000L + i * 15000L);
+
+        text += "],\"values\":[";
+
+        for (int i = 0; i < 2000; i++) text += (i > 0 ? "," : "") + std::to_string((i * 37 % 1000) / 7.0);
+
+        text += "]}";
+    }
+
+    text += "],\"line\":[";
+
+    for (int i = 0; i < 50000; i++) {
+        text += (i > 0 ? ",[" : "[") + std::to_string(13.0 + i * 1e-5) + "," + std::to_string(52.5 - i * 1e-5) + "]";
+    }
+
+    text += "]}";
+
+    const int rounds = 10;
+    double mb = text.size() / (1024.0 * 1024.0);
+    JsonObject obj;
+
+    double nodeParseSec = measure([&]() {
+        JsonObject::parse(text, obj);
+    }, rounds);
+
+    JsonLimits packing;
+    packing.packNumbers = true;
+
+    double parseSec = measure([&]() {
+        JsonObject::parse(text, obj, packing);
+    }, rounds);
+
+    auto serialize = [&]() {
+        std::stringstream out;
+        obj >> out;
+    };
+
+    JsonFootprint packed = obj.footprint();
+    double writeSec = measure(serialize, rounds);
+
+    unpackAll(obj);
+
+    JsonFootprint nodes = obj.footprint();
+    double nodeWriteSec = measure(serialize, rounds);
+
+    std::cout << "input:                  " << mb << " MB" << std::endl;
+    std::cout << "parse packed:           " << parseSec * 1000 << " ms, " << mb / parseSec << " MB/s" << std::endl;
+    std::cout << "parse nodes:            " << nodeParseSec * 1000 << " ms, " << mb / nodeParseSec << " MB/s" << std::endl;
+    std::cout << "serialize packed:       " << writeSec * 1000 << " ms, " << mb / writeSec << " MB/s" << std::endl;
+    std::cout << "serialize nodes:        " << nodeWriteSec * 1000 << " ms, " << mb / nodeWriteSec << " MB/s" << std::endl;
+    std::cout << "footprint packed:       " << packed.total() / (1024.0 * 1024.0) << " MB, " << packed.allocations << " allocations" << std::endl;
+    std::cout << "footprint nodes:        " << nodes.total() / (1024.0 * 1024.0) << " MB, " << nodes.allocations << " allocations" << std::endl;
+
+    return 0;
+}
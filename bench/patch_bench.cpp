@@ -0,0 +1,85 @@
+#include <jsonpatch.hpp>
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+static std::string minified(JsonObject& obj) {
+    std::stringstream ss;
+    obj.setMinificationEnabled(true);
+    obj >> ss;
+    return ss.str();
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    // a large config reloaded from text with a couple of changed fields
+    std::string pageText = ss.str();
+    std::string text = "{";
+
+    for (int i = 0; i < 2000; i++) {
+        if (i > 0) text += ",";
+        text += "\"section" + std::to_string(i) + "\":" + pageText;
+    }
+
+    text += "}";
+
+    JsonObject current, reloaded;
+    JsonObject::parse(text, current);
+    JsonObject::parse(text, reloaded);
+
+    reloaded["section17"]["requestId"] = JsonObject(1L);
+    reloaded["section1234"]["profiles"][0]["name"] = JsonObject("changed");
+
+    const int rounds = 10;
+    size_t changes = 0;
+
+    double stringSec = measure([&]() {
+        if (minified(current) != minified(reloaded)) changes++;
+    }, rounds);
+
+    double equalSec = measure([&]() {
+        if (current != reloaded) changes++;
+    }, rounds);
+
+    // hashes of the old tree stay cached between reloads, only the new one is hashed
+    current.hash();
+
+    double diffSec = measure([&]() {
+        JsonObject fresh = reloaded;
+        fresh["status"] = JsonObject("reloaded");
+        changes += JsonPatch::diff(current, fresh).size();
+    }, rounds);
+
+    JsonObject patch = JsonPatch::diff(current, reloaded);
+    std::string patchText = minified(patch);
+
+    double applySec = measure([&]() {
+        JsonObject target = current;
+        if (JsonPatch::apply(target, patch)) changes++;
+    }, rounds);
+
+    std::cout << "document: " << text.size() << " bytes, patch: " << patchText.size() << " bytes, changes " << changes << std::endl;
+    std::cout << "serialize + compare: " << stringSec * 1000 << " ms" << std::endl;
+    std::cout << "operator==:          " << equalSec * 1000 << " ms" << std::endl;
+    std::cout << "hash + diff:         " << diffSec * 1000 << " ms" << std::endl;
+    std::cout << "apply:               " << applySec * 1000 << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <jsonobject.hpp>
+#include <jsonpipe.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "loopbackserver.hpp"
+
+using namespace jsonmini;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Timing {
+    // from the request until the parser has the first byte of the body, and until the tree is done
+    double firstByte = 0;
+    double done = 0;
+};
+
+static double since(Clock::time_point begin) {
+    std::chrono::duration<double> elapsed = Clock::now() - begin;
+    return elapsed.count();
+}
+
+// what the curl helper did: the whole response is read, then parsed
+static Timing buffered(int port, bool streamParser) {
+    Timing timing;
+    auto begin = Clock::now();
+    int fd = httpGet(port, "/data");
+
+    std::string response;
+    char buffer[65536];
+    ssize_t size;
+
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0) response.append(buffer, size);
+    close(fd);
+
+    size_t body = response.find("\r\n\r\n") + 4;
+    timing.firstByte = since(begin);
+
+    JsonObject obj;
+
+    if (streamParser) {
+        std::stringstream in(response.substr(body));
+        obj.readStream(in, JsonLimits());
+    }
+    else JsonObject::parse(response.data() + body, response.size() - body, obj);
+
+    timing.done = since(begin);
+    return timing;
+}
+
+// reading and parsing overlap, the parser starts with the first block
+static Timing pipelined(int port) {
+    Timing timing;
+    auto begin = Clock::now();
+    int fd = httpGet(port, "/data");
+
+    {
+        JsonPipe pipe(fd);
+        std::istream in(&pipe);
+        readStatus(in);
+        timing.firstByte = since(begin);
+
+        JsonObject obj;
+        obj.readStream(in, JsonLimits());
+        timing.done = since(begin);
+    }
+
+    close(fd);
+    return timing;
+}
+
+template<class F>
+static Timing measure(F func, int rounds) {
+    Timing total;
+
+    for (int i = 0; i < rounds; i++) {
+        Timing timing = func();
+        total.firstByte += timing.firstByte / rounds;
+        total.done += timing.done / rounds;
+    }
+
+    return total;
+}
+
+static void print(const char* name, const Timing& timing, double mb) {
+    std::cout << name << timing.firstByte * 1000 << " ms to the first byte, " << timing.done * 1000 << " ms to the tree, "
+        << mb / timing.done << " MB/s" << std::endl;
+}
+
+int main() {
+    std::string text = "{\"records\":[";
+
+    for (int i = 0; i < 100000; i++) {
+        if (i > 0) text += ",";
+        text += "{\"id\":" + std::to_string(i) + ",\"name\":\"record " + std::to_string(i) + "\",\"score\":" +
+            std::to_string(i * 0.25) + ",\"tags\":[\"a\",\"b\"],\"pos\":{\"x\":" + std::to_string(i % 17) + ",\"y\":-1}}";
+    }
+
+    text += "]}";
+
+    const int rounds = 5;
+    double mb = text.size() / (1024.0 * 1024.0);
+
+    std::cout << "input: " << mb << " MB" << std::endl;
+
+    // the loopback as fast as it goes, then paced like a 100 Mbit/s link
+    for (size_t rate : { (size_t)0, (size_t)12500000 }) {
+        LoopbackServer server({ { "/data", text } }, rate);
+
+        if (rate == 0) std::cout << "unpaced loopback:" << std::endl;
+        else std::cout << "paced at " << rate / 1e6 << " MB/s:" << std::endl;
+
+        print("  buffered, buffer parser:  ", measure([&]() { return buffered(server.port(), false); }, rounds), mb);
+        print("  buffered, stream parser:  ", measure([&]() { return buffered(server.port(), true); }, rounds), mb);
+        print("  pipelined, stream parser: ", measure([&]() { return pipelined(server.port()); }, rounds), mb);
+    }
+
+    return 0;
+}
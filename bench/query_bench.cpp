@@ -0,0 +1,108 @@
+#include <jsonquery.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+static JsonQuery compile(const char* expression) {
+    JsonQuery query;
+    JsonQuery::compile(expression, query);
+    return query;
+}
+
+int main() {
+    // profiles with a few nested members each
+    std::string text = "{\"profiles\":[";
+
+    for (int i = 0; i < 200000; i++) {
+        if (i > 0) text += ",";
+        text += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i) + "\",\"age\":" + std::to_string(18 + i % 60) +
+            ",\"score\":" + std::to_string(i % 1000 / 10.0) + ",\"address\":{\"city\":\"c" + std::to_string(i % 100) + "\",\"zip\":\"" +
+            std::to_string(10000 + i % 9000) + "\"},\"tags\":[\"a\",\"b\"]}";
+    }
+
+    text += "]}";
+
+    JsonObject doc;
+    JsonObject::parse(text, doc);
+
+    const int rounds = 5;
+    double mb = text.size() / (1024.0 * 1024.0);
+
+    // how such loops are written against the public API: values are copied out of the tree
+    auto handSelect = [&]() {
+        JsonObject out = JsonObject::makeArray();
+        JsonObject profiles = doc["profiles"];
+
+        for (JsonObject profile : *profiles.vector()) {
+            if (profile["age"].numberLong() <= 30) continue;
+
+            JsonObject row = JsonObject::makeMap();
+            row["id"] = profile["id"];
+            row["city"] = profile["address"]["city"];
+            out.vector()->push_back(row);
+        }
+
+        return out;
+    };
+
+    auto handSum = [&]() {
+        double sum = 0;
+        JsonObject profiles = doc["profiles"];
+
+        for (JsonObject profile : *profiles.vector()) {
+            if (profile["age"].numberLong() > 30) sum += profile["score"].number();
+        }
+
+        return sum;
+    };
+
+    JsonQuery select = compile("profiles[?age > 30].{id: id, city: address.city}");
+    JsonQuery sum = compile("sum(profiles[?age > 30].score)");
+
+    size_t selected = 0;
+    double total = 0;
+
+    double handSelectSec = measure([&]() { selected += handSelect().size(); }, rounds);
+    double querySelectSec = measure([&]() { selected += select.evaluate(doc).size(); }, rounds);
+    double threadSelectSec = measure([&]() { selected += select.evaluate(doc, 4).size(); }, rounds);
+    double handSumSec = measure([&]() { total += handSum(); }, rounds);
+    double querySumSec = measure([&]() { total += sum.evaluate(doc).number(); }, rounds);
+    double threadSumSec = measure([&]() { total += sum.evaluate(doc, 4).number(); }, rounds);
+
+    // parse then query, or the query run while the text is read
+    double parseQuerySec = measure([&]() {
+        JsonObject parsed;
+        JsonObject::parse(text, parsed);
+        total += sum.evaluate(parsed).number();
+    }, rounds);
+
+    double streamSec = measure([&]() {
+        JsonObject out;
+        sum.evaluate(text, out);
+        total += out.number();
+    }, rounds);
+
+    std::cout << "input:                   " << mb << " MB, " << selected / (3 * rounds) << " selected" << std::endl;
+    std::cout << "select, hand loop:       " << handSelectSec * 1000 << " ms" << std::endl;
+    std::cout << "select, query:           " << querySelectSec * 1000 << " ms" << std::endl;
+    std::cout << "select, query 4 threads: " << threadSelectSec * 1000 << " ms" << std::endl;
+    std::cout << "sum, hand loop:          " << handSumSec * 1000 << " ms" << std::endl;
+    std::cout << "sum, query:              " << querySumSec * 1000 << " ms" << std::endl;
+    std::cout << "sum, query 4 threads:    " << threadSumSec * 1000 << " ms" << std::endl;
+    std::cout << "sum, parse then query:   " << parseQuerySec * 1000 << " ms" << std::endl;
+    std::cout << "sum, query on text:      " << streamSec * 1000 << " ms, " << mb / streamSec << " MB/s" << std::endl;
+
+    return total > 0 ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+#include <jsonparser.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace jsonmini;
+
+// heap blocks requested while a run is measured
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+template<class F>
+static void run(const char* label, size_t count, F func) {
+    size_t before = allocations;
+    auto begin = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < count; i++) func(i);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << label << std::endl;
+    std::cout << "  " << count / elapsed.count() / 1000 << "k messages/s, "
+        << (double)(allocations - before) / count << " allocations per message" << std::endl;
+}
+
+int main() {
+    const size_t count = 1000000;
+
+    // a rotation of telemetry-like messages of one shape, values and string lengths vary
+    std::vector<std::string> messages;
+    const char* names[] = { "temperature", "humidity", "pressure-sensor-with-long-id", "wind" };
+
+    for (size_t i = 0; i < 64; i++) {
+        messages.push_back("{\"id\":" + std::to_string(100000 + i * 7919) + ",\"sensor\":\"" + names[i % 4] +
+            "\",\"ts\":" + std::to_string(1700000000 + i) + ",\"values\":[" + std::to_string(i * 0.25) + "," +
+            std::to_string(i % 10) + "," + std::to_string(-(double)i) + "],\"meta\":{\"unit\":\"si\",\"ok\":" +
+            (i % 3 ? "true" : "false") + ",\"note\":null}}");
+    }
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) bytes += messages[i % messages.size()].size();
+
+    std::cout << count << " messages, " << bytes / count << " bytes on average" << std::endl;
+
+    run("new tree per message (JsonObject::parse)", count, [&](size_t i) {
+        JsonObject obj;
+        JsonObject::parse(messages[i % messages.size()], obj);
+    });
+
+    JsonObject reused;
+
+    run("one JsonObject parsed into again", count, [&](size_t i) {
+        JsonObject::parse(messages[i % messages.size()], reused);
+    });
+
+    JsonParser parser;
+    JsonDocument doc;
+
+    run("JsonParser into one JsonDocument", count, [&](size_t i) {
+        parser.parse(messages[i % messages.size()], doc);
+    });
+
+    return 0;
+}
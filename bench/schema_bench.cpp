@@ -0,0 +1,120 @@
+#include <jsonschema.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace jsonmini;
+
+static const char* SCHEMA = R"({
+    "type": "object",
+    "required": ["id", "user", "items"],
+    "properties": {
+        "id": { "type": "integer", "minimum": 1 },
+        "user": { "type": "string", "minLength": 1, "maxLength": 64 },
+        "currency": { "enum": ["EUR", "USD", "GBP"] },
+        "items": {
+            "type": "array",
+            "minItems": 1,
+            "items": {
+                "type": "object",
+                "required": ["sku", "qty", "price"],
+                "properties": {
+                    "sku": { "type": "string" },
+                    "qty": { "type": "integer", "minimum": 1, "maximum": 1000 },
+                    "price": { "type": "number", "minimum": 0 }
+                }
+            }
+        }
+    }
+})";
+
+// what the ingress did before: parse the whole request, then walk the tree
+static bool checkTree(JsonObject& req) {
+    if (!req.isMap() || !req.hasKey("id") || !req.hasKey("user") || !req.hasKey("items")) return false;
+
+    JsonObject& id = req["id"];
+    if (!id.isNumber() || id.number() != (double)id.numberLong() || id.numberLong() < 1) return false;
+
+    JsonObject& user = req["user"];
+    if (!user.isString() || user.str().empty() || user.str().size() > 64) return false;
+
+    if (req.hasKey("currency")) {
+        std::string currency = req["currency"].str();
+        if (currency != "EUR" && currency != "USD" && currency != "GBP") return false;
+    }
+
+    JsonObject& items = req["items"];
+    if (!items.isArray() || items.vector()->empty()) return false;
+
+    for (auto& item : *items.vector()) {
+        if (!item.isMap() || !item.hasKey("sku") || !item.hasKey("qty") || !item.hasKey("price")) return false;
+        if (!item["sku"].isString() || !item["qty"].isNumber() || !item["price"].isNumber()) return false;
+
+        long qty = item["qty"].numberLong();
+        if (qty < 1 || qty > 1000 || item["price"].number() < 0) return false;
+    }
+
+    return true;
+}
+
+template<class F>
+static void run(const char* label, const std::vector<std::string>& requests, F func) {
+    const int rounds = 20;
+    size_t accepted = 0;
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int r = 0; r < rounds; r++) {
+        for (auto& req : requests) accepted += func(req);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::cout << "  " << label << ": " << rounds * requests.size() / elapsed.count() / 1000 << "k requests/s, "
+        << accepted / rounds << " accepted" << std::endl;
+}
+
+int main() {
+    JsonObject doc;
+    JsonObject::parse(SCHEMA, doc);
+
+    JsonSchema schema;
+    JsonSchema::compile(doc, schema);
+
+    // orders of 40 items; the invalid ones have a bad id, which comes first
+    std::vector<std::string> valid, invalid;
+
+    for (size_t i = 0; i < 2000; i++) {
+        std::string items;
+
+        for (size_t k = 0; k < 40; k++) {
+            items += std::string(k ? "," : "") + "{\"sku\":\"SKU-" + std::to_string(i * 40 + k) + "\",\"qty\":" +
+                std::to_string(1 + k % 9) + ",\"price\":" + std::to_string(k * 1.25) + "}";
+        }
+
+        std::string tail = ",\"user\":\"customer-" + std::to_string(i) + "\",\"currency\":\"EUR\",\"items\":[" + items + "]}";
+
+        valid.push_back("{\"id\":" + std::to_string(i + 1) + tail);
+        invalid.push_back("{\"id\":-" + std::to_string(i + 1) + tail);
+    }
+
+    for (auto* set : { &valid, &invalid }) {
+        std::cout << (set == &valid ? "valid requests" : "requests with a bad id") << std::endl;
+
+        run("parse, then walk the tree", *set, [](const std::string& req) {
+            JsonObject obj;
+            return JsonObject::parse(req, obj) && checkTree(obj);
+        });
+
+        run("JsonSchema::parse", *set, [&](const std::string& req) {
+            JsonObject obj;
+            return schema.parse(req, obj).ok();
+        });
+
+        run("JsonSchema::validate", *set, [&](const std::string& req) {
+            return schema.validate(req).ok();
+        });
+    }
+
+    return 0;
+}
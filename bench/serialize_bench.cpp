@@ -0,0 +1,64 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    JsonObject doc = JsonObject::makeArray();
+
+    for (size_t i = 0; i < 10000; i++) {
+        doc[i] = page;
+    }
+
+    const int rounds = 10;
+    size_t size = 0;
+
+    auto run = [&](bool min, const JsonStyle& style) {
+        doc.setMinificationEnabled(min);
+        doc.setStyle(style);
+
+        return measure([&]() {
+            std::stringstream out;
+            doc >> out;
+            size = out.str().size();
+        }, rounds);
+    };
+
+    JsonStyle spaces;
+    spaces.indentChar = ' ';
+    spaces.indentWidth = 4;
+    spaces.compactArrayThreshold = 16;
+
+    double minSec = run(true, JsonStyle());
+    double minMb = size / (1024.0 * 1024.0);
+    double tabSec = run(false, JsonStyle());
+    double tabMb = size / (1024.0 * 1024.0);
+    double spaceSec = run(false, spaces);
+    double spaceMb = size / (1024.0 * 1024.0);
+
+    std::cout << "minified:         " << minSec * 1000 << " ms, " << minMb / minSec << " MB/s" << std::endl;
+    std::cout << "pretty (tabs):    " << tabSec * 1000 << " ms, " << tabMb / tabSec << " MB/s" << std::endl;
+    std::cout << "pretty (4 spaces, compact arrays): " << spaceSec * 1000 << " ms, " << spaceMb / spaceSec << " MB/s" << std::endl;
+
+    return 0;
+}
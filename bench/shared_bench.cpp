@@ -0,0 +1,55 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    // a response template with a large static part and a couple of per-request fields
+    JsonObject response = JsonObject::makeMap();
+    response["status"] = JsonObject("ok");
+    response["requestId"] = JsonObject(0L);
+
+    JsonObject& catalog = response["catalog"] = JsonObject::makeArray();
+    for (int i = 0; i < 200; i++) catalog.vector()->push_back(page);
+
+    const int rounds = 2000;
+    long checksum = 0;
+
+    double copySec = measure([&]() {
+        JsonObject copy = response;
+        checksum += copy.size();
+    }, rounds);
+
+    double variantSec = measure([&]() {
+        JsonObject copy = response;
+        copy["requestId"] = JsonObject((long)checksum);
+        copy["catalog"][0]["requestId"] = JsonObject(1L);
+        checksum += copy["requestId"].numberLong();
+    }, rounds);
+
+    std::cout << "checksum " << checksum << std::endl;
+    std::cout << "copy:           " << copySec * 1e6 << " us" << std::endl;
+    std::cout << "copy + 2 edits: " << variantSec * 1e6 << " us" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <jsonobject.hpp>
+#include <jsonstats.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// built against jsonmini_stats, compare with validate_bench and serialize_bench for the plain library
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonObject::parse(ss.str(), page);
+
+    JsonObject doc = JsonObject::makeArray();
+
+    for (size_t i = 0; i < 10000; i++) {
+        doc[i] = page;
+    }
+
+    std::stringstream minified;
+    doc >> minified;
+
+    const std::string input = minified.str();
+    const double mb = input.size() / (1024.0 * 1024.0);
+    const int rounds = 10;
+
+    auto run = [&](const char* label) {
+        double parseSec = measure([&]() {
+            JsonObject obj;
+            JsonObject::parse(input, obj);
+        }, rounds);
+
+        double validateSec = measure([&]() {
+            JsonObject::validate(input);
+        }, rounds);
+
+        double serializeSec = measure([&]() {
+            std::stringstream out;
+            doc >> out;
+        }, rounds);
+
+        std::cout << label << std::endl;
+        std::cout << "  parse:     " << mb / parseSec << " MB/s" << std::endl;
+        std::cout << "  validate:  " << mb / validateSec << " MB/s" << std::endl;
+        std::cout << "  serialize: " << mb / serializeSec << " MB/s" << std::endl;
+    };
+
+    std::cout << "input: " << mb << " MB" << std::endl;
+
+    run("hooks compiled in, nothing collected");
+
+    JsonStats stats;
+    JsonStats::setSink(&stats);
+
+    run("collecting");
+
+    JsonStats::setSink(nullptr);
+
+    std::cout << "per round: " << stats.totalNodes() / (3 * rounds) << " nodes, depth " << stats.maxDepth
+        << ", " << stats.escapesRead / (2 * rounds) << " escapes read, "
+        << stats.allocations / rounds << " allocations" << std::endl;
+    std::cout << "phase time: parse " << stats.nanoseconds[JSON_PHASE_PARSE] / 1e6 / rounds
+        << " ms, validate " << stats.nanoseconds[JSON_PHASE_VALIDATE] / 1e6 / rounds
+        << " ms, serialize " << stats.nanoseconds[JSON_PHASE_SERIALIZE] / 1e6 / rounds << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <jsontape.hpp>
+#include <jsonobject.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    // an array of flat records, the common bulk traversal case
+    std::string input = "[";
+
+    for (int i = 0; i < 200000; i++) {
+        if (i > 0) input += ",";
+        input += "{\"id\":" + std::to_string(i) + ",\"name\":\"user" + std::to_string(i) +
+            "\",\"score\":" + std::to_string(i % 100) + ".5,\"active\":true}";
+    }
+
+    input += "]";
+
+    const int rounds = 10;
+    const double mb = input.size() / (1024.0 * 1024.0);
+    double checksum = 0;
+
+    JsonObject tree;
+    JsonTape tape;
+
+    double treeParseSec = measure([&]() {
+        JsonObject::parse(input, tree);
+    }, rounds);
+
+    double tapeParseSec = measure([&]() {
+        JsonTape::parse(input, tape);
+    }, rounds);
+
+    double treeWalkSec = measure([&]() {
+        for (auto& record : *tree.vector()) checksum += record.get("score")->number();
+    }, rounds);
+
+    double tapeWalkSec = measure([&]() {
+        for (JsonTapeView record : tape.root()) checksum += record["score"].number();
+    }, rounds);
+
+    std::cout << "input: " << mb << " MB, checksum " << checksum << std::endl;
+    std::cout << "tree parse: " << mb / treeParseSec << " MB/s" << std::endl;
+    std::cout << "tape parse: " << mb / tapeParseSec << " MB/s" << std::endl;
+    std::cout << "tree walk:  " << treeWalkSec * 1000 << " ms" << std::endl;
+    std::cout << "tape walk:  " << tapeWalkSec * 1000 << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <jsonobject.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonmini;
+
+template<class F>
+static double measure(F func, int rounds) {
+    auto begin = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < rounds; i++) func();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / rounds;
+}
+
+int main() {
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject doc;
+    JsonObject::parse(ss.str(), doc);
+
+    std::stringstream minified;
+    doc >> minified;
+
+    std::string page = minified.str();
+    std::string input = "[";
+
+    while (input.size() < 16 * 1024 * 1024) {
+        if (input.size() > 1) input += ",";
+        input += page;
+    }
+
+    input += "]";
+
+    const int rounds = 10;
+    const double mb = input.size() / (1024.0 * 1024.0);
+    std::string copy(input.size(), '\0');
+    size_t failures = 0;
+
+    double memcpySec = measure([&]() {
+        std::memcpy(&copy[0], input.data(), input.size());
+    }, rounds);
+
+    double validateSec = measure([&]() {
+        if (!JsonObject::validate(input)) failures++;
+    }, rounds);
+
+    double parseSec = measure([&]() {
+        JsonObject obj;
+        if (!JsonObject::parse(input, obj)) failures++;
+    }, rounds);
+
+    std::cout << "input: " << mb << " MB, failures " << failures << std::endl;
+    std::cout << "memcpy:   " << mb / memcpySec << " MB/s" << std::endl;
+    std::cout << "validate: " << mb / validateSec << " MB/s" << std::endl;
+    std::cout << "parse:    " << mb / parseSec << " MB/s" << std::endl;
+
+    return 0;
+}
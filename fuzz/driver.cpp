@@ -0,0 +1,214 @@
+// standalone replacement for the libFuzzer main: replays the corpus, then feeds
+// deterministic mutations of it to the target, accepts the same -runs and -seed flags
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static const size_t MAX_LEN = 4096;
+
+// tokens spliced into inputs, mostly grammar pieces the byte mutations rarely produce
+static const std::vector<std::string> _KEYWORDS = { "true", "false", "null" };
+
+static const std::vector<std::string> _NUMBERS = {
+    "0", "1", "9", "-0", "1e5", "1E-5", "0.5", "-1.25e+3", "1e-5", "123456789012",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808", "1e400", "4.9e-324"
+};
+
+static const std::vector<std::string> _STRING_PARTS = {
+    "\\n", "\\t", "\\r", "\\b", "\\f", "\\/", "\\\\", "\\\"", "\\u0041", "\\u00e9", "\\u20ac", "\\u0000", "\\u001f",
+    "\\ud83d\\ude00", "\\uD834\\uDD1E", "\\ud83d", "\\ude00", "\\uZZZZ",
+    "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xc3", "\x80", "\xff", "\x1c", "\x1f", "\x7f"
+};
+
+static const std::vector<std::string> _TOKENS = {
+    "{", "}", "[", "]", ",", ":", "\"", "\\", " ", "\n", "\t", "-", "+", ".", "e", "E",
+    "\"key\":", "{\"a\":1}", "[1,2,3]", "[[[[", "]]]]", "{\"\":\"\"}"
+};
+
+template<class Rng>
+static const std::string& pick(const std::vector<std::string>& list, Rng& rng) {
+    return list[rng() % list.size()];
+}
+
+static std::vector<std::string> _corpus;
+
+static bool readFile(const std::string& path, std::string& out) {
+    std::ifstream ifs(path, std::ios_base::binary);
+    if (!ifs.is_open()) return false;
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+static void loadPath(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return;
+
+        std::vector<std::string> names;
+
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+        }
+
+        closedir(dir);
+        std::sort(names.begin(), names.end());
+
+        for (auto& name : names) loadPath(path + "/" + name);
+        return;
+    }
+
+    std::string content;
+    if (readFile(path, content)) _corpus.push_back(content.substr(0, MAX_LEN));
+}
+
+static void run(const std::string& input) {
+    // a private copy so that reads past the end are caught by sanitizers
+    std::vector<uint8_t> buffer(input.begin(), input.end());
+    LLVMFuzzerTestOneInput(buffer.data(), buffer.size());
+}
+
+static void saveCrash(const std::string& input) {
+    std::ofstream ofs("crash-input", std::ios_base::binary | std::ios_base::trunc);
+    ofs.write(input.data(), input.size());
+}
+
+template<class Rng>
+static std::string randomValue(Rng& rng, int depth) {
+    switch (rng() % (depth > 6 ? 4 : 6)) {
+        case 0: return pick(_KEYWORDS, rng);
+        case 1: return pick(_NUMBERS, rng);
+        case 2:
+        {
+            std::string str = "\"";
+            size_t count = rng() % 6;
+
+            for (size_t i = 0; i < count; i++) {
+                if (rng() % 3 == 0) str += pick(_STRING_PARTS, rng);
+                else str += (char)('a' + rng() % 26);
+            }
+
+            return str + "\"";
+        }
+        case 3: return "\"" + std::string(rng() % 3, 'x') + "\"";
+        case 4:
+        {
+            std::string arr = "[";
+            size_t count = rng() % 5;
+
+            for (size_t i = 0; i < count; i++) {
+                if (i > 0) arr += ",";
+                arr += randomValue(rng, depth + 1);
+            }
+
+            return arr + "]";
+        }
+        default:
+        {
+            std::string map = "{";
+            size_t count = rng() % 5;
+
+            for (size_t i = 0; i < count; i++) {
+                if (i > 0) map += ",";
+                map += "\"k" + std::to_string(rng() % 4) + "\":" + randomValue(rng, depth + 1);
+            }
+
+            return map + "}";
+        }
+    }
+}
+
+template<class Rng>
+static std::string mutate(std::string input, Rng& rng) {
+    size_t steps = 1 + rng() % 4;
+
+    for (size_t step = 0; step < steps; step++) {
+        size_t pos = input.empty() ? 0 : rng() % (input.size() + 1);
+
+        switch (rng() % 7) {
+            case 0:
+                if (!input.empty() && pos < input.size()) input[pos] ^= (char)(1 << (rng() % 8));
+            break;
+            case 1:
+                if (!input.empty() && pos < input.size()) input[pos] = (char)(rng() % 256);
+            break;
+            case 2:
+                if (pos < input.size()) input.erase(pos, 1 + rng() % std::min<size_t>(8, input.size() - pos));
+            break;
+            case 3:
+            {
+                const std::vector<std::string>* lists[] = { &_TOKENS, &_KEYWORDS, &_NUMBERS, &_STRING_PARTS };
+                input.insert(pos, pick(*lists[rng() % 4], rng));
+            }
+            break;
+            case 4:
+                if (pos < input.size()) {
+                    size_t len = 1 + rng() % std::min<size_t>(16, input.size() - pos);
+                    input.insert(rng() % (input.size() + 1), input.substr(pos, len));
+                }
+            break;
+            case 5:
+            {
+                const std::string& other = _corpus[rng() % _corpus.size()];
+                size_t from = other.empty() ? 0 : rng() % other.size();
+                input.insert(pos, other.substr(from, rng() % 64));
+            }
+            break;
+            default:
+                input.insert(pos, randomValue(rng, 0));
+            break;
+        }
+    }
+
+    if (input.size() > MAX_LEN) input.resize(MAX_LEN);
+    return input;
+}
+
+int main(int argc, char** argv) {
+    long runs = 10000;
+    unsigned long seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "-runs=", 6) == 0) runs = std::atol(argv[i] + 6);
+        else if (std::strncmp(argv[i], "-seed=", 6) == 0) seed = std::strtoul(argv[i] + 6, nullptr, 10);
+        else if (argv[i][0] != '-') loadPath(argv[i]);
+    }
+
+    if (_corpus.empty()) _corpus.push_back("");
+
+    for (auto& input : _corpus) {
+        saveCrash(input);
+        run(input);
+    }
+
+    std::mt19937_64 rng(seed);
+
+    for (long i = 0; i < runs; i++) {
+        std::string input = (i % 4 == 0) ? randomValue(rng, 0) : mutate(_corpus[rng() % _corpus.size()], rng);
+
+        saveCrash(input);
+        run(input);
+    }
+
+    std::remove("crash-input");
+    std::printf("Done %zu corpus inputs and %ld mutations (seed %lu)\n", _corpus.size(), runs, seed);
+
+    return 0;
+}
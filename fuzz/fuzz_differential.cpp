@@ -0,0 +1,48 @@
+#include "fuzzcheck.hpp"
+#include <jsonobjectexception.hpp>
+#include <jsonparser.hpp>
+#include <cstdint>
+#include <sstream>
+
+using namespace jsonmini;
+
+// the stream parser is the reference implementation, the buffer parsers must build the same trees
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string text((const char*)data, size);
+
+    JsonObject fast;
+    JsonResult result = JsonObject::parse(text, fast);
+
+    // one document recycled through every input has to come out as the fresh tree
+    static JsonParser parser;
+    static JsonDocument doc;
+
+    JsonResult reused = parser.parse(text, doc);
+    FUZZ_CHECK(reused.error == result.error && reused.pos == result.pos);
+    FUZZ_CHECK(doc.root() == fast);
+
+    JsonObject reference;
+    bool accepted = true;
+
+    try {
+        std::stringstream stream(text);
+        reference << stream;
+    }
+    catch (JsonObjectException&) {
+        accepted = false;
+    }
+
+    if (accepted != result.ok()) {
+        std::fprintf(stderr, "reference %s, buffer parser %s (%s at %zu)\n",
+            accepted ? "accepts" : "rejects", result.ok() ? "accepts" : "rejects", result.message(), result.pos);
+    }
+
+    FUZZ_CHECK(accepted == result.ok());
+    if (!accepted) return 0;
+
+    FUZZ_CHECK(reference == fast);
+    FUZZ_CHECK(fuzz::serialize(reference) == fuzz::serialize(fast));
+    FUZZ_CHECK(fuzz::serialize(reference, false) == fuzz::serialize(fast, false));
+
+    return 0;
+}
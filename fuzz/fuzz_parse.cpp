@@ -0,0 +1,33 @@
+#include "fuzzcheck.hpp"
+#include <jsontape.hpp>
+#include <cstdint>
+
+using namespace jsonmini;
+
+// the tree parser, the validator and the tape parser must agree on every input
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const char* text = (const char*)data;
+
+    JsonObject obj;
+    JsonResult parsed = JsonObject::parse(text, size, obj);
+    JsonResult validated = JsonObject::validate(text, size);
+
+    FUZZ_CHECK(parsed.error == validated.error);
+    FUZZ_CHECK(parsed.pos == validated.pos);
+    FUZZ_CHECK(parsed.ok() || obj.isNull());
+
+    JsonTape tape;
+    JsonResult taped = JsonTape::parse(text, size, tape);
+
+    // the tape tracks nesting on an explicit stack, the validator on a bit stack of the same depth
+    FUZZ_CHECK(taped.error == validated.error);
+    FUZZ_CHECK(taped.pos == validated.pos);
+
+    if (parsed.ok()) {
+        JsonObject fromTape = tape.root().toObject();
+        FUZZ_CHECK(fromTape == obj);
+        FUZZ_CHECK(fuzz::serialize(fromTape) == fuzz::serialize(obj));
+    }
+
+    return 0;
+}
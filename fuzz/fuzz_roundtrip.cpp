@@ -0,0 +1,56 @@
+#include "fuzzcheck.hpp"
+#include <jsoncbor.hpp>
+#include <jsonimage.hpp>
+#include <cstdint>
+
+using namespace jsonmini;
+
+// parse -> serialize -> parse must be lossless for every output format
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const char* text = (const char*)data;
+
+    // binary decoders see the raw bytes too, they must fail cleanly
+    JsonObject binary;
+    JsonCbor::decode(text, size, binary);
+
+    if (size >= 8 && ((uintptr_t)text % 8) == 0) {
+        JsonImage raw;
+        if (raw.open(text, size)) raw.verify();
+    }
+
+    JsonObject obj;
+    if (!JsonObject::parse(text, size, obj)) return 0;
+
+    std::string minified = fuzz::serialize(obj, true);
+    JsonObject again;
+    FUZZ_CHECK(JsonObject::parse(minified, again));
+    FUZZ_CHECK(again == obj && again.hash() == obj.hash());
+    FUZZ_CHECK(fuzz::serialize(again, true) == minified);
+
+    JsonStyle style;
+    style.indentChar = ' ';
+    style.indentWidth = 2;
+    style.compactArrayThreshold = 4;
+    obj.setStyle(style);
+
+    std::string pretty = fuzz::serialize(obj, false);
+    FUZZ_CHECK(JsonObject::parse(pretty, again));
+    FUZZ_CHECK(again == obj);
+
+    std::string cbor = JsonCbor::encode(obj);
+    FUZZ_CHECK(JsonCbor::decode(cbor, again));
+    FUZZ_CHECK(again == obj);
+    FUZZ_CHECK(JsonCbor::encode(again) == cbor);
+
+    std::string image;
+    FUZZ_CHECK(JsonImage::write(obj, image));
+
+    JsonImage opened;
+    FUZZ_CHECK(opened.open(image.data(), image.size()));
+    FUZZ_CHECK(opened.verify());
+
+    again = opened.root().toObject();
+    FUZZ_CHECK(again == obj);
+
+    return 0;
+}
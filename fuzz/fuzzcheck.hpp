@@ -0,0 +1,28 @@
+#ifndef FUZZCHECK_HPP
+#define FUZZCHECK_HPP
+
+#include <jsonobject.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+// unlike assert it stays active in release builds, which is how fuzzers are usually run
+#define FUZZ_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::abort(); \
+        } \
+    } while (0)
+
+namespace fuzz {
+    inline std::string serialize(jsonmini::JsonObject& obj, bool min = true) {
+        std::stringstream ss;
+        obj.setMinificationEnabled(min);
+        obj >> ss;
+        return ss.str();
+    }
+}
+
+#endif
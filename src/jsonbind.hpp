@@ -0,0 +1,320 @@
+#ifndef JSONBIND_HPP
+#define JSONBIND_HPP
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "jsonreader.hpp"
+#include "jsonstats.hpp"
+#include "jsonwriter.hpp"
+
+// declares the members of a struct that are bound to JSON map properties,
+// e.g. JSONMINI_FIELDS(Profile, firstName, age, pets) next to the struct definition
+#define JSONMINI_FIELDS(Type, ...) \
+    inline auto jsonminiFields(const Type*) { \
+        return std::make_tuple(JSONMINI_FOR_EACH(JSONMINI_FIELD, Type, __VA_ARGS__)); \
+    }
+
+#define JSONMINI_FIELD(Type, name) ::jsonmini::makeJsonField(#name, &Type::name)
+
+#define JSONMINI_EXPAND(x) x
+#define JSONMINI_FE_1(m, t, x) m(t, x)
+#define JSONMINI_FE_2(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_1(m, t, __VA_ARGS__))
+#define JSONMINI_FE_3(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_2(m, t, __VA_ARGS__))
+#define JSONMINI_FE_4(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_3(m, t, __VA_ARGS__))
+#define JSONMINI_FE_5(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_4(m, t, __VA_ARGS__))
+#define JSONMINI_FE_6(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_5(m, t, __VA_ARGS__))
+#define JSONMINI_FE_7(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_6(m, t, __VA_ARGS__))
+#define JSONMINI_FE_8(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_7(m, t, __VA_ARGS__))
+#define JSONMINI_FE_9(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_8(m, t, __VA_ARGS__))
+#define JSONMINI_FE_10(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_9(m, t, __VA_ARGS__))
+#define JSONMINI_FE_11(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_10(m, t, __VA_ARGS__))
+#define JSONMINI_FE_12(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_11(m, t, __VA_ARGS__))
+#define JSONMINI_FE_13(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_12(m, t, __VA_ARGS__))
+#define JSONMINI_FE_14(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_13(m, t, __VA_ARGS__))
+#define JSONMINI_FE_15(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_14(m, t, __VA_ARGS__))
+#define JSONMINI_FE_16(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_15(m, t, __VA_ARGS__))
+#define JSONMINI_FE_17(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_16(m, t, __VA_ARGS__))
+#define JSONMINI_FE_18(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_17(m, t, __VA_ARGS__))
+#define JSONMINI_FE_19(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_18(m, t, __VA_ARGS__))
+#define JSONMINI_FE_20(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_19(m, t, __VA_ARGS__))
+#define JSONMINI_FE_21(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_20(m, t, __VA_ARGS__))
+#define JSONMINI_FE_22(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_21(m, t, __VA_ARGS__))
+#define JSONMINI_FE_23(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_22(m, t, __VA_ARGS__))
+#define JSONMINI_FE_24(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_23(m, t, __VA_ARGS__))
+#define JSONMINI_FE_25(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_24(m, t, __VA_ARGS__))
+#define JSONMINI_FE_26(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_25(m, t, __VA_ARGS__))
+#define JSONMINI_FE_27(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_26(m, t, __VA_ARGS__))
+#define JSONMINI_FE_28(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_27(m, t, __VA_ARGS__))
+#define JSONMINI_FE_29(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_28(m, t, __VA_ARGS__))
+#define JSONMINI_FE_30(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_29(m, t, __VA_ARGS__))
+#define JSONMINI_FE_31(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_30(m, t, __VA_ARGS__))
+#define JSONMINI_FE_32(m, t, x, ...) m(t, x), JSONMINI_EXPAND(JSONMINI_FE_31(m, t, __VA_ARGS__))
+#define JSONMINI_FE_PICK( \
+    _1, _2, _3, _4, _5, _6, _7, _8, \
+    _9, _10, _11, _12, _13, _14, _15, _16, \
+    _17, _18, _19, _20, _21, _22, _23, _24, \
+    _25, _26, _27, _28, _29, _30, _31, _32, \
+    NAME, ...) NAME
+#define JSONMINI_FOR_EACH(m, t, ...) JSONMINI_EXPAND(JSONMINI_FE_PICK(__VA_ARGS__, \
+    JSONMINI_FE_32, JSONMINI_FE_31, JSONMINI_FE_30, JSONMINI_FE_29, \
+    JSONMINI_FE_28, JSONMINI_FE_27, JSONMINI_FE_26, JSONMINI_FE_25, \
+    JSONMINI_FE_24, JSONMINI_FE_23, JSONMINI_FE_22, JSONMINI_FE_21, \
+    JSONMINI_FE_20, JSONMINI_FE_19, JSONMINI_FE_18, JSONMINI_FE_17, \
+    JSONMINI_FE_16, JSONMINI_FE_15, JSONMINI_FE_14, JSONMINI_FE_13, \
+    JSONMINI_FE_12, JSONMINI_FE_11, JSONMINI_FE_10, JSONMINI_FE_9, \
+    JSONMINI_FE_8, JSONMINI_FE_7, JSONMINI_FE_6, JSONMINI_FE_5, \
+    JSONMINI_FE_4, JSONMINI_FE_3, JSONMINI_FE_2, JSONMINI_FE_1)(m, t, __VA_ARGS__))
+
+namespace jsonmini {
+    template<class T, class M>
+    struct JsonField {
+        std::string_view name;
+        M T::* member;
+    };
+
+    template<class T, class M, size_t N>
+    constexpr JsonField<T, M> makeJsonField(const char (&name)[N], M T::* member) {
+        return JsonField<T, M> { std::string_view(name, N - 1), member };
+    }
+
+    // read/write specializations for the supported value types
+    template<class T, class Enable = void>
+    struct JsonBinding;
+
+    namespace detail {
+        template<class T, class = void>
+        struct HasFields : std::false_type { };
+
+        template<class T>
+        struct HasFields<T, std::void_t<decltype(jsonminiFields(static_cast<const T*>(nullptr)))>> : std::true_type { };
+    }
+
+    template<>
+    struct JsonBinding<bool> {
+        static bool read(JsonReader& reader, bool& value) {
+            return reader.readBoolean(value);
+        }
+
+        static void write(JsonWriter& writer, bool value) {
+            writer.writeBoolean(value);
+        }
+    };
+
+    template<>
+    struct JsonBinding<std::string> {
+        static bool read(JsonReader& reader, std::string& value) {
+            return reader.readString(value);
+        }
+
+        static void write(JsonWriter& writer, const std::string& value) {
+            writer.writeString(value);
+        }
+    };
+
+    template<class T>
+    struct JsonBinding<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+        static bool read(JsonReader& reader, T& value) {
+            long long num;
+
+            if (!reader.readInteger(num)) return false;
+
+            if constexpr (std::is_unsigned_v<T>) {
+                if (num < 0 || (unsigned long long)num > std::numeric_limits<T>::max()) {
+                    return reader.reject(JSON_ERROR_NUMBER_OUT_OF_RANGE);
+                }
+            }
+            else {
+                if (num < std::numeric_limits<T>::min() || num > std::numeric_limits<T>::max()) {
+                    return reader.reject(JSON_ERROR_NUMBER_OUT_OF_RANGE);
+                }
+            }
+
+            value = (T)num;
+            return true;
+        }
+
+        static void write(JsonWriter& writer, T value) {
+            writer.writeInteger((long long)value);
+        }
+    };
+
+    template<class T>
+    struct JsonBinding<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        static bool read(JsonReader& reader, T& value) {
+            double num;
+            bool real;
+
+            if (!reader.readNumber(num, real)) return false;
+
+            value = (T)num;
+            return true;
+        }
+
+        static void write(JsonWriter& writer, T value) {
+            writer.writeNumber(value, true);
+        }
+    };
+
+    template<class T>
+    struct JsonBinding<std::vector<T>> {
+        static bool read(JsonReader& reader, std::vector<T>& value) {
+            if (!reader.beginArray()) return false;
+
+            bool first = true;
+            value.clear();
+
+            while (reader.nextItem(first)) {
+                if (!JsonBinding<T>::read(reader, value.emplace_back())) return false;
+            }
+
+            return !reader.failed();
+        }
+
+        static void write(JsonWriter& writer, const std::vector<T>& value) {
+            writer.put('[');
+
+            for (size_t i = 0; i < value.size(); i++) {
+                if (i > 0) writer.put(',');
+                JsonBinding<T>::write(writer, value[i]);
+            }
+
+            writer.put(']');
+        }
+    };
+
+    template<class T>
+    struct JsonBinding<std::optional<T>> {
+        static bool read(JsonReader& reader, std::optional<T>& value) {
+            if (reader.peek() == 'n') {
+                value.reset();
+                return reader.readNull();
+            }
+
+            return JsonBinding<T>::read(reader, value.emplace());
+        }
+
+        static void write(JsonWriter& writer, const std::optional<T>& value) {
+            if (value) JsonBinding<T>::write(writer, *value);
+            else writer.writeNull();
+        }
+    };
+
+    template<class T>
+    struct JsonBinding<T, std::enable_if_t<detail::HasFields<T>::value>> {
+        static bool read(JsonReader& reader, T& value) {
+            if (!reader.beginMap()) return false;
+
+            const auto fields = jsonminiFields(static_cast<const T*>(nullptr));
+            bool first = true;
+            std::string_view key;
+
+            while (reader.nextMember(first)) {
+                if (!reader.readKey(key)) return false;
+
+                bool found = std::apply([&](const auto&... field) {
+                    return (readField(reader, key, value, field) || ...);
+                }, fields);
+
+                if (reader.failed()) return false;
+                if (!found && !reader.skipValue()) return false;
+            }
+
+            return !reader.failed();
+        }
+
+        static void write(JsonWriter& writer, const T& value) {
+            const auto fields = jsonminiFields(static_cast<const T*>(nullptr));
+            bool first = true;
+
+            writer.put('{');
+
+            std::apply([&](const auto&... field) {
+                (writeField(writer, value, field, first), ...);
+            }, fields);
+
+            writer.put('}');
+        }
+
+    private:
+        template<class M>
+        static bool readField(JsonReader& reader, std::string_view key, T& value, const JsonField<T, M>& field) {
+            if (key != field.name) return false;
+
+            JsonBinding<M>::read(reader, value.*field.member);
+            return true;
+        }
+
+        template<class M>
+        static void writeField(JsonWriter& writer, const T& value, const JsonField<T, M>& field, bool& first) {
+            if (!first) writer.put(',');
+            first = false;
+
+            writer.writeString(field.name.data(), field.name.size());
+            writer.put(':');
+            JsonBinding<M>::write(writer, value.*field.member);
+        }
+    };
+
+    // decodes JSON text straight into a bound type without throwing
+    template<class T>
+    JsonResult tryDecode(const char* data, size_t size, T& value) {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+        JsonReader reader(data, size);
+
+        if (JsonBinding<T>::read(reader, value) && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+        return reader.result();
+    }
+
+    // throws JsonObjectException on malformed input
+    template<class T>
+    void decode(const char* data, size_t size, T& value) {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+        JsonReader reader(data, size);
+
+        if (JsonBinding<T>::read(reader, value) && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+        reader.check();
+    }
+
+    template<class T>
+    void decode(const std::string& str, T& value) {
+        decode(str.data(), str.size(), value);
+    }
+
+    template<class T>
+    void encode(const T& value, std::string& out) {
+        JSONMINI_STAT_PHASE(JSON_PHASE_SERIALIZE);
+        JsonWriter writer(out);
+        JsonBinding<T>::write(writer, value);
+    }
+
+    template<class T>
+    std::string encode(const T& value) {
+        std::string out;
+        encode(value, out);
+        return out;
+    }
+
+    template<class T>
+    void encode(const T& value, std::ostream& stream) {
+        std::string out;
+        encode(value, out);
+        stream.write(out.data(), out.size());
+    }
+}
+
+#endif
@@ -0,0 +1,398 @@
+#include "jsoncbor.hpp"
+
+#include "jsonobject.hpp"
+#include "jsonescape.hpp"
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace jsonmini {
+    enum CborMajor : uint8_t {
+        CBOR_UNSIGNED = 0,
+        CBOR_NEGATIVE = 1,
+        CBOR_BYTES = 2,
+        CBOR_TEXT = 3,
+        CBOR_ARRAY = 4,
+        CBOR_MAP = 5,
+        CBOR_TAG = 6,
+        CBOR_SIMPLE = 7
+    };
+
+    static const uint8_t CBOR_FALSE = 0xf4;
+    static const uint8_t CBOR_TRUE = 0xf5;
+    static const uint8_t CBOR_NULL = 0xf6;
+    static const uint8_t CBOR_FLOAT32 = 0xfa;
+    static const uint8_t CBOR_FLOAT64 = 0xfb;
+
+    static void writeBigEndian(std::string& out, uint64_t value, int bytes) {
+        char buff[8];
+
+        for (int i = 0; i < bytes; i++) {
+            buff[i] = (char)(value >> (8 * (bytes - 1 - i)));
+        }
+
+        out.append(buff, bytes);
+    }
+
+    static uint64_t readBigEndian(const uint8_t* data, int bytes) {
+        uint64_t value = 0;
+
+        for (int i = 0; i < bytes; i++) {
+            value = (value << 8) | data[i];
+        }
+
+        return value;
+    }
+
+    static double halfToDouble(uint16_t half) {
+        int exp = (half >> 10) & 0x1f;
+        int mant = half & 0x3ff;
+        double value;
+
+        if (exp == 0) value = std::ldexp(mant, -24);
+        else if (exp != 31) value = std::ldexp(mant + 1024, exp - 25);
+        else value = (mant == 0 ? INFINITY : NAN);
+
+        return (half & 0x8000) ? -value : value;
+    }
+
+    void JsonCbor::encode(const JsonObject& obj, std::string& out) {
+        encodeNode(obj, out);
+    }
+
+    std::string JsonCbor::encode(const JsonObject& obj) {
+        std::string out;
+        encodeNode(obj, out);
+        return out;
+    }
+
+    JsonResult JsonCbor::decode(const char* data, size_t size, JsonObject& out) noexcept {
+        Input in;
+        in.begin = in.cur = (const uint8_t*)data;
+        in.end = in.begin + size;
+
+        out.reset();
+
+        if (decodeNode(in, out, 0) && in.cur != in.end) {
+            fail(in, JSON_ERROR_UNEXPECTED_CHARACTER, in.cur);
+        }
+
+        if (in.error != JSON_OK) out.reset();
+
+        return JsonResult { in.error, in.errorPos };
+    }
+
+    JsonResult JsonCbor::decode(const std::string& data, JsonObject& out) noexcept {
+        return decode(data.data(), data.size(), out);
+    }
+
+    void JsonCbor::writeHead(std::string& out, uint8_t major, uint64_t arg) {
+        uint8_t type = major << 5;
+
+        if (arg < 24) {
+            out.push_back((char)(type | arg));
+        }
+        else if (arg <= 0xff) {
+            out.push_back((char)(type | 24));
+            writeBigEndian(out, arg, 1);
+        }
+        else if (arg <= 0xffff) {
+            out.push_back((char)(type | 25));
+            writeBigEndian(out, arg, 2);
+        }
+        else if (arg <= 0xffffffff) {
+            out.push_back((char)(type | 26));
+            writeBigEndian(out, arg, 4);
+        }
+        else {
+            out.push_back((char)(type | 27));
+            writeBigEndian(out, arg, 8);
+        }
+    }
+
+    // containers being written are kept on an explicit stack, nesting costs no call stack
+    void JsonCbor::encodeNode(const JsonObject& obj, std::string& out) {
+        struct Frame {
+            const JsonObject* container;
+            std::map<std::string, JsonObject>::const_iterator member;
+            size_t index;
+        };
+
+        std::vector<Frame> stack;
+        const JsonObject* value = &obj;
+
+        while (true) {
+            switch (value->_type) {
+                case JSON_NULL:
+                    out.push_back((char)CBOR_NULL);
+                break;
+                case JSON_BOOLEAN:
+                    out.push_back((char)(value->_bool ? CBOR_TRUE : CBOR_FALSE));
+                break;
+                case JSON_NUMBER:
+                    if (value->_realNum) encodeReal(value->_num, out);
+                    else encodeInteger(value->_long, out);
+                break;
+                case JSON_STRING:
+                    writeHead(out, CBOR_TEXT, value->_str.size());
+                    out.append(value->_str);
+                break;
+                case JSON_ARRAY:
+                    writeHead(out, CBOR_ARRAY, value->size());
+
+                    // packed items are written straight from their buffer
+                    for (long item : value->_packed.get().integers) {
+                        encodeInteger(item, out);
+                    }
+
+                    for (double item : value->_packed.get().reals) {
+                        encodeReal(item, out);
+                    }
+
+                    stack.push_back(Frame{ value, {}, 0 });
+                break;
+                case JSON_MAP:
+                    writeHead(out, CBOR_MAP, value->_map.get().size());
+                    stack.push_back(Frame{ value, value->_map.get().begin(), 0 });
+                break;
+            }
+
+            // drops finished containers until one has another element
+            value = nullptr;
+
+            while (!stack.empty()) {
+                Frame& frame = stack.back();
+
+                if (frame.container->_type == JSON_MAP) {
+                    if (frame.member != frame.container->_map.get().end()) {
+                        writeHead(out, CBOR_TEXT, frame.member->first.size());
+                        out.append(frame.member->first);
+                        value = &frame.member->second;
+                        ++frame.member;
+                        break;
+                    }
+                }
+                else {
+                    const auto& arr = frame.container->_arr.get();
+
+                    if (frame.index < arr.size()) {
+                        value = &arr[frame.index++];
+                        break;
+                    }
+                }
+
+                stack.pop_back();
+            }
+
+            if (!value) return;
+        }
+    }
+
+    void JsonCbor::encodeInteger(long value, std::string& out) {
+        if (value >= 0) writeHead(out, CBOR_UNSIGNED, (uint64_t)value);
+        else writeHead(out, CBOR_NEGATIVE, (uint64_t)(-1 - value));
+    }
+
+    // reals stay floating point even when integral, single precision if lossless
+    void JsonCbor::encodeReal(double value, std::string& out) {
+        float single = (float)value;
+
+        if ((double)single == value) {
+            uint32_t bits;
+            std::memcpy(&bits, &single, 4);
+            out.push_back((char)CBOR_FLOAT32);
+            writeBigEndian(out, bits, 4);
+        }
+        else {
+            uint64_t bits;
+            std::memcpy(&bits, &value, 8);
+            out.push_back((char)CBOR_FLOAT64);
+            writeBigEndian(out, bits, 8);
+        }
+    }
+
+    bool JsonCbor::fail(Input& in, JsonError error, const uint8_t* at) {
+        if (in.error == JSON_OK) {
+            in.error = error;
+            in.errorPos = at - in.begin;
+        }
+
+        return false;
+    }
+
+    bool JsonCbor::readHead(Input& in, uint8_t& major, uint8_t& info, uint64_t& arg) {
+        if (in.cur == in.end) return fail(in, JSON_ERROR_UNEXPECTED_END, in.cur);
+
+        const uint8_t* head = in.cur++;
+
+        major = *head >> 5;
+        info = *head & 0x1f;
+
+        if (info < 24) {
+            arg = info;
+            return true;
+        }
+
+        if (info > 27) return fail(in, JSON_ERROR_UNSUPPORTED_ITEM, head);
+
+        int bytes = 1 << (info - 24);
+
+        if (in.end - in.cur < bytes) return fail(in, JSON_ERROR_UNEXPECTED_END, in.end);
+
+        arg = readBigEndian(in.cur, bytes);
+        in.cur += bytes;
+
+        return true;
+    }
+
+    bool JsonCbor::readText(Input& in, uint64_t size, std::string& out) {
+        if ((uint64_t)(in.end - in.cur) < size) return fail(in, JSON_ERROR_UNEXPECTED_END, in.end);
+
+        const uint8_t* end = in.cur + size;
+
+        // the same check JsonReader makes on string bytes, text must be UTF-8
+        for (const uint8_t* at = in.cur; at < end; ) {
+            if (*at < 0x80) {
+                at++;
+                continue;
+            }
+
+            size_t seqSize = utf8SeqSize(*at);
+
+            if (seqSize == 0 || (size_t)(end - at) < seqSize) return fail(in, JSON_ERROR_INVALID_UTF8, at);
+
+            for (size_t i = 1; i < seqSize; i++) {
+                if ((at[i] & 0xc0) != 0x80) return fail(in, JSON_ERROR_INVALID_UTF8, at + i);
+            }
+
+            at += seqSize;
+        }
+
+        out.assign((const char*)in.cur, size);
+        in.cur = end;
+
+        return true;
+    }
+
+    bool JsonCbor::decodeNode(Input& in, JsonObject& obj, size_t depth) {
+        const uint8_t* begin = in.cur;
+        uint8_t major, info;
+        uint64_t arg;
+
+        if (!readHead(in, major, info, arg)) return false;
+
+        // tags carry no meaning for the tree, the tagged item is used as is; skipped in a loop,
+        // a run of tags costs no stack
+        while (major == CBOR_TAG) {
+            begin = in.cur;
+            if (!readHead(in, major, info, arg)) return false;
+        }
+
+        switch (major) {
+            case CBOR_UNSIGNED:
+            case CBOR_NEGATIVE:
+            {
+                obj._type = JSON_NUMBER;
+
+                if (arg > (uint64_t)LONG_MAX) {
+                    obj._realNum = true;
+                    obj._num = (major == CBOR_UNSIGNED ? (double)arg : -1.0 - (double)arg);
+                }
+                else {
+                    obj._long = (major == CBOR_UNSIGNED ? (long)arg : -1 - (long)arg);
+                    obj._num = obj._long;
+                }
+
+                return true;
+            }
+            case CBOR_TEXT:
+                obj._type = JSON_STRING;
+                return readText(in, arg, obj._str);
+            case CBOR_ARRAY:
+            case CBOR_MAP:
+            {
+                if (depth == MAX_DEPTH) return fail(in, JSON_ERROR_DEPTH_EXCEEDED, begin);
+
+                // every item takes at least one byte, bounds the reservation
+                if (arg > (uint64_t)(in.end - in.cur)) return fail(in, JSON_ERROR_UNEXPECTED_END, in.end);
+
+                if (major == CBOR_ARRAY) {
+                    obj._type = JSON_ARRAY;
+                    auto& arr = obj._arr.mut();
+                    arr.resize(arg);
+
+                    for (auto& item : arr) {
+                        if (!decodeNode(in, item, depth + 1)) return false;
+                    }
+
+                    return true;
+                }
+
+                obj._type = JSON_MAP;
+
+                auto& map = obj._map.mut();
+                uint64_t count = arg;
+                std::string key;
+
+                for (uint64_t i = 0; i < count; i++) {
+                    const uint8_t* keyBegin = in.cur;
+                    uint64_t keySize;
+
+                    if (!readHead(in, major, info, keySize)) return false;
+                    if (major != CBOR_TEXT) return fail(in, JSON_ERROR_KEY_EXPECTED, keyBegin);
+                    if (!readText(in, keySize, key)) return false;
+
+                    JsonObject& value = map[key];
+                    value.reset();
+
+                    if (!decodeNode(in, value, depth + 1)) return false;
+                }
+
+                return true;
+            }
+            case CBOR_SIMPLE:
+            {
+                switch (info) {
+                    case 20:
+                    case 21:
+                        obj._type = JSON_BOOLEAN;
+                        obj._bool = (info == 21);
+                        return true;
+                    case 22:
+                    case 23:
+                        obj._type = JSON_NULL;
+                        return true;
+                    case 25:
+                    case 26:
+                    case 27:
+                    {
+                        obj._type = JSON_NUMBER;
+                        obj._realNum = true;
+
+                        if (info == 25) {
+                            obj._num = halfToDouble((uint16_t)arg);
+                        }
+                        else if (info == 26) {
+                            float single;
+                            uint32_t bits = (uint32_t)arg;
+                            std::memcpy(&single, &bits, 4);
+                            obj._num = single;
+                        }
+                        else {
+                            std::memcpy(&obj._num, &arg, 8);
+                        }
+
+                        // JSON has no NaN or Infinity, such a value could not be written back as text
+                        if (!std::isfinite(obj._num)) return fail(in, JSON_ERROR_NUMBER_OUT_OF_RANGE, begin);
+
+                        return true;
+                    }
+                    default:
+                        return fail(in, JSON_ERROR_UNSUPPORTED_ITEM, begin);
+                }
+            }
+            default:
+                return fail(in, JSON_ERROR_UNSUPPORTED_ITEM, begin);
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef JSONCBOR_HPP
+#define JSONCBOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "jsonerror.hpp"
+
+namespace jsonmini {
+    class JsonObject;
+
+    // CBOR (RFC 8949) encoding of JsonObject trees, integers and doubles are kept exactly
+    class JsonCbor {
+    public:
+        static void encode(const JsonObject& obj, std::string& out);
+        static std::string encode(const JsonObject& obj);
+
+        static JsonResult decode(const char* data, size_t size, JsonObject& out) noexcept;
+        static JsonResult decode(const std::string& data, JsonObject& out) noexcept;
+
+        static const size_t MAX_DEPTH = 4096;
+
+    private:
+        struct Input {
+            const uint8_t* begin;
+            const uint8_t* cur;
+            const uint8_t* end;
+            JsonError error = JSON_OK;
+            size_t errorPos = 0;
+        };
+
+        static void writeHead(std::string& out, uint8_t major, uint64_t arg);
+        static void encodeNode(const JsonObject& obj, std::string& out);
+        static void encodeInteger(long value, std::string& out);
+        static void encodeReal(double value, std::string& out);
+
+        static bool fail(Input& in, JsonError error, const uint8_t* at);
+        static bool readHead(Input& in, uint8_t& major, uint8_t& info, uint64_t& arg);
+        static bool readText(Input& in, uint64_t size, std::string& out);
+        static bool decodeNode(Input& in, JsonObject& obj, size_t depth);
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "jsonerror.hpp"
+
+namespace jsonmini {
+    const char* errorMessage(JsonError error) noexcept {
+        switch (error) {
+            case JSON_OK: return "no error";
+            case JSON_ERROR_UNEXPECTED_CHARACTER: return "unexpected character";
+            case JSON_ERROR_CHARACTER_NOT_ALLOWED: return "character is not allowed here";
+            case JSON_ERROR_VALUE_EXPECTED: return "value expected";
+            case JSON_ERROR_UNKNOWN_IDENTIFIER: return "unknown identifier starting";
+            case JSON_ERROR_NUMBER_EXPECTED: return "number expected";
+            case JSON_ERROR_LEADING_ZERO: return "leading zero is not allowed";
+            case JSON_ERROR_NUMBER_OUT_OF_RANGE: return "number out of range";
+            case JSON_ERROR_UNCLOSED_STRING: return "unclosed string";
+            case JSON_ERROR_CONTROL_CHARACTER: return "control character";
+            case JSON_ERROR_ILLEGAL_ESCAPE: return "illegal escape sequence";
+            case JSON_ERROR_INVALID_UNICODE_ESCAPE: return "invalid unicode character escape sequence";
+            case JSON_ERROR_INVALID_UTF8: return "invalid utf-8 byte (data corruption)";
+            case JSON_ERROR_KEY_EXPECTED: return "string value expected";
+            case JSON_ERROR_KEY_SEPARATOR_EXPECTED: return "key separator expected";
+            case JSON_ERROR_COMMA_EXPECTED: return "comma or closing bracket expected";
+            case JSON_ERROR_REDUNDANT_COMMA: return "redundant comma";
+            case JSON_ERROR_CLOSING_BRACKET_EXPECTED: return "closing bracket expected";
+            case JSON_ERROR_STRING_EXPECTED: return "string expected";
+            case JSON_ERROR_INTEGER_EXPECTED: return "integer expected";
+            case JSON_ERROR_BOOLEAN_EXPECTED: return "boolean expected";
+            case JSON_ERROR_NULL_EXPECTED: return "null expected";
+            case JSON_ERROR_MAP_EXPECTED: return "map expected";
+            case JSON_ERROR_ARRAY_EXPECTED: return "array expected";
+            case JSON_ERROR_DEPTH_EXCEEDED: return "maximum nesting depth exceeded";
+            case JSON_ERROR_UNEXPECTED_END: return "unexpected end of data";
+            case JSON_ERROR_UNSUPPORTED_ITEM: return "unsupported binary item";
+            case JSON_ERROR_INVALID_PATCH: return "invalid patch operation";
+            case JSON_ERROR_PATH_NOT_FOUND: return "path not found";
+            case JSON_ERROR_TEST_FAILED: return "test operation failed";
+            case JSON_ERROR_INPUT_TOO_LARGE: return "input size limit exceeded";
+            case JSON_ERROR_STRING_TOO_LONG: return "string length limit exceeded";
+            case JSON_ERROR_TOO_MANY_NODES: return "value count limit exceeded";
+            case JSON_ERROR_TOO_MANY_KEYS: return "map key count limit exceeded";
+            case JSON_ERROR_INVALID_SCHEMA: return "invalid or unsupported schema";
+            case JSON_ERROR_TYPE_MISMATCH: return "value of a type the schema does not allow";
+            case JSON_ERROR_REQUIRED_KEY_MISSING: return "required key missing";
+            case JSON_ERROR_KEY_NOT_ALLOWED: return "key not allowed by the schema";
+            case JSON_ERROR_VALUE_NOT_ALLOWED: return "value not allowed by the schema";
+            case JSON_ERROR_OUT_OF_BOUNDS: return "value outside the bounds of the schema";
+            case JSON_ERROR_INVALID_QUERY: return "invalid or unsupported query expression";
+            case JSON_ERROR_IO: return "file could not be opened or read";
+        }
+
+        return "unknown error";
+    }
+}
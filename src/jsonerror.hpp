@@ -0,0 +1,65 @@
+#ifndef JSONERROR_HPP
+#define JSONERROR_HPP
+
+#include <cstddef>
+
+namespace jsonmini {
+    enum JsonError {
+        JSON_OK,
+        JSON_ERROR_UNEXPECTED_CHARACTER,
+        JSON_ERROR_CHARACTER_NOT_ALLOWED,
+        JSON_ERROR_VALUE_EXPECTED,
+        JSON_ERROR_UNKNOWN_IDENTIFIER,
+        JSON_ERROR_NUMBER_EXPECTED,
+        JSON_ERROR_LEADING_ZERO,
+        JSON_ERROR_NUMBER_OUT_OF_RANGE,
+        JSON_ERROR_UNCLOSED_STRING,
+        JSON_ERROR_CONTROL_CHARACTER,
+        JSON_ERROR_ILLEGAL_ESCAPE,
+        JSON_ERROR_INVALID_UNICODE_ESCAPE,
+        JSON_ERROR_INVALID_UTF8,
+        JSON_ERROR_KEY_EXPECTED,
+        JSON_ERROR_KEY_SEPARATOR_EXPECTED,
+        JSON_ERROR_COMMA_EXPECTED,
+        JSON_ERROR_REDUNDANT_COMMA,
+        JSON_ERROR_CLOSING_BRACKET_EXPECTED,
+        JSON_ERROR_STRING_EXPECTED,
+        JSON_ERROR_INTEGER_EXPECTED,
+        JSON_ERROR_BOOLEAN_EXPECTED,
+        JSON_ERROR_NULL_EXPECTED,
+        JSON_ERROR_MAP_EXPECTED,
+        JSON_ERROR_ARRAY_EXPECTED,
+        JSON_ERROR_DEPTH_EXCEEDED,
+        JSON_ERROR_UNEXPECTED_END,
+        JSON_ERROR_UNSUPPORTED_ITEM,
+        JSON_ERROR_INVALID_PATCH,
+        JSON_ERROR_PATH_NOT_FOUND,
+        JSON_ERROR_TEST_FAILED,
+        JSON_ERROR_INPUT_TOO_LARGE,
+        JSON_ERROR_STRING_TOO_LONG,
+        JSON_ERROR_TOO_MANY_NODES,
+        JSON_ERROR_TOO_MANY_KEYS,
+        JSON_ERROR_INVALID_SCHEMA,
+        JSON_ERROR_TYPE_MISMATCH,
+        JSON_ERROR_REQUIRED_KEY_MISSING,
+        JSON_ERROR_KEY_NOT_ALLOWED,
+        JSON_ERROR_VALUE_NOT_ALLOWED,
+        JSON_ERROR_OUT_OF_BOUNDS,
+        JSON_ERROR_INVALID_QUERY,
+        JSON_ERROR_IO
+    };
+
+    const char* errorMessage(JsonError error) noexcept;
+
+    // outcome of a non-throwing operation, pos is the byte offset of the failure
+    struct JsonResult {
+        JsonError error = JSON_OK;
+        size_t pos = 0;
+
+        bool ok() const noexcept { return error == JSON_OK; }
+        explicit operator bool() const noexcept { return ok(); }
+        const char* message() const noexcept { return errorMessage(error); }
+    };
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef JSONESCAPE_HPP
+#define JSONESCAPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// escape decoding shared by the buffer reader, the stream parser and compile-time literals
+namespace jsonmini {
+    // byte a single-letter escape stands for, 0 if the letter cannot follow a backslash ('u' is decoded apart)
+    struct JsonUnescapeTable {
+        char bytes[256];
+
+        constexpr JsonUnescapeTable() : bytes() {
+            bytes[(unsigned char)'"'] = '"';
+            bytes[(unsigned char)'\\'] = '\\';
+            bytes[(unsigned char)'/'] = '/';
+            bytes[(unsigned char)'b'] = '\b';
+            bytes[(unsigned char)'f'] = '\f';
+            bytes[(unsigned char)'n'] = '\n';
+            bytes[(unsigned char)'r'] = '\r';
+            bytes[(unsigned char)'t'] = '\t';
+        }
+
+        constexpr char operator [](char letter) const {
+            return bytes[(unsigned char)letter];
+        }
+    };
+
+    inline constexpr JsonUnescapeTable JSON_UNESCAPE;
+
+    // value of a hex digit, -1 for any other byte
+    inline constexpr int hexDigit(char byte) {
+        unsigned int digit = (unsigned char)byte - '0';
+        if (digit < 10) return digit;
+
+        digit = ((unsigned char)byte | 0x20) - 'a';
+        return digit < 6 ? digit + 10 : -1;
+    }
+
+    // \ud800-\udbff has to be followed by \udc00-\udfff, either one alone is not a character
+    inline constexpr bool isHighSurrogate(uint32_t unit) {
+        return unit >= 0xd800 && unit <= 0xdbff;
+    }
+
+    inline constexpr bool isLowSurrogate(uint32_t unit) {
+        return unit >= 0xdc00 && unit <= 0xdfff;
+    }
+
+    inline constexpr uint32_t combineSurrogates(uint32_t high, uint32_t low) {
+        return 0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00);
+    }
+
+    // length of the UTF-8 sequence a lead byte starts, 0 for bytes that cannot start one
+    inline constexpr size_t utf8SeqSize(unsigned char byte) {
+        if (byte >= 0xc2 && byte <= 0xdf) return 2;
+        if (byte >= 0xe0 && byte <= 0xef) return 3;
+        if (byte >= 0xf0 && byte <= 0xf4) return 4;
+        return 0;
+    }
+
+    // code points up to U+10FFFF, returns the number of bytes written
+    inline constexpr size_t encodeUtf8(uint32_t code, char* out) {
+        if (code <= 0x7f) {
+            out[0] = code;
+            return 1;
+        }
+
+        if (code <= 0x7ff) {
+            out[0] = 0xc0 | (code >> 6);
+            out[1] = 0x80 | (code & 0x3f);
+            return 2;
+        }
+
+        if (code <= 0xffff) {
+            out[0] = 0xe0 | (code >> 12);
+            out[1] = 0x80 | ((code >> 6) & 0x3f);
+            out[2] = 0x80 | (code & 0x3f);
+            return 3;
+        }
+
+        out[0] = 0xf0 | (code >> 18);
+        out[1] = 0x80 | ((code >> 12) & 0x3f);
+        out[2] = 0x80 | ((code >> 6) & 0x3f);
+        out[3] = 0x80 | (code & 0x3f);
+        return 4;
+    }
+}
+
+#endif
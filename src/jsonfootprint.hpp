@@ -0,0 +1,22 @@
+#ifndef JSONFOOTPRINT_HPP
+#define JSONFOOTPRINT_HPP
+
+#include <cstddef>
+
+namespace jsonmini {
+    // memory held by a JsonObject tree, container and allocator figures are estimates
+    struct JsonFootprint {
+        size_t nodes = 0;          // JsonObject values including the root
+        size_t allocations = 0;    // heap blocks owned by the tree
+        size_t nodeBytes = 0;      // sizeof(JsonObject) for every node
+        size_t stringBytes = 0;    // heap buffers of string values and map keys
+        size_t containerBytes = 0; // shared container blocks, map entry headers, key objects and unused vector capacity
+        size_t overheadBytes = 0;  // allocator bookkeeping per heap block
+        size_t slackBytes = 0;     // unused string and vector capacity, reclaimed by shrinkToFit
+        size_t cacheBytes = 0;     // serialized output kept for setSerializationCacheEnabled
+
+        size_t total() const { return nodeBytes + stringBytes + containerBytes + overheadBytes + cacheBytes; }
+    };
+}
+
+#endif
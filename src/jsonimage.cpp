@@ -0,0 +1,470 @@
+#include "jsonimage.hpp"
+
+#include "jsonobject.hpp"
+#include "jsonreader.hpp"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JSONMINI_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jsonmini {
+    // layout: header, then slot blocks and NUL-terminated strings, all 8-byte aligned
+    struct ImageHeader {
+        char magic[8];
+        uint64_t size;
+        JsonImageSlot root;
+    };
+
+    static const char _MAGIC[8] = { 'J', 'S', 'N', 'I', 'M', 'G', '1', '\0' };
+
+    static int compareKeys(std::string_view a, std::string_view b) {
+        size_t size = (a.size() < b.size() ? a.size() : b.size());
+        int cmp = std::memcmp(a.data(), b.data(), size);
+
+        if (cmp != 0) return cmp;
+        if (a.size() == b.size()) return 0;
+
+        return a.size() < b.size() ? -1 : 1;
+    }
+
+    JsonView::JsonView(const char* base, const JsonImageSlot* slot) : _base(base), _slot(slot) { }
+
+    bool JsonView::valid() const {
+        return _slot != nullptr;
+    }
+
+    JsonType JsonView::type() const {
+        return _slot ? (JsonType)_slot->type : JSON_NULL;
+    }
+
+    size_t JsonView::size() const {
+        switch (type()) {
+            case JSON_ARRAY:
+            case JSON_MAP:
+            case JSON_STRING:
+                return _slot->size;
+            default:
+                return 0;
+        }
+    }
+
+    bool JsonView::isArray() const {
+        return type() == JSON_ARRAY;
+    }
+
+    bool JsonView::isMap() const {
+        return type() == JSON_MAP;
+    }
+
+    bool JsonView::isString() const {
+        return type() == JSON_STRING;
+    }
+
+    bool JsonView::isNumber() const {
+        return type() == JSON_NUMBER;
+    }
+
+    bool JsonView::isBoolean() const {
+        return type() == JSON_BOOLEAN;
+    }
+
+    bool JsonView::isNull() const {
+        return type() == JSON_NULL;
+    }
+
+    std::string_view JsonView::str() const {
+        if (!isString()) return std::string_view();
+        return std::string_view(_base + _slot->payload, _slot->size);
+    }
+
+    const char* JsonView::c_str() const {
+        return isString() ? _base + _slot->payload : "";
+    }
+
+    bool JsonView::boolean() const {
+        return isBoolean() && _slot->payload != 0;
+    }
+
+    double JsonView::number() const {
+        if (!isNumber()) return 0;
+        if (_slot->size == 0) return (double)(int64_t)_slot->payload;
+
+        double value;
+        std::memcpy(&value, &_slot->payload, sizeof(double));
+        return value;
+    }
+
+    long JsonView::numberLong() const {
+        if (!isNumber()) return 0;
+        if (_slot->size == 0) return (long)(int64_t)_slot->payload;
+
+        return (long)number();
+    }
+
+    JsonView JsonView::operator [](size_t index) const {
+        if (!isArray() || index >= _slot->size) return JsonView();
+        return JsonView(_base, children() + index);
+    }
+
+    JsonView JsonView::operator [](std::string_view key) const {
+        if (!isMap()) return JsonView();
+
+        const JsonImageSlot* keys = children();
+        size_t low = 0, high = _slot->size;
+
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            int cmp = compareKeys(std::string_view(_base + keys[mid].payload, keys[mid].size), key);
+
+            if (cmp == 0) return JsonView(_base, keys + _slot->size + mid);
+            if (cmp < 0) low = mid + 1;
+            else high = mid;
+        }
+
+        return JsonView();
+    }
+
+    bool JsonView::hasKey(std::string_view key) const {
+        return (*this)[key].valid();
+    }
+
+    std::string_view JsonView::key(size_t index) const {
+        if (!isMap() || index >= _slot->size) return std::string_view();
+
+        const JsonImageSlot* keySlot = children() + index;
+        return std::string_view(_base + keySlot->payload, keySlot->size);
+    }
+
+    JsonView JsonView::value(size_t index) const {
+        if (!isMap() || index >= _slot->size) return JsonView();
+        return JsonView(_base, children() + _slot->size + index);
+    }
+
+    JsonObject JsonView::toObject() const {
+        switch (type()) {
+            case JSON_ARRAY:
+            {
+                JsonObject obj = JsonObject::makeArray();
+                auto arr = obj.vector();
+                arr->reserve(_slot->size);
+
+                for (size_t i = 0; i < _slot->size; i++) {
+                    arr->push_back((*this)[i].toObject());
+                }
+
+                return obj;
+            }
+            case JSON_MAP:
+            {
+                JsonObject obj = JsonObject::makeMap();
+                auto map = obj.map();
+
+                for (size_t i = 0; i < _slot->size; i++) {
+                    map->emplace_hint(map->end(), std::string(key(i)), value(i).toObject());
+                }
+
+                return obj;
+            }
+            case JSON_STRING:
+                return JsonObject(std::string(str()));
+            case JSON_NUMBER:
+                if (_slot->size == 0) return JsonObject(numberLong());
+                return JsonObject(number());
+            case JSON_BOOLEAN:
+                return JsonObject(boolean());
+            default:
+                return JsonObject();
+        }
+    }
+
+    const JsonImageSlot* JsonView::children() const {
+        return (const JsonImageSlot*)(_base + _slot->payload);
+    }
+
+    JsonImage::~JsonImage() {
+        close();
+    }
+
+    bool JsonImage::write(const JsonObject& obj, std::string& out) {
+        out.clear();
+
+        ImageHeader header;
+        std::memcpy(header.magic, _MAGIC, sizeof(_MAGIC));
+        header.size = 0;
+        header.root = JsonImageSlot { JSON_NULL, 0, 0 };
+
+        out.append((const char*)&header, sizeof(header));
+
+        if (!writeValue(out, offsetof(ImageHeader, root), obj)) {
+            out.clear();
+            return false;
+        }
+
+        uint64_t size = out.size();
+        std::memcpy(&out[offsetof(ImageHeader, size)], &size, sizeof(size));
+
+        return true;
+    }
+
+    bool JsonImage::write(const JsonObject& obj, const char* path) {
+        std::string out;
+        if (!write(obj, out)) return false;
+
+        std::ofstream ofs(path, std::ios_base::binary | std::ios_base::trunc);
+        if (!ofs.is_open()) return false;
+
+        ofs.write(out.data(), out.size());
+        return ofs.good();
+    }
+
+    JsonResult JsonImage::open(const char* path) noexcept {
+        close();
+
+#ifdef JSONMINI_MMAP
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return JsonResult { JSON_ERROR_IO, 0 };
+
+        struct stat st;
+        bool stated = (fstat(fd, &st) == 0);
+
+        // an empty file is read, it is only too short to be an image
+        if (!stated || st.st_size == 0) {
+            ::close(fd);
+            return JsonResult { stated ? JSON_ERROR_UNEXPECTED_END : JSON_ERROR_IO, 0 };
+        }
+
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (mapping == MAP_FAILED) return JsonResult { JSON_ERROR_IO, 0 };
+
+        JsonResult result = open((const char*)mapping, st.st_size);
+
+        if (result) {
+            _mapping = mapping;
+            _mappingSize = st.st_size;
+        }
+        else munmap(mapping, st.st_size);
+
+        return result;
+#else
+        std::ifstream ifs(path, std::ios_base::binary);
+        if (!ifs.is_open()) return JsonResult { JSON_ERROR_IO, 0 };
+
+        std::string buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+        if (ifs.bad()) return JsonResult { JSON_ERROR_IO, 0 };
+        if (buffer.empty()) return JsonResult { JSON_ERROR_UNEXPECTED_END, 0 };
+
+        _buffer = std::move(buffer);
+
+        JsonResult result = open(_buffer.data(), _buffer.size());
+        if (!result) _buffer.clear();
+
+        return result;
+#endif
+    }
+
+    JsonResult JsonImage::open(const char* data, size_t size) noexcept {
+        if (data != _buffer.data()) close();
+
+        if (size < sizeof(ImageHeader)) return JsonResult { JSON_ERROR_UNEXPECTED_END, size };
+
+        const ImageHeader* header = (const ImageHeader*)data;
+
+        if (std::memcmp(header->magic, _MAGIC, sizeof(_MAGIC)) != 0) {
+            return JsonResult { JSON_ERROR_UNSUPPORTED_ITEM, 0 };
+        }
+
+        if (header->size > size) return JsonResult { JSON_ERROR_UNEXPECTED_END, size };
+
+        _data = data;
+        _size = header->size;
+
+        return JsonResult();
+    }
+
+    void JsonImage::close() {
+#ifdef JSONMINI_MMAP
+        if (_mapping) munmap(_mapping, _mappingSize);
+#endif
+
+        _mapping = nullptr;
+        _mappingSize = 0;
+        _data = nullptr;
+        _size = 0;
+        _buffer.clear();
+    }
+
+    JsonResult JsonImage::verify() const noexcept {
+        if (!_data) return JsonResult { JSON_ERROR_UNEXPECTED_END, 0 };
+
+        const JsonImageSlot* root = &((const ImageHeader*)_data)->root;
+        size_t budget = _size / sizeof(JsonImageSlot);
+
+        if (!verifySlot(root, 0, budget)) return JsonResult { JSON_ERROR_UNSUPPORTED_ITEM, 0 };
+
+        return JsonResult();
+    }
+
+    JsonView JsonImage::root() const {
+        if (!_data) return JsonView();
+        return JsonView(_data, &((const ImageHeader*)_data)->root);
+    }
+
+    void JsonImage::writeSlot(std::string& out, size_t at, const JsonImageSlot& slot) {
+        std::memcpy(&out[at], &slot, sizeof(slot));
+    }
+
+    size_t JsonImage::reserve(std::string& out, size_t size) {
+        size_t at = out.size();
+        out.resize(at + ((size + 7) & ~(size_t)7));
+        return at;
+    }
+
+    size_t JsonImage::appendString(std::string& out, const std::string& str) {
+        size_t at = reserve(out, str.size() + 1);
+        std::memcpy(&out[at], str.data(), str.size());
+        return at;
+    }
+
+    JsonImageSlot JsonImage::numberSlot(double num, long integer, bool real) {
+        JsonImageSlot slot { JSON_NUMBER, 0, 0 };
+
+        if (real) {
+            slot.size = 1;
+            std::memcpy(&slot.payload, &num, sizeof(double));
+        }
+        else slot.payload = (uint64_t)(int64_t)integer;
+
+        return slot;
+    }
+
+    // false for a string, key or container too long for the 32-bit size of a slot
+    bool JsonImage::writeValue(std::string& out, size_t at, const JsonObject& obj) {
+        JsonImageSlot slot { (uint32_t)obj._type, 0, 0 };
+
+        switch (obj._type) {
+            case JSON_NUMBER:
+                slot = numberSlot(obj._num, obj._long, obj._realNum);
+            break;
+            case JSON_BOOLEAN:
+                slot.payload = obj._bool;
+            break;
+            case JSON_STRING:
+                if (obj._str.size() > UINT32_MAX) return false;
+
+                slot.size = obj._str.size();
+                slot.payload = appendString(out, obj._str);
+            break;
+            case JSON_ARRAY:
+            {
+                const auto& arr = obj._arr.get();
+                const auto& packed = obj._packed.get();
+
+                if (obj.size() > UINT32_MAX) return false;
+
+                size_t block = reserve(out, obj.size() * sizeof(JsonImageSlot));
+
+                slot.size = obj.size();
+                slot.payload = block;
+
+                // packed items get the slots their nodes would get
+                for (size_t i = 0; i < packed.integers.size(); i++) {
+                    writeSlot(out, block + i * sizeof(JsonImageSlot), numberSlot(packed.integers[i], packed.integers[i], false));
+                }
+
+                for (size_t i = 0; i < packed.reals.size(); i++) {
+                    writeSlot(out, block + i * sizeof(JsonImageSlot), numberSlot(packed.reals[i], 0, true));
+                }
+
+                for (size_t i = 0; i < arr.size(); i++) {
+                    if (!writeValue(out, block + i * sizeof(JsonImageSlot), arr[i])) return false;
+                }
+            }
+            break;
+            case JSON_MAP:
+            {
+                // key slots come first so lookups binary search a dense block
+                size_t count = obj._map.get().size();
+
+                if (count > UINT32_MAX) return false;
+
+                size_t block = reserve(out, 2 * count * sizeof(JsonImageSlot));
+                size_t i = 0;
+
+                slot.size = count;
+                slot.payload = block;
+
+                for (auto& pair : obj._map.get()) {
+                    if (pair.first.size() > UINT32_MAX) return false;
+
+                    JsonImageSlot keySlot { JSON_STRING, (uint32_t)pair.first.size(), appendString(out, pair.first) };
+
+                    writeSlot(out, block + i * sizeof(JsonImageSlot), keySlot);
+                    if (!writeValue(out, block + (count + i) * sizeof(JsonImageSlot), pair.second)) return false;
+                    i++;
+                }
+            }
+            break;
+            default:
+            break;
+        }
+
+        writeSlot(out, at, slot);
+
+        return true;
+    }
+
+    bool JsonImage::verifySlot(const JsonImageSlot* slot, size_t depth, size_t& budget) const {
+        if (budget == 0 || depth > JsonReader::SKIP_DEPTH) return false;
+        budget--;
+
+        switch (slot->type) {
+            case JSON_NULL:
+            case JSON_NUMBER:
+            case JSON_BOOLEAN:
+                return true;
+            case JSON_STRING:
+                return slot->payload < _size && _size - slot->payload > slot->size && _data[slot->payload + slot->size] == '\0';
+            case JSON_ARRAY:
+            case JSON_MAP:
+            {
+                size_t count = (slot->type == JSON_MAP ? 2 * (size_t)slot->size : slot->size);
+
+                if (slot->payload % 8 != 0 || slot->payload > _size) return false;
+                if ((_size - slot->payload) / sizeof(JsonImageSlot) < count) return false;
+
+                const JsonImageSlot* children = (const JsonImageSlot*)(_data + slot->payload);
+
+                for (size_t i = 0; i < count; i++) {
+                    if (slot->type == JSON_MAP && i < slot->size) {
+                        if (children[i].type != JSON_STRING) return false;
+                    }
+
+                    if (!verifySlot(children + i, depth + 1, budget)) return false;
+                }
+
+                if (slot->type == JSON_MAP) {
+                    JsonView map(_data, slot);
+
+                    for (size_t i = 1; i < slot->size; i++) {
+                        if (compareKeys(map.key(i - 1), map.key(i)) >= 0) return false;
+                    }
+                }
+
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef JSONIMAGE_HPP
+#define JSONIMAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "jsonerror.hpp"
+#include "jsontype.hpp"
+
+namespace jsonmini {
+    class JsonObject;
+
+    // fixed-size value record of an image: strings and containers point at their payload by offset
+    struct JsonImageSlot {
+        uint32_t type;    // JsonType
+        uint32_t size;    // string length, element count, 1 for real numbers
+        uint64_t payload; // offset, integer or double bits, boolean
+    };
+
+    // read-only accessor over a value of an opened image
+    class JsonView {
+    public:
+        JsonView() = default;
+
+        // false for views of missing elements
+        bool valid() const;
+
+        JsonType type() const;
+        size_t size() const;
+
+        bool isArray() const;
+        bool isMap() const;
+        bool isString() const;
+        bool isNumber() const;
+        bool isBoolean() const;
+        bool isNull() const;
+
+        std::string_view str() const;
+        const char* c_str() const;
+        bool boolean() const;
+        double number() const;
+        long numberLong() const;
+
+        // missing elements give an invalid null view, map lookup is a binary search
+        JsonView operator [](size_t index) const;
+        JsonView operator [](std::string_view key) const;
+        bool hasKey(std::string_view key) const;
+
+        // map entries in key order
+        std::string_view key(size_t index) const;
+        JsonView value(size_t index) const;
+
+        JsonObject toObject() const;
+
+    private:
+        friend class JsonImage;
+
+        const char* _base = nullptr;
+        const JsonImageSlot* _slot = nullptr;
+
+        JsonView(const char* base, const JsonImageSlot* slot);
+        const JsonImageSlot* children() const;
+    };
+
+    // persistent document compiled from a JsonObject, opened through mmap without parsing
+    class JsonImage {
+    public:
+        JsonImage() = default;
+        JsonImage(const JsonImage&) = delete;
+        JsonImage& operator =(const JsonImage&) = delete;
+        ~JsonImage();
+
+        // false, with out left empty, when a string, key or container holds more than UINT32_MAX bytes or elements
+        static bool write(const JsonObject& obj, std::string& out);
+        static bool write(const JsonObject& obj, const char* path);
+
+        // a file that cannot be opened, mapped or read is JSON_ERROR_IO, an empty one JSON_ERROR_UNEXPECTED_END
+        JsonResult open(const char* path) noexcept;
+        // the buffer must stay alive and 8-byte aligned while the image is in use
+        JsonResult open(const char* data, size_t size) noexcept;
+        void close();
+
+        // walks the whole image and checks every offset, for files that are not trusted
+        JsonResult verify() const noexcept;
+
+        JsonView root() const;
+
+    private:
+        const char* _data = nullptr;
+        size_t _size = 0;
+        void* _mapping = nullptr;
+        size_t _mappingSize = 0;
+        std::string _buffer;
+
+        static void writeSlot(std::string& out, size_t at, const JsonImageSlot& slot);
+        static size_t reserve(std::string& out, size_t size);
+        static size_t appendString(std::string& out, const std::string& str);
+        static JsonImageSlot numberSlot(double num, long integer, bool real);
+        static bool writeValue(std::string& out, size_t at, const JsonObject& obj);
+
+        bool verifySlot(const JsonImageSlot* slot, size_t depth, size_t& budget) const;
+    };
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef JSONLIMITS_HPP
+#define JSONLIMITS_HPP
+
+#include <cstddef>
+
+namespace jsonmini {
+    // bounds on untrusted input, checked while it is read; a violation is reported
+    // at the byte where the limit was crossed
+    struct JsonLimits {
+        static const size_t UNLIMITED = (size_t)-1;
+
+        size_t maxDepth = 4096;              // container nesting, a root container is 1
+        size_t maxBytes = UNLIMITED;         // size of the whole input
+        size_t maxStringLength = UNLIMITED;  // bytes between the quotes of a string or a key, escapes as written
+        size_t maxNodes = UNLIMITED;         // values of any type, containers included
+        size_t maxKeys = UNLIMITED;          // members of a single map, duplicates included
+
+        // not a bound: JsonObject::parse keeps arrays of numbers of one kind packed, see JsonObject::makeArray
+        bool packNumbers = false;
+    };
+}
+
+#endif
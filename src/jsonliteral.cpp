@@ -0,0 +1,43 @@
+#include "jsonliteral.hpp"
+
+#include <charconv>
+#include <ostream>
+#include "jsonobject.hpp"
+#include "jsonobjectexception.hpp"
+#include "jsonwriter.hpp"
+
+namespace jsonmini {
+    // only reached when a literal is built at run time, JSONMINI_JSON never does that
+    void JsonLiteralParser::fail(JsonError error, size_t pos) {
+        JSONMINI_THROW(JsonObjectException(errorMessage(error), pos));
+    }
+
+    double JsonLiteralView::convert() const {
+        std::string_view text = minified();
+        double value = 0;
+
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+    JsonObject JsonLiteralView::toObject() const {
+        JsonObject obj;
+
+        if (valid()) {
+            std::string_view text = minified();
+            JsonObject::parse(text.data(), text.size(), obj);
+        }
+
+        return obj;
+    }
+
+    void JsonLiteralView::write(JsonWriter& writer) const {
+        std::string_view text = minified();
+        writer.writeRaw(text.data(), text.size());
+    }
+
+    void JsonLiteralView::operator >>(std::ostream& stream) const {
+        std::string_view text = minified();
+        stream.write(text.data(), text.size());
+    }
+}
@@ -0,0 +1,580 @@
+#ifndef JSONLITERAL_HPP
+#define JSONLITERAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+#include "jsonerror.hpp"
+#include "jsonescape.hpp"
+#include "jsonobject.hpp"
+#include "jsontype.hpp"
+
+// a JSON document checked and laid out by the compiler:
+//
+//     static constexpr auto DEFAULTS = JSONMINI_JSON(R"({"port": 8080, "hosts": ["a", "b"]})");
+//
+// malformed text fails the build, reading it at run time costs no parse and no allocation
+#define JSONMINI_JSON(json) ([]() { \
+        constexpr ::jsonmini::JsonLiteralSizes sizes = ::jsonmini::JsonLiteralParser(json).parse(); \
+        constexpr ::jsonmini::JsonLiteral<sizes.nodes, sizes.text, sizes.strings> literal(json); \
+        return literal; \
+    }())
+
+namespace jsonmini {
+    class JsonWriter;
+
+    // one value of a literal, containers are followed by their elements
+    struct JsonLiteralNode {
+        JsonType type = JSON_NULL;
+        // elements of a container
+        size_t size = 0;
+        // index of the node following the value and its elements
+        size_t end = 0;
+        // decoded member key and string value in the string pool
+        size_t key = 0;
+        size_t keySize = 0;
+        size_t str = 0;
+        size_t strSize = 0;
+        // the value as it appears in the minified text
+        size_t text = 0;
+        size_t textSize = 0;
+        long integer = 0;
+        double number = 0;
+        bool real = false;
+        // false when number could not be computed exactly by the compiler, the text is converted instead
+        bool exact = true;
+        bool boolean = false;
+    };
+
+    struct JsonLiteralSizes {
+        size_t nodes = 0;
+        size_t text = 0;
+        size_t strings = 0;
+    };
+
+    // grammar of JsonReader; without storage it only checks the text and measures what it needs
+    class JsonLiteralParser {
+    public:
+        constexpr explicit JsonLiteralParser(std::string_view json, JsonLiteralNode* nodes = nullptr,
+            char* text = nullptr, char* strings = nullptr)
+            : _json(json), _nodes(nodes), _text(text), _strings(strings) { }
+
+        constexpr JsonLiteralSizes parse() {
+            skipSpace();
+            value(0, 0);
+            skipSpace();
+
+            if (_pos < _json.size()) fail(JSON_ERROR_UNEXPECTED_CHARACTER, _pos);
+
+            return _sizes;
+        }
+
+    private:
+        std::string_view _json;
+        size_t _pos = 0;
+        JsonLiteralNode* _nodes;
+        char* _text;
+        char* _strings;
+        JsonLiteralSizes _sizes;
+
+        // not constexpr: reaching it while the compiler builds a literal stops the build
+        static void fail(JsonError error, size_t pos);
+
+        constexpr char peek() const {
+            return _pos < _json.size() ? _json[_pos] : '\0';
+        }
+
+        constexpr char at(size_t pos) const {
+            return pos < _json.size() ? _json[pos] : '\0';
+        }
+
+        constexpr void skipSpace() {
+            while (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r') _pos++;
+        }
+
+        // appends to the minified text
+        constexpr void put(char c) {
+            if (_text) _text[_sizes.text] = c;
+            _sizes.text++;
+        }
+
+        constexpr void take() {
+            put(_json[_pos++]);
+        }
+
+        // appends to the string pool
+        constexpr void store(char c) {
+            if (_strings) _strings[_sizes.strings] = c;
+            _sizes.strings++;
+        }
+
+        constexpr void value(size_t key, size_t keySize) {
+            size_t index = _sizes.nodes++;
+
+            JsonLiteralNode node;
+            node.key = key;
+            node.keySize = keySize;
+            node.text = _sizes.text;
+
+            switch (peek()) {
+                case '{':
+                    node.type = JSON_MAP;
+                    container(node, '}');
+                break;
+                case '[':
+                    node.type = JSON_ARRAY;
+                    container(node, ']');
+                break;
+                case '"':
+                    node.type = JSON_STRING;
+                    node.str = _sizes.strings;
+                    string();
+                    node.strSize = _sizes.strings - node.str;
+                break;
+                case 't':
+                    node.type = JSON_BOOLEAN;
+                    node.boolean = true;
+                    keyword("true");
+                break;
+                case 'f':
+                    node.type = JSON_BOOLEAN;
+                    keyword("false");
+                break;
+                case 'n':
+                    keyword("null");
+                break;
+                default:
+                    if (peek() != '-' && (peek() < '0' || peek() > '9')) fail(JSON_ERROR_VALUE_EXPECTED, _pos);
+
+                    node.type = JSON_NUMBER;
+                    number(node);
+                break;
+            }
+
+            node.end = _sizes.nodes;
+            node.textSize = _sizes.text - node.text;
+
+            if (_nodes) _nodes[index] = node;
+        }
+
+        constexpr void container(JsonLiteralNode& node, char closing) {
+            take();
+            skipSpace();
+
+            if (peek() == closing) {
+                take();
+                return;
+            }
+
+            while (true) {
+                if (closing == '}') {
+                    if (peek() != '"') fail(JSON_ERROR_KEY_EXPECTED, _pos);
+
+                    size_t key = _sizes.strings;
+                    string();
+                    size_t keySize = _sizes.strings - key;
+
+                    skipSpace();
+                    if (peek() != ':') fail(JSON_ERROR_KEY_SEPARATOR_EXPECTED, _pos);
+
+                    take();
+                    skipSpace();
+                    value(key, keySize);
+                }
+                else {
+                    value(0, 0);
+                }
+
+                node.size++;
+                skipSpace();
+
+                if (peek() == closing) break;
+                if (peek() != ',') fail(_pos < _json.size() ? JSON_ERROR_COMMA_EXPECTED : JSON_ERROR_CLOSING_BRACKET_EXPECTED, _pos);
+
+                take();
+                skipSpace();
+
+                if (peek() == closing) fail(JSON_ERROR_REDUNDANT_COMMA, _pos);
+            }
+
+            take();
+        }
+
+        constexpr void keyword(std::string_view word) {
+            if (_json.substr(_pos, word.size()) != word) fail(JSON_ERROR_UNKNOWN_IDENTIFIER, _pos);
+
+            for (size_t i = 0; i < word.size(); i++) take();
+        }
+
+        // escapes stay as written in the minified text and are decoded into the string pool
+        constexpr void string() {
+            take();
+
+            while (true) {
+                if (_pos >= _json.size()) fail(JSON_ERROR_UNCLOSED_STRING, _pos);
+
+                unsigned char byte = _json[_pos];
+
+                if (byte == '"') break;
+                if (byte < 0x20) fail(JSON_ERROR_CONTROL_CHARACTER, _pos);
+
+                if (byte == '\\') {
+                    escape();
+                    continue;
+                }
+
+                size_t seqSize = byte < 0x80 ? 1 : utf8SeqSize(byte);
+
+                if (seqSize == 0 || _json.size() - _pos < seqSize) fail(JSON_ERROR_INVALID_UTF8, _pos);
+
+                for (size_t i = 1; i < seqSize; i++) {
+                    if (((unsigned char)_json[_pos + i] & 0xc0) != 0x80) fail(JSON_ERROR_INVALID_UTF8, _pos + i);
+                }
+
+                for (size_t i = 0; i < seqSize; i++) {
+                    store(_json[_pos]);
+                    take();
+                }
+            }
+
+            take();
+        }
+
+        constexpr void escape() {
+            char letter = at(_pos + 1);
+
+            if (letter != 'u') {
+                char byte = JSON_UNESCAPE[letter];
+                if (byte == 0) fail(JSON_ERROR_ILLEGAL_ESCAPE, _pos);
+
+                store(byte);
+                take();
+                take();
+                return;
+            }
+
+            size_t length = 6;
+            uint32_t code = codeUnit(_pos);
+
+            if (isLowSurrogate(code)) fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _pos);
+
+            if (isHighSurrogate(code)) {
+                uint32_t low = at(_pos + 6) == '\\' && at(_pos + 7) == 'u' ? codeUnit(_pos + 6) : 0;
+                if (!isLowSurrogate(low)) fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _pos);
+
+                code = combineSurrogates(code, low);
+                length = 12;
+            }
+
+            char bytes[4] = {};
+            size_t count = encodeUtf8(code, bytes);
+
+            for (size_t i = 0; i < count; i++) store(bytes[i]);
+            for (size_t i = 0; i < length; i++) take();
+        }
+
+        // four hex digits of the \u escape at pos
+        constexpr uint32_t codeUnit(size_t pos) const {
+            uint32_t unit = 0;
+
+            for (size_t i = 2; i < 6; i++) {
+                int digit = hexDigit(at(pos + i));
+                if (digit < 0) fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, pos);
+
+                unit = (unit << 4) | digit;
+            }
+
+            return unit;
+        }
+
+        // integers are exact; a real is computed when its digits and power of ten are both exact doubles,
+        // anything else keeps exact false and is converted from the text when read
+        constexpr void number(JsonLiteralNode& node) {
+            const size_t begin = _pos;
+            bool negative = peek() == '-';
+            if (negative) take();
+
+            if (peek() < '0' || peek() > '9') fail(JSON_ERROR_NUMBER_EXPECTED, begin);
+            if (peek() == '0' && at(_pos + 1) >= '0' && at(_pos + 1) <= '9') fail(JSON_ERROR_LEADING_ZERO, begin);
+
+            uint64_t mantissa = 0;
+            bool truncated = false;
+            bool zero = true;
+            // decimal exponent of the leading digit, and of the last digit kept in the mantissa
+            long lead = -1;
+            long scale = 0;
+
+            auto digit = [&](bool fraction) {
+                int d = _json[_pos] - '0';
+
+                if (d != 0 && zero) zero = false;
+                else if (zero && fraction) lead--;
+
+                if (!zero && !fraction) lead++;
+
+                if (mantissa <= (UINT64_MAX - 9) / 10) {
+                    mantissa = mantissa * 10 + d;
+                    if (fraction) scale--;
+                }
+                else {
+                    truncated = true;
+                    if (!fraction) scale++;
+                }
+
+                take();
+            };
+
+            while (peek() >= '0' && peek() <= '9') digit(false);
+
+            if (peek() == '.') {
+                node.real = true;
+                take();
+
+                if (peek() < '0' || peek() > '9') fail(JSON_ERROR_NUMBER_EXPECTED, begin);
+                while (peek() >= '0' && peek() <= '9') digit(true);
+            }
+
+            long exponent = 0;
+
+            if (peek() == 'e' || peek() == 'E') {
+                node.real = true;
+                take();
+
+                bool negativeExponent = peek() == '-';
+                if (peek() == '+' || peek() == '-') take();
+
+                if (peek() < '0' || peek() > '9') fail(JSON_ERROR_NUMBER_EXPECTED, begin);
+
+                while (peek() >= '0' && peek() <= '9') {
+                    if (exponent < 100000) exponent = exponent * 10 + (peek() - '0');
+                    take();
+                }
+
+                if (negativeExponent) exponent = -exponent;
+            }
+
+            // stricter than a double by a little: magnitudes from 1e-307 up to below 1e308
+            if (!zero && (lead + exponent > 307 || lead + exponent < -307)) fail(JSON_ERROR_NUMBER_OUT_OF_RANGE, begin);
+
+            const uint64_t longMax = (uint64_t)INT64_MAX;
+
+            if (!node.real && !truncated && mantissa <= longMax + negative) {
+                node.integer = negative ? (long)(0 - mantissa) : (long)mantissa;
+                node.number = negative ? -(double)mantissa : (double)mantissa;
+                return;
+            }
+
+            // integers beyond long are reals, as JsonReader reads them
+            node.real = true;
+            node.exact = false;
+
+            long power = scale + exponent;
+
+            if (truncated || mantissa > (1ull << 53) || power < -22 || power > 22) return;
+
+            double value = (double)mantissa;
+            double ten = 1;
+
+            for (long i = 0; i < (power < 0 ? -power : power); i++) ten *= 10;
+
+            value = power < 0 ? value / ten : value * ten;
+            node.number = negative ? -value : value;
+            node.exact = true;
+        }
+    };
+
+    class JsonLiteralView;
+
+    // walks array items or map values in document order
+    class JsonLiteralIterator {
+    public:
+        constexpr JsonLiteralIterator(const JsonLiteralView& container, size_t index);
+
+        constexpr JsonLiteralView operator *() const;
+        constexpr std::string_view key() const;
+
+        constexpr JsonLiteralIterator& operator ++();
+        constexpr bool operator ==(const JsonLiteralIterator& other) const;
+        constexpr bool operator !=(const JsonLiteralIterator& other) const;
+
+    private:
+        const JsonLiteralNode* _nodes;
+        const char* _text;
+        const char* _strings;
+        size_t _index;
+    };
+
+    // read-only access to a value of a literal, the accessors of JsonTapeView
+    class JsonLiteralView {
+    public:
+        constexpr JsonLiteralView() = default;
+
+        constexpr JsonLiteralView(const JsonLiteralNode* nodes, const char* text, const char* strings, size_t index)
+            : _nodes(nodes), _text(text), _strings(strings), _index(index) { }
+
+        // false for views of missing elements
+        constexpr bool valid() const {
+            return _nodes != nullptr;
+        }
+
+        constexpr JsonType type() const {
+            return valid() ? node().type : JSON_NULL;
+        }
+
+        constexpr size_t size() const {
+            if (isString()) return node().strSize;
+            return valid() ? node().size : 0;
+        }
+
+        constexpr bool isArray() const { return type() == JSON_ARRAY; }
+        constexpr bool isMap() const { return type() == JSON_MAP; }
+        constexpr bool isString() const { return type() == JSON_STRING; }
+        constexpr bool isNumber() const { return type() == JSON_NUMBER; }
+        constexpr bool isBoolean() const { return type() == JSON_BOOLEAN; }
+        constexpr bool isNull() const { return type() == JSON_NULL; }
+
+        constexpr std::string_view str() const {
+            if (!isString()) return std::string_view();
+            return std::string_view(_strings + node().str, node().strSize);
+        }
+
+        constexpr bool boolean() const {
+            return isBoolean() && node().boolean;
+        }
+
+        // a constant expression unless the number is one the compiler could not convert exactly
+        constexpr double number() const {
+            if (!isNumber()) return 0;
+            return node().exact ? node().number : convert();
+        }
+
+        constexpr long numberLong() const {
+            if (!isNumber()) return 0;
+            return node().real ? (long)number() : node().integer;
+        }
+
+        // the value without insignificant whitespace, ready to be copied into output as is
+        constexpr std::string_view minified() const {
+            if (!valid()) return std::string_view();
+            return std::string_view(_text + node().text, node().textSize);
+        }
+
+        // linear scans, missing elements give an invalid null view, duplicate keys resolve to the last one
+        constexpr JsonLiteralView operator [](size_t index) const {
+            if (!isArray()) return JsonLiteralView();
+
+            for (auto it = begin(); it != end(); ++it) {
+                if (index-- == 0) return *it;
+            }
+
+            return JsonLiteralView();
+        }
+
+        constexpr JsonLiteralView operator [](std::string_view key) const {
+            JsonLiteralView found;
+
+            if (!isMap()) return found;
+
+            for (auto it = begin(); it != end(); ++it) {
+                if (it.key() == key) found = *it;
+            }
+
+            return found;
+        }
+
+        constexpr bool hasKey(std::string_view key) const {
+            return (*this)[key].valid();
+        }
+
+        constexpr JsonLiteralIterator begin() const {
+            if (!isArray() && !isMap()) return end();
+            return JsonLiteralIterator(*this, _index + 1);
+        }
+
+        constexpr JsonLiteralIterator end() const {
+            return JsonLiteralIterator(*this, valid() ? node().end : 0);
+        }
+
+        JsonObject toObject() const;
+
+        // a plain copy of the minified text
+        void write(JsonWriter& writer) const;
+        void operator >>(std::ostream& stream) const;
+
+    private:
+        friend class JsonLiteralIterator;
+
+        const JsonLiteralNode* _nodes = nullptr;
+        const char* _text = nullptr;
+        const char* _strings = nullptr;
+        size_t _index = 0;
+
+        constexpr const JsonLiteralNode& node() const {
+            return _nodes[_index];
+        }
+
+        double convert() const;
+    };
+
+    constexpr JsonLiteralIterator::JsonLiteralIterator(const JsonLiteralView& container, size_t index)
+        : _nodes(container._nodes), _text(container._text), _strings(container._strings), _index(index) { }
+
+    constexpr JsonLiteralView JsonLiteralIterator::operator *() const {
+        return JsonLiteralView(_nodes, _text, _strings, _index);
+    }
+
+    constexpr std::string_view JsonLiteralIterator::key() const {
+        return std::string_view(_strings + _nodes[_index].key, _nodes[_index].keySize);
+    }
+
+    constexpr JsonLiteralIterator& JsonLiteralIterator::operator ++() {
+        _index = _nodes[_index].end;
+        return *this;
+    }
+
+    constexpr bool JsonLiteralIterator::operator ==(const JsonLiteralIterator& other) const {
+        return _index == other._index;
+    }
+
+    constexpr bool JsonLiteralIterator::operator !=(const JsonLiteralIterator& other) const {
+        return _index != other._index;
+    }
+
+    // storage sized by JSONMINI_JSON, which also makes sure it is filled at compile time
+    template<size_t NODES, size_t TEXT, size_t STRINGS>
+    class JsonLiteral {
+    public:
+        constexpr explicit JsonLiteral(std::string_view json) : _nodes(), _text(), _strings() {
+            JsonLiteralParser(json, _nodes, _text, _strings).parse();
+        }
+
+        constexpr JsonLiteralView root() const {
+            return JsonLiteralView(_nodes, _text, _strings, 0);
+        }
+
+        constexpr std::string_view minified() const {
+            return std::string_view(_text, TEXT);
+        }
+
+        JsonObject toObject() const {
+            return root().toObject();
+        }
+
+        void write(JsonWriter& writer) const {
+            root().write(writer);
+        }
+
+        void operator >>(std::ostream& stream) const {
+            root() >> stream;
+        }
+
+    private:
+        JsonLiteralNode _nodes[NODES];
+        char _text[TEXT];
+        // one more byte so that a literal without strings still has an array
+        char _strings[STRINGS + 1];
+    };
+}
+
+#endif
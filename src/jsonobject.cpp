@@ -1,35 +1,17 @@
 #include "jsonobject.hpp"
 
+#include "jsonescape.hpp"
 #include "jsonobjectexception.hpp"
+#include "jsonreader.hpp"
+#include "jsonstats.hpp"
+#include "jsonwriter.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
 #include <sstream>
-#include <stdexcept>
-#include <iomanip>
 
 namespace jsonmini {
-    const std::map<char, const char*> _OUTCC = {
-        { '\n', "\\n" },
-        { '\r', "\\r" },
-        // { '\a', "\\\\a" },
-        { '\t', "\\t" },
-        { '\b', "\\b" },
-        { '\f', "\\f" },
-        // { '\v', "\\\\v" },
-        // { '\e', "\\\\e" },
-        { '"', "\\\""},
-        { '\\', "\\\\"}
-    };
-
-    const std::map<char, char> _INCC = {
-        { 'n', '\n' },
-        { 'r', '\r' },
-        // { 'a', '\a' },
-        { 't', '\t' },
-        { 'b', '\b' },
-        { 'f', '\f' }
-        // { 'v', '\v' },
-        // { 'e', '\e' }
-    };
-
     JsonObject::JsonObject() {
         _type = JSON_NULL;
     }
@@ -42,6 +24,7 @@ namespace jsonmini {
 
     JsonObject::JsonObject(long value) {
         _num = value;
+        _long = value;
         _type = JSON_NUMBER;
         _realNum = false;
     }
@@ -61,8 +44,37 @@ namespace jsonmini {
         _type = JSON_STRING;
     }
 
+    // destructors of nested containers running on this thread
+    static thread_local size_t _releaseDepth = 0;
+
+    // nesting the call stack takes before subtrees are released iteratively
+    static const size_t _RECURSIVE_RELEASE_DEPTH = 512;
+
+    JsonObject::~JsonObject() {
+        if (!_arr.isSet() && !_map.isSet()) return;
+
+        if (_releaseDepth < _RECURSIVE_RELEASE_DEPTH) {
+            _releaseDepth++;
+            _arr.reset();
+            _map.reset();
+            _releaseDepth--;
+            return;
+        }
+
+        std::vector<JsonObject> released;
+
+        releaseNested(released);
+
+        // each subtree is emptied before it is destroyed, so deeper levels do not recurse
+        while (!released.empty()) {
+            JsonObject item = std::move(released.back());
+            released.pop_back();
+            item.releaseNested(released);
+        }
+    }
+
     JsonObject::operator long() {
-        return (long)_num;
+        return numberLong();
     }
 
     JsonObject::operator double() {
@@ -89,6 +101,20 @@ namespace jsonmini {
         return JsonObject(JSON_ARRAY);
     }
 
+    JsonObject JsonObject::makeArray(std::vector<long> values) {
+        JsonObject obj(JSON_ARRAY);
+        obj._packed.mut().integers = std::move(values);
+        return obj;
+    }
+
+    JsonObject JsonObject::makeArray(std::vector<double> values) {
+        JsonObject obj(JSON_ARRAY);
+        auto& packed = obj._packed.mut();
+        packed.reals = std::move(values);
+        packed.real = true;
+        return obj;
+    }
+
     JsonObject JsonObject::fromStr(std::string& str) {
         std::stringstream ss(str);
         JsonObject obj;
@@ -98,8 +124,78 @@ namespace jsonmini {
         return obj;
     }
 
+    JsonResult JsonObject::parse(const char* data, size_t size, JsonObject& out, const JsonLimits& limits) noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+        JsonReader reader(data, size, limits);
+
+        out.reset();
+
+        if (out.read(reader) && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        if (reader.failed()) out.reset();
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+        return reader.result();
+    }
+
+    JsonResult JsonObject::parse(const std::string& str, JsonObject& out, const JsonLimits& limits) noexcept {
+        return parse(str.data(), str.size(), out, limits);
+    }
+
+    JsonResult JsonObject::validate(const char* data, size_t size, const JsonLimits& limits) noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_VALIDATE);
+        JsonReader reader(data, size, limits);
+
+        if (reader.skipValue() && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+
+        return reader.result();
+    }
+
+    JsonResult JsonObject::validate(const std::string& str, const JsonLimits& limits) noexcept {
+        return validate(str.data(), str.size(), limits);
+    }
+
     void JsonObject::remove(size_t index) {
-        _arr.erase(_arr.begin() + index);
+        touch();
+        unpack();
+
+        auto& arr = _arr.mut();
+        arr.erase(arr.begin() + index);
+    }
+
+    void JsonObject::merge(const JsonObject& patch) {
+        // the shared copy keeps the patch intact even if it lives inside of this tree
+        JsonObject source = patch;
+        mergeNode(source);
+    }
+
+    void JsonObject::merge(JsonObject&& patch) {
+        JsonObject source = std::move(patch);
+        mergeNode(std::move(source));
+    }
+
+    JsonResult JsonObject::mergeFrom(const char* data, size_t size, const JsonLimits& limits) noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+
+        JsonResult result = validate(data, size, limits);
+        if (!result) return result;
+
+        JsonReader reader(data, size, limits);
+        mergeRead(reader);
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+
+        return reader.result();
+    }
+
+    JsonResult JsonObject::mergeFrom(const std::string& str, const JsonLimits& limits) noexcept {
+        return mergeFrom(str.data(), str.size(), limits);
     }
 
     void JsonObject::setMinificationEnabled(bool value) {
@@ -110,18 +206,30 @@ namespace jsonmini {
         _ignoreNull = value;
     }
 
+    void JsonObject::setStyle(const JsonStyle& style) {
+        _style = style;
+    }
+
+    void JsonObject::setSerializationCacheEnabled(bool value) {
+        _cacheSerialized = value;
+    }
+
     void JsonObject::clear() {
+        touch();
+
         switch (_type) {
             case JSON_STRING:
                 _str.clear();
             break;
             case JSON_ARRAY:
-                _arr.clear();
+                _arr.reset();
+                _packed.reset();
             break;
             case JSON_MAP:
-                _map.clear();
+                _map.reset();
             case JSON_NUMBER:
                 _num = 0;
+                _long = 0;
             case JSON_BOOLEAN:
                 _bool = false;
             break;
@@ -129,40 +237,197 @@ namespace jsonmini {
     }
 
     bool JsonObject::remove(std::string key) {
-        return _map.erase(key) != 0;
+        if (!isMap() || _map.get().find(key) == _map.get().end()) return false;
+
+        touch();
+        _map.mut().erase(key);
+        return true;
     }
 
     bool JsonObject::hasKey(std::string key) {
         if (!isMap()) return false;
 
-        return _map.find(key) != _map.end();
+        return _map.get().find(key) != _map.get().end();
+    }
+
+    bool JsonObject::pack() {
+        if (!isArray()) return false;
+        if (_packed.isSet()) return true;
+
+        const auto& arr = _arr.get();
+        bool real = !arr.empty() && arr[0]._realNum;
+
+        for (auto& item : arr) {
+            if (!item.isNumber() || item._realNum != real) return false;
+            if (!real && item._long == 0 && std::signbit(item._num)) return false;
+        }
+
+        touch();
+
+        auto& packed = _packed.mut();
+        packed.real = real;
+
+        for (auto& item : arr) {
+            if (real) packed.reals.push_back(item._num);
+            else packed.integers.push_back(item._long);
+        }
+
+        _arr.reset();
+        return true;
+    }
+
+    bool JsonObject::isPacked() const {
+        return _packed.isSet();
     }
 
     JsonObject& JsonObject::operator [](size_t index) {
-        if (!isArray()) throw JsonObjectException("object cannot be used as array");
+        if (!isArray()) JSONMINI_THROW(JsonObjectException("object cannot be used as array"));
+
+        touch();
+        unpack();
 
-        while (_arr.size() < (index + 1)) {
-            _arr.emplace_back();
+        auto& arr = _arr.mut();
+
+        while (arr.size() < (index + 1)) {
+            arr.emplace_back();
         }
 
-        return _arr[index];
+        return arr[index];
     }
 
     JsonObject& JsonObject::operator [](std::string key) {
-        if (!isMap()) throw JsonObjectException("object cannot be used as map");
-        return _map[key];
+        if (!isMap()) JSONMINI_THROW(JsonObjectException("object cannot be used as map"));
+
+        touch();
+        return _map.mut()[key];
     }
 
     JsonType JsonObject::type() const {
         return _type;
     }
 
+    bool JsonObject::operator ==(const JsonObject& other) const {
+        return equals(other);
+    }
+
+    bool JsonObject::operator !=(const JsonObject& other) const {
+        return !equals(other);
+    }
+
+    // exact integer value of a number, false for fractional or out of range reals
+    static bool integralValue(double num, long integer, bool real, long& out) {
+        if (!real) {
+            out = integer;
+            return true;
+        }
+
+        // -2^63 is exact as a double, 2^63 is the first value beyond long
+        if (!(num >= -9223372036854775808.0 && num < 9223372036854775808.0) || num != (double)(long)num) return false;
+
+        out = (long)num;
+        return true;
+    }
+
+    static size_t combineHash(size_t seed, size_t value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    size_t JsonObject::hash() const {
+        if (_hash != 0) return _hash;
+
+        size_t h = combineHash(0, _type);
+
+        switch (_type) {
+            case JSON_NUMBER:
+                h = numberHash(_num, _long, _realNum);
+            break;
+            case JSON_BOOLEAN:
+                h = combineHash(h, _bool);
+            break;
+            case JSON_STRING:
+                h = combineHash(h, std::hash<std::string>()(_str));
+            break;
+            case JSON_ARRAY:
+            {
+                // packed items hash like the nodes they would be unpacked to
+                const Packed& packed = _packed.get();
+
+                for (long item : packed.integers) {
+                    h = combineHash(h, numberHash(item, item, false));
+                }
+
+                for (double item : packed.reals) {
+                    h = combineHash(h, numberHash(item, 0, true));
+                }
+
+                for (auto& item : _arr.get()) {
+                    h = combineHash(h, item.hash());
+                }
+            }
+            break;
+            case JSON_MAP:
+                for (auto& pair : _map.get()) {
+                    h = combineHash(h, std::hash<std::string>()(pair.first));
+                    h = combineHash(h, pair.second.hash());
+                }
+            break;
+            default:
+            break;
+        }
+
+        _hash = (h == 0 ? 1 : h);
+        return _hash;
+    }
+
+    // the hash of a number node
+    size_t JsonObject::numberHash(double num, long integer, bool real) {
+        size_t h = combineHash(0, JSON_NUMBER);
+        long exact;
+
+        // integral reals hash like the equal integers
+        if (integralValue(num, integer, real, exact)) h = combineHash(h, std::hash<long>()(exact));
+        else h = combineHash(h, std::hash<double>()(num));
+
+        return h == 0 ? 1 : h;
+    }
+
+    JsonFootprint JsonObject::footprint() const {
+        JsonFootprint fp;
+        addFootprint(fp);
+        return fp;
+    }
+
+    void JsonObject::shrinkToFit() {
+        _str.shrink_to_fit();
+
+        if (_arr.isSet()) {
+            auto& arr = _arr.mut();
+            arr.shrink_to_fit();
+
+            for (auto& item : arr) {
+                item.shrinkToFit();
+            }
+        }
+
+        if (_map.isSet()) {
+            for (auto& pair : _map.mut()) {
+                pair.second.shrinkToFit();
+            }
+        }
+
+        if (_packed.isSet()) {
+            auto& packed = _packed.mut();
+            packed.integers.shrink_to_fit();
+            packed.reals.shrink_to_fit();
+        }
+    }
+
     size_t JsonObject::size() const {
         switch (_type) {
             case JSON_ARRAY:
-                return _arr.size();
+                return _packed.isSet() ? _packed.get().integers.size() + _packed.get().reals.size() : _arr.get().size();
             case JSON_MAP:
-                return _map.size();
+                return _map.get().size();
             case JSON_STRING:
                 return _str.size();
             default:
@@ -194,30 +459,110 @@ namespace jsonmini {
         return _type == JSON_NULL;
     }
 
-    std::string JsonObject::str() {
+    std::string JsonObject::str() const {
         return _str;
     }
 
-    bool JsonObject::boolean() {
+    bool JsonObject::boolean() const {
         return _bool;
     }
 
-    double JsonObject::number() {
+    double JsonObject::number() const {
         return _num;
     }
 
-    long JsonObject::numberLong() {
-        return (long)_num;
+    long JsonObject::numberLong() const {
+        return _realNum ? (long)_num : _long;
     }
 
     std::map<std::string, JsonObject>* JsonObject::map() {
-        if (!isMap()) throw JsonObjectException("object is not a map");
-        return &_map;
+        if (!isMap()) JSONMINI_THROW(JsonObjectException("object is not a map"));
+
+        touch();
+        return &_map.mut();
     }
 
     std::vector<JsonObject>* JsonObject::vector() {
-        if (!isArray()) throw JsonObjectException("object is not an array");
-        return &_arr;
+        if (!isArray()) JSONMINI_THROW(JsonObjectException("object is not an array"));
+
+        touch();
+        unpack();
+        return &_arr.mut();
+    }
+
+    JsonObject* JsonObject::get(size_t index) noexcept {
+        if (!isArray() || index >= size()) return nullptr;
+
+        touch();
+        unpack();
+        return &_arr.mut()[index];
+    }
+
+    const JsonObject* JsonObject::get(size_t index) const noexcept {
+        if (!isArray() || _packed.isSet() || index >= size()) return nullptr;
+
+        return &_arr.get()[index];
+    }
+
+    JsonObject* JsonObject::get(const std::string& key) noexcept {
+        if (!isMap() || _map.get().find(key) == _map.get().end()) return nullptr;
+
+        touch();
+        return &_map.mut().find(key)->second;
+    }
+
+    const JsonObject* JsonObject::get(const std::string& key) const noexcept {
+        if (!isMap()) return nullptr;
+
+        auto iter = _map.get().find(key);
+        return iter == _map.get().end() ? nullptr : &iter->second;
+    }
+
+    std::map<std::string, JsonObject>* JsonObject::asMap() noexcept {
+        if (!isMap()) return nullptr;
+
+        touch();
+        return &_map.mut();
+    }
+
+    const std::map<std::string, JsonObject>* JsonObject::asMap() const noexcept {
+        return isMap() ? &_map.get() : nullptr;
+    }
+
+    std::vector<JsonObject>* JsonObject::asVector() noexcept {
+        if (!isArray()) return nullptr;
+
+        touch();
+        unpack();
+        return &_arr.mut();
+    }
+
+    const std::vector<JsonObject>* JsonObject::asVector() const noexcept {
+        if (!isArray() || _packed.isSet()) return nullptr;
+
+        return &_arr.get();
+    }
+
+    std::vector<long>* JsonObject::asLongs() noexcept {
+        if (!_packed.isSet() || _packed.get().real) return nullptr;
+
+        touch();
+        return &_packed.mut().integers;
+    }
+
+    const std::vector<long>* JsonObject::asLongs() const noexcept {
+        return _packed.isSet() && !_packed.get().real ? &_packed.get().integers : nullptr;
+    }
+
+    std::vector<double>* JsonObject::asDoubles() noexcept {
+        if (!_packed.isSet() || !_packed.get().real) return nullptr;
+
+        touch();
+        return &_packed.mut().reals;
+    }
+
+    const std::vector<double>* JsonObject::asDoubles() const noexcept {
+        return _packed.isSet() && _packed.get().real ? &_packed.get().reals : nullptr;
     }
 
     void JsonObject::operator <<(const char* jsonStr) {
@@ -227,533 +572,1268 @@ namespace jsonmini {
 
     // deserialization function
     void JsonObject::operator <<(std::istream& stream) {
-        clear();
+        readStream(stream, JsonLimits());
+    }
+
+#ifdef JSONMINI_STATS
+    // strings up to that size are stored inside of the object
+    static const size_t _SSO_CAPACITY = std::string().capacity();
+#endif
+
+    // containers being filled are kept on an explicit stack, nesting costs no call stack
+    void JsonObject::readStream(std::istream& stream, const JsonLimits& limits) {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+
+        struct Frame {
+            JsonObject* container;
+            bool isMap;
+            bool comma;
+            size_t size;
+        };
+
+        std::vector<Frame> stack;
+        std::string key;
+        JsonObject* value = this;
+        size_t nodes = 0;
+        size_t pos = 0;
+        char byte = '\0';
+        bool pending = false;
+
+#ifdef JSONMINI_STATS
+        // errors are thrown, the bytes read up to one are counted when the scope is left
+        struct BytesRead {
+            const size_t& pos;
+            ~BytesRead() { JSONMINI_STAT(bytesRead += pos); }
+        } bytesRead{ pos };
+#endif
+
+        // bytes are taken from the buffer directly, the stream is only checked once
+        std::istream::sentry sentry(stream, true);
+        std::streambuf* buf = sentry ? stream.rdbuf() : nullptr;
+
+        // pos - 1 is always the index of byte, a pending byte was read but not consumed yet
+        auto next = [&]() {
+            if (pending) {
+                pending = false;
+                return true;
+            }
+
+            int c = buf ? buf->sbumpc() : EOF;
+
+            if (c == EOF) {
+                stream.setstate(std::ios::eofbit);
+                return false;
+            }
+
+            byte = (char)c;
+            pos++;
+            checkStreamBytes(pos, limits);
+            return true;
+        };
+
+        // four hex digits of a \u escape
+        auto readCodeUnit = [&]() {
+            uint32_t unit = 0;
+
+            for (int i = 0; i < 4; i++) {
+                int digit = next() ? hexDigit(byte) : -1;
+
+                if (digit < 0) JSONMINI_THROW(JsonObjectException("invalid unicode character escape sequence", pos - 1));
+
+                unit = (unit << 4) | digit;
+            }
+
+            return unit;
+        };
+
+        // byte is the opening quote, the closing one is consumed
+        auto readString = [&](std::string& str) {
+            bool esc = false;
+            size_t begin = pos;
+
+            str.clear();
+
+            while (next()) {
+                // content bytes as written, the closing quote is not counted
+                if (pos - begin - (!esc && byte == '"') > limits.maxStringLength) {
+                    JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_STRING_TOO_LONG), begin + limits.maxStringLength));
+                }
+
+                if (!esc && byte == '\\') {
+                    JSONMINI_STAT(escapesRead++);
+                    esc = true;
+                    continue;
+                }
+
+                size_t chrSize = utf8CharSize(byte);
+
+                if (chrSize == 0) JSONMINI_THROW(JsonObjectException("invalid utf-8 byte (data corruption)", pos - 1));
+                if (esc && chrSize != 1) JSONMINI_THROW(JsonObjectException("illegal escape sequence", pos));
+
+                if (chrSize == 1) {
+                    if (isControl(byte)) {
+                        JSONMINI_THROW(JsonObjectException("control character", pos - 1));
+                    }
+
+                    if (!esc && byte == '"') {
+                        JSONMINI_STAT(stringBytesRead += pos - begin - 1);
+                        return;
+                    }
+
+                    if (esc) {
+                        if (byte == 'u') {
+                            uint32_t code = readCodeUnit();
+
+                            if (isLowSurrogate(code)) JSONMINI_THROW(JsonObjectException("invalid unicode character escape sequence", pos - 4));
+
+                            if (isHighSurrogate(code)) {
+                                if (!next() || byte != '\\' || !next() || byte != 'u') {
+                                    JSONMINI_THROW(JsonObjectException("invalid unicode character escape sequence", pos - 1));
+                                }
 
-        if (_pdepth == 0) throw JsonObjectException("initial depth must not be equal to 0");
+                                JSONMINI_STAT(escapesRead++);
+                                uint32_t low = readCodeUnit();
 
-        size_t charSize;
-        bool readskip = _lchar != '\0';
-        bool drop = false;
+                                if (!isLowSurrogate(low)) JSONMINI_THROW(JsonObjectException("invalid unicode character escape sequence", pos - 4));
 
-        while (stream.peek() != EOF) {
-            if (!readskip) {
-                stream.get(_lchar);
-                _pos++;
+                                code = combineSurrogates(code, low);
+                            }
+
+                            char seq[4];
+                            str.append(seq, encodeUtf8(code, seq));
+                        }
+                        else {
+                            char sub = JSON_UNESCAPE[byte];
+
+                            if (sub == 0) JSONMINI_THROW(JsonObjectException("illegal escape sequence", pos));
+
+                            str.push_back(sub);
+                        }
+
+                        esc = false;
+                        continue;
+                    }
+                }
+
+                str.push_back(byte);
+
+                for (size_t i = 1; i < chrSize; i++) {
+                    if (!next()) JSONMINI_THROW(JsonObjectException("invalid utf-8 byte (data corruption)", pos));
+                    if ((byte & 0xc0) != 0x80) JSONMINI_THROW(JsonObjectException("invalid utf-8 byte (data corruption)", pos - 1));
+
+                    str.push_back(byte);
+                }
+            }
+
+            JSONMINI_THROW(JsonObjectException("unclosed string", begin - 1));
+        };
+
+        reset();
+
+        while (true) {
+            bool found = false;
+
+            while (next()) {
+                if (utf8CharSize(byte) == 0) JSONMINI_THROW(JsonObjectException("invalid utf-8 byte (data corruption)", pos - 1));
+                if (isSpace(byte)) continue;
+
+                found = true;
+                break;
             }
-            else readskip = false;
 
-            size_t charSize = utf8CharSize(_lchar);
+            // a map member is missing its value, an array only its closing bracket
+            bool member = !stack.empty() && stack.back().isMap;
 
-            if (charSize == 0) throw JsonObjectException("invalid utf-8 byte (data corruption)", _pos - 1);
-            if (std::isspace(_lchar)) continue;
+            if (!found) {
+                JSONMINI_THROW(JsonObjectException(stack.empty() || member ? "value expected" : "closing bracket expected", pos));
+            }
 
             // number deserialization
-            if ((isDigit(_lchar) || _lchar == '-') && !_fin) {
+            if (isDigit(byte) || byte == '-') {
+                if (++nodes > limits.maxNodes) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_TOO_MANY_NODES), pos - 1));
+
                 std::string numStr;
-                numStr.push_back(_lchar);
-                size_t begin = _pos;
+                numStr.push_back(byte);
+                size_t begin = pos;
 
                 bool period = false,
-                    neg = (_lchar == '-'),
                     e = false,
                     eSign = false,
-                    numAfterE = false,
-                    mbreak = false;
+                    numAfterE = false;
 
-                while (stream.peek() != EOF) {
-                    stream.get(_lchar);
-                    _pos++;
-
-                    if (isDigit(_lchar)) {
-                        if (numStr.front() == '0' && !period) throw JsonObjectException("leading zero is not allowed");
+                while (next()) {
+                    if (isDigit(byte)) {
+                        if ((numStr == "0" || numStr == "-0") && !period) JSONMINI_THROW(JsonObjectException("leading zero is not allowed", pos - 1));
                         if (e) numAfterE = true;
-                        numStr.push_back(_lchar);
+                        numStr.push_back(byte);
                         continue;
                     }
 
-                    if (_lchar == '.') {
-                        if (period) throw JsonObjectException("period cannot be used twice", _pos - 1);
-                        if (e) throw JsonObjectException("period cannot be used here", _pos - 1);
+                    if (byte == '.') {
+                        if (period) JSONMINI_THROW(JsonObjectException("period cannot be used twice", pos - 1));
+                        if (e || !isDigit(numStr.back())) JSONMINI_THROW(JsonObjectException("period cannot be used here", pos - 1));
 
                         period = true;
-                        numStr.push_back(_lchar);
+                        numStr.push_back(byte);
                         continue;
                     }
 
-                    if (_lchar == '-' || _lchar == '+') {
-                        if (!e || (e && eSign) || numAfterE) throw JsonObjectException("sign cannot be used here", _pos - 1);
-                        if (e) eSign = true;
-                        numStr.push_back(_lchar);
+                    if (byte == '-' || byte == '+') {
+                        if (!e || eSign || numAfterE) JSONMINI_THROW(JsonObjectException("sign cannot be used here", pos - 1));
+                        eSign = true;
+                        numStr.push_back(byte);
                         continue;
                     }
 
-                    if (_lchar == 'e') {
-                        if (e) throw JsonObjectException("invalid number format", _pos - 1);
+                    if (byte == 'e' || byte == 'E') {
+                        if (e || !isDigit(numStr.back())) JSONMINI_THROW(JsonObjectException("invalid number format", pos - 1));
                         e = true;
-                        numStr.push_back(_lchar);
+                        numStr.push_back(byte);
                         continue;
                     }
 
-                    drop = true;
+                    pending = true;
                     break;
                 }
 
-                if ((e && !numAfterE) || numStr == "-" || numStr.back() == '.') throw JsonObjectException("number expected", _pos - 1);
+                if ((e && !numAfterE) || numStr == "-" || numStr.back() == '.') JSONMINI_THROW(JsonObjectException("number expected", pos - 1));
 
-                _type = JSON_NUMBER;
-                _realNum = period;
+                value->_type = JSON_NUMBER;
+                value->_realNum = period || e;
 
-                try {
-                    _num = std::stod(numStr);
-                }
-                catch (std::out_of_range&) {
-                    throw JsonObjectException("number out of range", begin);
-                }
+                const char* numEnd = numStr.data() + numStr.size();
 
-                readskip = true;
-                _fin = true;
+                // same conversion as the buffer parser, denormals are in range
+                if (std::from_chars(numStr.data(), numEnd, value->_num).ec == std::errc::result_out_of_range) {
+                    JSONMINI_THROW(JsonObjectException("number out of range", begin));
+                }
 
-                if (_pdepth == 1) continue;
-                else break;
+                // integers are kept exactly, beyond the 53 bits a double can hold
+                if (!value->_realNum && std::from_chars(numStr.data(), numEnd, value->_long).ec == std::errc::result_out_of_range) {
+                    value->_realNum = true;
+                    value->_long = 0;
+                }
             }
-
             // keyword deserialization
-            if (isalpha(_lchar) && !_fin) {
-                std::string kw;
-                kw.push_back(_lchar);
+            else if (std::isalpha((unsigned char)byte)) {
+                if (++nodes > limits.maxNodes) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_TOO_MANY_NODES), pos - 1));
 
-                size_t beginPos = _pos - 1;
+                std::string kw;
+                kw.push_back(byte);
 
-                while (stream.peek() != EOF) {
-                    stream.get(_lchar);
-                    _pos++;
+                size_t beginPos = pos - 1;
 
-                    if (std::isalpha(_lchar)) {
-                        kw.push_back(_lchar);
+                while (next()) {
+                    if (std::isalpha((unsigned char)byte)) {
+                        kw.push_back(byte);
                         continue;
                     }
 
-                    drop = true;
+                    pending = true;
                     break;
                 }
 
                 if (kw == "true") {
-                    _type = JSON_BOOLEAN;
-                    _bool = true;
+                    value->_type = JSON_BOOLEAN;
+                    value->_bool = true;
                 }
                 else if (kw == "false") {
-                    _type = JSON_BOOLEAN;
-                    _bool = false;
+                    value->_type = JSON_BOOLEAN;
+                    value->_bool = false;
                 }
-                else if (kw == "null") {
-                    _type = JSON_NULL;
+                else if (kw != "null") {
+                    JSONMINI_THROW(JsonObjectException("unknown identifier starting", beginPos));
                 }
-                else throw JsonObjectException("unknown identifier starting", beginPos);
-
-                readskip = true;
-                _fin = true;
-                if (_pdepth == 1) continue;
-                else break;
             }
-
             // string deserialization
-            if (_lchar == '"' && !_fin) {
-                bool esc = false;
-                size_t begin = _pos;
-                std::string str;
+            else if (byte == '"') {
+                if (++nodes > limits.maxNodes) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_TOO_MANY_NODES), pos - 1));
 
-                while (stream.peek() != EOF) {
-                    stream.get(_lchar);
-                    _pos++;
+                value->_type = JSON_STRING;
+                readString(value->_str);
+                JSONMINI_STAT(allocations += (value->_str.capacity() > _SSO_CAPACITY));
+            }
+            // array/map deserialization, the container is filled by the loop below
+            else if (byte == '[' || byte == '{') {
+                if (stack.size() >= limits.maxDepth) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_DEPTH_EXCEEDED), pos - 1));
+                if (++nodes > limits.maxNodes) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_TOO_MANY_NODES), pos - 1));
 
-                    if (!esc && _lchar == '\\') {
-                        esc = true;
-                        continue;
-                    }
+                bool isMap = (byte == '{');
 
-                    size_t chrSize = utf8CharSize(_lchar);
+                value->_type = (isMap ? JSON_MAP : JSON_ARRAY);
+                stack.push_back(Frame{ value, isMap, true, 0 });
+                JSONMINI_STAT(reach(stack.size()));
+                JSONMINI_STAT(allocations++);
+            }
+            else {
+                JSONMINI_THROW(JsonObjectException(member && byte == '}' ? "value expected" : "character is not allowed here", pos - 1));
+            }
 
-                    if (chrSize == 0) throw JsonObjectException("invalid utf-8 byte (data corruption)", _pos - 1);
+            JSONMINI_STAT(nodes[value->_type]++);
 
-                    if (chrSize == 1) {
-                        if (isControl(_lchar)) {
-                            throw JsonObjectException("control character", _pos - 1);
-                        }
+            // numbers and keywords end on the character after them, which has to be able to follow a value
+            if (pending && !stack.empty() && !isSpace(byte) && byte != ',' && byte != ']' && byte != '}' && byte != '"' && byte != ':') {
+                JSONMINI_THROW(JsonObjectException("unexpected character", pos - 1));
+            }
 
-                        if (!esc && _lchar == '"') {
-                            drop = true;
-                            break;
-                        }
-                        else if (esc) {
-                            if (_lchar == '\\' || _lchar == '"') str.push_back(_lchar);
-                            else if (_lchar == 'u') {
-                                // throw JsonException("unicode CC is not implemented", _pos - 1);
+            // closes finished containers until one has another element
+            value = nullptr;
 
-                                std::string hex;
+            while (!stack.empty() && !value) {
+                Frame& frame = stack.back();
+                char closeChar = (frame.isMap ? '}' : ']');
+                bool closed = false;
 
-                                while (stream.peek() != EOF && hex.size() < 4) {
-                                    stream.get(_lchar);
+                while (next()) {
+                    if (isSpace(byte)) continue;
 
-                                    if (!isHex(_lchar)) {
-                                        throw JsonObjectException("invalid unicode character escape sequence", _pos - 1);
-                                    }
+                    if (byte == ',') {
+                        if (frame.comma) JSONMINI_THROW(JsonObjectException("redundant comma", pos - 1));
+                        frame.comma = true;
+                        continue;
+                    }
 
-                                    hex.push_back(_lchar);
-                                }
+                    if (byte == closeChar) {
+                        closed = true;
+                        break;
+                    }
 
-                                if (hex.size() != 4) {
-                                    throw JsonObjectException("invalid unicode character escape sequence", _pos - 1);
-                                }
+                    if (!frame.comma) {
+                        JSONMINI_THROW(JsonObjectException("comma or closing bracket expected", pos - 1));
+                    }
 
-                                size_t seqSize;
-                                char seq[4];
-                                codeToByteSeq(std::stoi(hex, 0, 16), seqSize, seq);
+                    frame.comma = false;
+                    frame.size++;
 
-                                for (int i = 0; i < seqSize; i++) {
-                                    str.push_back(seq[i]);
-                                }
+                    if (!frame.isMap) {
+                        auto& arr = frame.container->_arr.mut();
+                        JSONMINI_STAT(allocations += (arr.size() == arr.capacity()));
 
-                                _pos += hex.size();
+                        pending = true;
+                        value = &arr.emplace_back();
+                        break;
+                    }
 
-                                esc = false;
-                                continue;
+                    if (frame.size > limits.maxKeys) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_TOO_MANY_KEYS), pos - 1));
+                    if (byte != '"') JSONMINI_THROW(JsonObjectException("string value expected", pos - 1));
 
-                            }
-                            else {
-                                auto sub = _INCC.find(_lchar);
+                    // keys are not counted as values
+                    readString(key);
 
-                                if (sub == _INCC.end()) throw JsonObjectException("illegal escape sequence", _pos);
+                    bool separated = false;
 
-                                str.push_back(sub->second);
-                            }
+                    while (next()) {
+                        if (isSpace(byte)) continue;
+                        if (byte != ':') JSONMINI_THROW(JsonObjectException("key separator expected", pos - 1));
 
-                            esc = false;
-                            continue;
-                        }
+                        separated = true;
+                        break;
                     }
 
-                    str.push_back(_lchar);
+                    if (!separated) JSONMINI_THROW(JsonObjectException("key separator expected", pos));
 
-                    for (size_t i = 1; i < chrSize; i++) {
-                        stream.get(_lchar);
-                        str.push_back(_lchar);
-                    }
+                    auto pair = frame.container->_map.mut().try_emplace(key);
+                    JSONMINI_STAT(allocations += pair.second + (pair.second && key.size() > _SSO_CAPACITY));
+
+                    // duplicate keys keep the last value
+                    value = &pair.first->second;
+                    value->reset();
+                    break;
                 }
 
-                if (!drop) throw JsonObjectException("unclosed string", begin - 1);
+                if (value) break;
 
-                _type = JSON_STRING;
-                _str = str;
-                _fin = true;
-                if (_pdepth == 1) continue;
-                else break;
+                if (!closed) JSONMINI_THROW(JsonObjectException("closing bracket expected", pos));
+                if (frame.comma && frame.size > 0) JSONMINI_THROW(JsonObjectException("redundant comma", pos - 1));
+
+                stack.pop_back();
             }
 
-            // array/map deserialization
-            if ((_lchar == '[' || _lchar == '{') && !_fin) {
-                char closeChar = (_lchar == '[' ? ']' : '}');
+            if (!value) break;
+        }
 
-                bool isMap = (closeChar == '}'),
-                    closed = false,
-                    comma = true,
-                    valExp = true;
+        // only whitespace may follow the document
+        while (next()) {
+            if (utf8CharSize(byte) == 0) JSONMINI_THROW(JsonObjectException("invalid utf-8 byte (data corruption)", pos - 1));
+            if (!isSpace(byte)) JSONMINI_THROW(JsonObjectException("character is not allowed here", pos - 1));
+        }
+    }
 
-                while (stream.peek() != EOF) {
-                    stream.get(_lchar);
-                    _pos++;
+    // serialization function
+    void JsonObject::operator >>(std::ostream& stream) {
+        JSONMINI_STAT_PHASE(JSON_PHASE_SERIALIZE);
+        JsonWriter writer(stream, _style);
 
-                    if (std::isspace(_lchar)) continue;
+        // formatting settings of the serialized object apply to the whole tree
+        write(writer, 1, _min, _ignoreNull, _cacheSerialized);
+    }
 
-                    if (_lchar == ',') {
-                        if (comma) throw JsonObjectException("redundant comma", _pos - 1);
-                        comma = true;
-                        continue;
-                    }
+    JsonObject::JsonObject(JsonType type) {
+        _type = type;
+    };
 
-                    if (_lchar == closeChar) {
-                        closed = true;
-                        drop = true;
-                        break;
-                    }
+    void JsonObject::reset() {
+        touch();
 
-                    if (!comma) {
-                        throw JsonObjectException("comma or closing bracket expected", _pos - 1);
-                    }
+        _type = JSON_NULL;
+        _map.reset();
+        _arr.reset();
+        _packed.reset();
+        _str.clear();
+        _num = 0;
+        _long = 0;
+        _realNum = false;
+        _bool = false;
+    }
 
-                    JsonObject key(_pdepth + 1, _pos, _lchar);
+    void JsonObject::touch() {
+        _hash = 0;
+        _serialized.reset();
+    }
 
-                    if (isMap) {
-                        key << stream;
+    // packed items become nodes, the array is generic from then on
+    void JsonObject::unpack() {
+        if (!_packed.isSet()) return;
 
-                        if (!key.isString()) throw JsonObjectException("string value expected", _pos - 1);
+        const Packed& packed = _packed.get();
+        auto& arr = _arr.mut();
 
-                        _pos = key._pos;
-                        _lchar = key._lchar;
+        arr.reserve(arr.size() + packed.integers.size() + packed.reals.size());
 
-                        while (stream.peek() != EOF) {
-                            stream.get(_lchar);
-                            _pos++;
-                            if (std::isspace(_lchar)) continue;
-                            if (_lchar == ':') break;
+        for (long item : packed.integers) arr.emplace_back(item);
+        for (double item : packed.reals) arr.emplace_back(item);
 
-                            throw JsonObjectException("key separator expected", _pos - 1);
-                        }
+        _packed.reset();
+    }
 
-                        stream.get(_lchar);
-                        _pos++;
+    JsonObject JsonObject::itemAt(size_t index) const {
+        if (!isArray() || index >= size()) JSONMINI_THROW(JsonObjectException("index out of range"));
+        if (!_packed.isSet()) return _arr.get()[index];
 
-                        if (_lchar == EOF || _lchar == '}') throw JsonObjectException("value expected", _pos - 1);
-                    }
+        const Packed& packed = _packed.get();
+        return packed.real ? JsonObject(packed.reals[index]) : JsonObject(packed.integers[index]);
+    }
 
-                    JsonObject value(_pdepth + 1, _pos, _lchar);
-                    value << stream;
+    // moves child containers out of containers nobody else shares
+    void JsonObject::releaseNested(std::vector<JsonObject>& released) {
+        if (_arr.isSet() && !_arr.isShared()) {
+            for (auto& item : _arr.mut()) {
+                if (item._arr.isSet() || item._map.isSet()) released.push_back(std::move(item));
+            }
+        }
 
-                    _pos = value._pos;
+        if (_map.isSet() && !_map.isShared()) {
+            for (auto& pair : _map.mut()) {
+                if (pair.second._arr.isSet() || pair.second._map.isSet()) released.push_back(std::move(pair.second));
+            }
+        }
+    }
 
-                    // auto _lchar initialization
-                    _lchar = value._lchar;
+    bool JsonObject::equals(const JsonObject& other) const {
+        if (this == &other) return true;
+        if (_type != other._type) return false;
 
-                    value._pdepth = 1;
-                    value._lchar = '\0';
-                    value._pos = 0;
-                    value._fin = false;
+        // cached hashes rule out most mismatches without walking the subtrees
+        if (_hash != 0 && other._hash != 0 && _hash != other._hash) return false;
 
-                    if (isMap) _map[key.str()] = value;
-                    else _arr.push_back(value);
+        switch (_type) {
+            case JSON_NUMBER:
+            {
+                if (_realNum && other._realNum) return _num == other._num;
+                if (!_realNum && !other._realNum) return _long == other._long;
 
-                    comma = false;
+                long a, b;
+                return integralValue(_num, _long, _realNum, a) && integralValue(other._num, other._long, other._realNum, b) && a == b;
+            }
+            case JSON_BOOLEAN:
+                return _bool == other._bool;
+            case JSON_STRING:
+                return _str == other._str;
+            case JSON_ARRAY:
+            {
+                if (_arr.sameAs(other._arr) && _packed.sameAs(other._packed)) return true;
+                if (size() != other.size()) return false;
 
-                    if (_lchar == closeChar && !value.isArray() && !value.isMap()) {
-                        closed = true;
-                        drop = true;
-                        break;
+                if (_packed.isSet() || other._packed.isSet()) {
+                    const Packed& p = _packed.get();
+                    const Packed& q = other._packed.get();
+
+                    if (_packed.isSet() && other._packed.isSet() && p.real == q.real) {
+                        return p.real ? p.reals == q.reals : p.integers == q.integers;
                     }
 
-                    if (_lchar == ',') {
-                        comma = true;
+                    for (size_t i = 0; i < size(); i++) {
+                        if (!itemAt(i).equals(other.itemAt(i))) return false;
                     }
+
+                    return true;
                 }
 
-                const size_t size = isMap ? _map.size() : _arr.size();
+                const auto& a = _arr.get();
+                const auto& b = other._arr.get();
 
-                if (!closed) throw JsonObjectException("closing bracket expected", _pos);
-                if (comma && size > 0) throw JsonObjectException("redundant comma", _pos - 1);
+                for (size_t i = 0; i < a.size(); i++) {
+                    if (!a[i].equals(b[i])) return false;
+                }
 
-                _type = (isMap ? JSON_MAP : JSON_ARRAY);
-                _fin = true;
-                if (_pdepth == 1) continue;
-                else break;
+                return true;
             }
+            case JSON_MAP:
+            {
+                if (_map.sameAs(other._map)) return true;
 
-            throw JsonObjectException("character is not allowed here", _pos - 1);
-        }
+                const auto& a = _map.get();
+                const auto& b = other._map.get();
 
-        if (_pdepth == 1) {
-            _pdepth = 1;
-            _lchar = '\0';
-            _pos = 0;
-            _fin = false;
-        }
+                if (a.size() != b.size()) return false;
 
-        if (_fin && drop) {
-            auto exception = JsonObjectException("unexpected character", _pos - 1);
+                for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+                    if (i->first != j->first || !i->second.equals(j->second)) return false;
+                }
 
-            if (!std::isspace(_lchar) && _lchar != ',' && _lchar != ']' && _lchar != '}' && _lchar != '"' && _lchar != ':') {
-                throw exception;
+                return true;
             }
+            default:
+                return true;
         }
     }
 
-    // serialization function
-    void JsonObject::operator >>(std::ostream& stream) {
-        if (_fdepth == 0) throw JsonObjectException("initial depth must not be equal to 0");
+    void JsonObject::assignValue(const JsonObject& value) {
+        // formatting settings of the target are kept
+        _type = value._type;
+        _map = value._map;
+        _arr = value._arr;
+        _packed = value._packed;
+        _str = value._str;
+        _num = value._num;
+        _long = value._long;
+        _realNum = value._realNum;
+        _bool = value._bool;
+        _hash = value._hash;
+        _serialized = value._serialized;
+    }
 
-        switch (_type) {
-            case JSON_NULL:
-                stream << "null";
-            break;
-            case JSON_NUMBER:
-            {
-                std::stringstream ss;
+    void JsonObject::assignValue(JsonObject&& value) {
+        _type = value._type;
+        _map = std::move(value._map);
+        _arr = std::move(value._arr);
+        _packed = std::move(value._packed);
+        _str = std::move(value._str);
+        _num = value._num;
+        _long = value._long;
+        _realNum = value._realNum;
+        _bool = value._bool;
+        _hash = value._hash;
+        _serialized = value._serialized;
+    }
 
-                if (_realNum) {
-                    ss << std::setprecision(15) << _num;
-                }
-                else {
-                    ss << std::setprecision(19) << (long)_num;
-                }
+    // maps being merged are kept on an explicit stack, nesting costs no call stack
+    void JsonObject::mergeNode(const JsonObject& patch) {
+        std::vector<std::pair<JsonObject*, const JsonObject*>> stack{ { this, &patch } };
+
+        while (!stack.empty()) {
+            JsonObject* target = stack.back().first;
+            const JsonObject* source = stack.back().second;
+            stack.pop_back();
 
-                stream << ss.str();
+            if (!source->isMap()) {
+                target->assignValue(*source);
+                continue;
             }
-            break;
-            case JSON_BOOLEAN:
-                stream << (_bool ? "true" : "false");
-            break;
-            case JSON_STRING:
-                stream << '"';
 
-                for (auto b : _str) {
-                    size_t charSize = utf8CharSize(b);
+            if (!target->isMap()) {
+                target->reset();
+                target->_type = JSON_MAP;
+            }
+
+            target->touch();
+
+            if (source->_map.get().empty()) continue;
+
+            auto& map = target->_map.mut();
 
-                    if (charSize != 1) {
-                        stream << b;
+            for (auto& pair : source->_map.get()) {
+                if (pair.second.isNull()) {
+                    map.erase(pair.first);
+                    continue;
+                }
+
+                auto iter = map.lower_bound(pair.first);
+
+                if (iter == map.end() || iter->first != pair.first) {
+                    // new members are shared with the patch unless nested nulls have to be dropped
+                    if (!pair.second.hasNullMembers()) {
+                        map.emplace_hint(iter, pair.first, pair.second);
                         continue;
                     }
 
-                    auto pair = _OUTCC.find(b);
+                    iter = map.emplace_hint(iter, pair.first, JsonObject());
+                }
+
+                stack.emplace_back(&iter->second, &pair.second);
+            }
+        }
+    }
+
+    void JsonObject::mergeNode(JsonObject&& patch) {
+        std::vector<std::pair<JsonObject*, JsonObject>> stack;
+        stack.emplace_back(this, std::move(patch));
 
-                    if (pair != _OUTCC.end()) {
-                        stream << pair->second;
+        while (!stack.empty()) {
+            JsonObject* target = stack.back().first;
+            JsonObject source = std::move(stack.back().second);
+            stack.pop_back();
+
+            if (!source.isMap()) {
+                target->assignValue(std::move(source));
+                continue;
+            }
+
+            // nodes of a map shared with other objects cannot be taken over
+            if (source._map.isShared()) {
+                target->mergeNode((const JsonObject&)source);
+                continue;
+            }
+
+            if (!target->isMap()) {
+                target->reset();
+                target->_type = JSON_MAP;
+            }
+
+            target->touch();
+
+            if (source._map.get().empty()) continue;
+
+            auto& members = source._map.mut();
+            auto& map = target->_map.mut();
+
+            while (!members.empty()) {
+                auto node = members.extract(members.begin());
+
+                if (node.mapped().isNull()) {
+                    map.erase(node.key());
+                    continue;
+                }
+
+                auto iter = map.find(node.key());
+
+                if (iter == map.end()) {
+                    if (!node.mapped().hasNullMembers()) {
+                        map.insert(std::move(node));
                         continue;
                     }
 
-                    if (b > 0x00 && b <= 0x1b) {
-                        throw JsonObjectException("unsupported control character");
-                    }
+                    JsonObject value = std::move(node.mapped());
+                    node.mapped() = JsonObject();
+                    iter = map.insert(std::move(node)).position;
+                    stack.emplace_back(&iter->second, std::move(value));
+                    continue;
+                }
+
+                stack.emplace_back(&iter->second, std::move(node.mapped()));
+            }
+        }
+    }
 
-                    stream << b;
+    // maps of the patch being merged are kept on an explicit stack, nesting costs no call stack
+    bool JsonObject::mergeRead(JsonReader& reader) {
+        struct Frame {
+            std::map<std::string, JsonObject>* map;
+            bool first;
+        };
+
+        std::vector<Frame> stack;
+        std::string_view key;
+        std::string name;
+        JsonObject* value = this;
+        JsonType type;
+
+        while (true) {
+            if (!reader.peekType(type)) return false;
+
+            if (type != JSON_MAP) {
+                value->reset();
+                if (!value->read(reader)) return false;
+            }
+            else {
+                if (!value->isMap()) {
+                    value->reset();
+                    value->_type = JSON_MAP;
                 }
 
-                stream << '"';
-            break;
-            case JSON_MAP:
-            case JSON_ARRAY:
-            {
-                bool isMap = (_type == JSON_MAP);
-                size_t size = (isMap ? _map.size() : _arr.size());
-                size_t keyc = 0;
+                value->touch();
+                if (!reader.beginMap()) return false;
+
+                stack.push_back(Frame{ &value->_map.mut(), true });
+            }
+
+            // the next member to merge, finished maps are closed on the way
+            value = nullptr;
 
-                size_t outSize = _map.size();
-                bool hasNewLine = false;
+            while (!stack.empty() && !value) {
+                Frame& frame = stack.back();
 
-                stream << (isMap ? '{' : '[');
+                if (!reader.nextMember(frame.first)) {
+                    if (reader.failed()) return false;
 
-                if (!_min && !isMap && !_arr.empty()) {
-                    stream << '\n';
+                    stack.pop_back();
+                    continue;
                 }
 
-                auto arrIter = _arr.begin();
-                auto mapIter = _map.begin();
+                if (!reader.readKey(key)) return false;
+                if (!reader.peekType(type)) return false;
 
-                for (size_t i = 0; i < size; i++) {
-                    const std::string* key = 0;
-                    JsonObject* value = 0;
+                // the lookup key reuses one buffer, only new members allocate
+                name.assign(key.data(), key.size());
 
-                    if (isMap) {
-                        key = &mapIter->first;
-                        value = &mapIter->second;
+                if (type == JSON_NULL) {
+                    if (!reader.readNull()) return false;
 
-                        if (value->isNull() && _ignoreNull) {
-                            outSize--;
-                            mapIter++;
-                            continue;
-                        }
+                    frame.map->erase(name);
+                    continue;
+                }
 
-                        if (keyc > 0) {
-                            stream << ",";
-                            if (!_min) stream << '\n';
-                        }
+                auto iter = frame.map->lower_bound(name);
 
-                        if (!hasNewLine && !_min) {
-                            hasNewLine = true;
-                            stream << '\n';
-                        }
+                if (iter == frame.map->end() || iter->first != name) {
+                    iter = frame.map->emplace_hint(iter, name, JsonObject());
+                }
 
-                        if (!_min) {
-                            fillDepth(stream, _fdepth);
-                        }
+                value = &iter->second;
+            }
 
-                        JsonObject(*key) >> stream;
+            if (!value) return !reader.failed();
+        }
+    }
 
-                        stream << ":";
-                        if (!_min) stream << " ";
+    bool JsonObject::hasNullMembers() const {
+        if (!isMap()) return false;
+
+        std::vector<const JsonObject*> stack{ this };
+
+        while (!stack.empty()) {
+            const JsonObject* map = stack.back();
+            stack.pop_back();
+
+            for (auto& pair : map->_map.get()) {
+                if (pair.second.isNull()) return true;
+                if (pair.second.isMap()) stack.push_back(&pair.second);
+            }
+        }
+
+        return false;
+    }
 
-                        mapIter++;
-                        keyc++;
+    // containers being filled are kept on an explicit stack, like in the stream parser
+    bool JsonObject::read(JsonReader& reader) {
+        struct Frame {
+            std::map<std::string, JsonObject>* map;
+            std::vector<JsonObject>* arr;
+            size_t members;
+            bool first;
+        };
+
+        std::vector<Frame> stack;
+        std::string_view key;
+        JsonObject* value = this;
+
+        while (true) {
+            if (!reader.peekType(value->_type)) return false;
+
+            switch (value->_type) {
+                case JSON_MAP:
+                    if (!reader.beginMap()) return false;
+
+                    JSONMINI_STAT(allocations++);
+                    stack.push_back(Frame{ &value->_map.mut(), nullptr, 0, true });
+                break;
+                case JSON_ARRAY:
+                {
+                    if (!reader.beginArray()) return false;
+
+                    bool first = true;
+                    JsonObject* item = nullptr;
+
+                    // leading numbers are packed, the array only gets nodes once an item of another kind comes
+                    if (reader.limits().packNumbers) {
+                        if (!value->readNumbers(reader, first, item)) return false;
+                        if (!value->_arr.isSet()) break;
                     }
-                    else {
-                        value = &*arrIter;
-                        arrIter++;
 
-                        if (i > 0) {
-                            stream << ",";
-                            if (!_min) stream << '\n';
-                        }
+                    JSONMINI_STAT(allocations++);
+                    stack.push_back(Frame{ nullptr, &value->_arr.mut(), 0, first });
 
-                        if (!_min) {
-                            fillDepth(stream, _fdepth);
-                        }
+                    if (item) {
+                        value = item;
+                        continue;
                     }
+                }
+                break;
+                case JSON_STRING:
+                {
+                    bool read = reader.readString(value->_str);
+                    JSONMINI_STAT(allocations += (value->_str.capacity() > _SSO_CAPACITY));
+                    if (!read) return false;
+                }
+                break;
+                case JSON_NUMBER:
+                    if (!reader.readNumber(value->_num, value->_long, value->_realNum)) return false;
+                break;
+                case JSON_BOOLEAN:
+                    if (!reader.readBoolean(value->_bool)) return false;
+                break;
+                default:
+                    if (!reader.readNull()) return false;
+                break;
+            }
+
+            // closes finished containers until one has another element
+            value = nullptr;
+
+            while (!stack.empty()) {
+                Frame& frame = stack.back();
 
-                    auto& obj = *value;
+                if (frame.map && reader.nextMember(frame.first)) {
+                    if (!reader.checkKeys(++frame.members) || !reader.readKey(key)) return false;
 
-                    bool min = obj._min,
-                        ignore = obj._ignoreNull;
+                    auto pair = frame.map->try_emplace(std::string(key));
 
-                    obj._min = _min;
-                    obj._ignoreNull = _ignoreNull;
-                    obj._fdepth = _fdepth + 1;
+                    JSONMINI_STAT(allocations += pair.second + (pair.second && key.size() > _SSO_CAPACITY));
 
-                    obj >> stream;
+                    // duplicate keys keep the last value
+                    if (!pair.second) pair.first->second.reset();
 
-                    obj._fdepth = 1;
-                    obj._min = min;
-                    obj._ignoreNull = ignore;
+                    value = &pair.first->second;
+                    break;
+                }
+
+                if (frame.arr && reader.nextItem(frame.first)) {
+                    JSONMINI_STAT(allocations += (frame.arr->size() == frame.arr->capacity()));
+                    value = &frame.arr->emplace_back();
+                    break;
                 }
 
-                if (isMap) {
-                    if (!_min && outSize != 0) {
-                        stream << "\n";
-                        fillDepth(stream, _fdepth - 1);
+                if (reader.failed()) return false;
+
+                stack.pop_back();
+            }
+
+            if (!value) return true;
+        }
+    }
+
+    // item is set to the slot of an item that is not a number, the array is unpacked by then
+    bool JsonObject::readNumbers(JsonReader& reader, bool& first, JsonObject*& item) {
+        Packed* packed = nullptr;
+        JsonType type;
+        double num;
+        long integer;
+        bool real;
+
+        while (reader.nextItem(first)) {
+            if (!reader.peekType(type)) return false;
+
+            if (type != JSON_NUMBER) {
+                unpack();
+                item = &_arr.mut().emplace_back();
+                return true;
+            }
+
+            if (!reader.readNumber(num, integer, real)) return false;
+
+            // a number of the other kind ends packing too, as does "-0", an integer whose number() is -0.0
+            if ((packed && real != packed->real) || (!real && integer == 0 && std::signbit(num))) {
+                unpack();
+
+                JsonObject& node = _arr.mut().emplace_back();
+                node._type = JSON_NUMBER;
+                node._num = num;
+                node._long = integer;
+                node._realNum = real;
+                return true;
+            }
+
+            if (!packed) {
+                JSONMINI_STAT(allocations++);
+                packed = &_packed.mut();
+                packed->real = real;
+            }
+
+            if (real) {
+                JSONMINI_STAT(allocations += (packed->reals.size() == packed->reals.capacity()));
+                packed->reals.push_back(num);
+            }
+            else {
+                JSONMINI_STAT(allocations += (packed->integers.size() == packed->integers.capacity()));
+                packed->integers.push_back(integer);
+            }
+        }
+
+        return !reader.failed();
+    }
+
+    // containers being written are kept on an explicit stack, depth is the indentation of their elements;
+    // with cache set, containers written before with the same settings are copied and the others are kept,
+    // parts collects the cached containers met inside of the open ones
+    void JsonObject::write(JsonWriter& writer, unsigned int depth, bool min, bool ignoreNull, bool cache) const {
+        struct Frame {
+            const JsonObject* container;
+            std::map<std::string, JsonObject>::const_iterator member;
+            size_t index;
+            unsigned int depth;
+            bool compact;
+            bool empty;
+            // where the container starts in the output and where its parts start, while it is being cached
+            size_t mark;
+            size_t firstPart;
+        };
+
+        std::vector<Frame> stack;
+        std::vector<SerializedPart> parts;
+        const JsonObject* value = this;
+
+        while (true) {
+            JSONMINI_STAT(nodes[value->_type]++);
+
+            const Serialized* serialized = cache ? value->serializedFor(writer.style(), depth, min, ignoreNull) : nullptr;
+
+            if (serialized) {
+                size_t mark = writer.mark();
+
+                writeSerialized(writer, *serialized);
+                parts.push_back(SerializedPart{ mark, value->_serialized });
+                writer.release();
+            }
+            else switch (value->_type) {
+                case JSON_NULL:
+                    writer.writeNull();
+                break;
+                case JSON_NUMBER:
+                    if (value->_realNum) writer.writeNumber(value->_num, true);
+                    else writer.writeInteger(value->_long);
+                break;
+                case JSON_BOOLEAN:
+                    writer.writeBoolean(value->_bool);
+                break;
+                case JSON_STRING:
+                    writer.writeString(value->_str);
+                break;
+                case JSON_MAP:
+                    JSONMINI_STAT(reach(depth));
+                    stack.push_back(Frame{ value, value->_map.get().begin(), 0, depth, false, true, cache ? writer.mark() : 0, parts.size() });
+                    writer.put('{');
+                break;
+                case JSON_ARRAY:
+                    JSONMINI_STAT(reach(depth));
+
+                    // packed items are formatted in one go, there is no frame to come back to
+                    if (value->_packed.isSet()) {
+                        size_t mark = cache ? writer.mark() : 0;
+
+                        value->writePacked(writer, depth, min);
+                        if (cache) value->keepSerialized(writer, mark, parts, parts.size(), depth, min, ignoreNull);
+                        break;
+                    }
+
+                    stack.push_back(Frame{ value, {}, 0, depth, !min && value->isCompactArray(writer.style()), true,
+                        cache ? writer.mark() : 0, parts.size() });
+                    writer.put('[');
+                break;
+            }
+
+            // closes finished containers until one has another element
+            value = nullptr;
+
+            while (!stack.empty()) {
+                Frame& frame = stack.back();
+
+                writer.sync();
+
+                if (frame.container->_type == JSON_MAP) {
+                    const auto& map = frame.container->_map.get();
+
+                    while (ignoreNull && frame.member != map.end() && frame.member->second.isNull()) ++frame.member;
+
+                    if (frame.member != map.end()) {
+                        if (!frame.empty) writer.put(',');
+                        frame.empty = false;
+
+                        if (!min) writer.writeNewLine(frame.depth);
+
+                        writer.writeString(frame.member->first);
+
+                        if (min) writer.put(':');
+                        else writer.writeRaw(": ", 2);
+
+                        value = &frame.member->second;
+                        ++frame.member;
+                        break;
                     }
+
+                    if (!min && !frame.empty) writer.writeNewLine(frame.depth - 1);
+
+                    writer.put('}');
                 }
                 else {
-                    if (!_min && !_arr.empty()) {
-                        stream << "\n";
-                        fillDepth(stream, _fdepth - 1);
+                    const auto& arr = frame.container->_arr.get();
+
+                    if (frame.index < arr.size()) {
+                        if (frame.index > 0) {
+                            if (frame.compact) writer.writeRaw(", ", 2);
+                            else writer.put(',');
+                        }
+
+                        if (!min && !frame.compact) writer.writeNewLine(frame.depth);
+
+                        value = &arr[frame.index++];
+                        break;
                     }
+
+                    if (!min && !frame.compact && !arr.empty()) writer.writeNewLine(frame.depth - 1);
+
+                    writer.put(']');
                 }
 
-                stream << (isMap ? '}' : ']');
+                if (cache) frame.container->keepSerialized(writer, frame.mark, parts, frame.firstPart, frame.depth, min, ignoreNull);
+
+                stack.pop_back();
             }
-            break;
+
+            if (!value) return;
+
+            depth = stack.back().depth + 1;
         }
     }
 
-    JsonObject::JsonObject(JsonType type) {
-        _type = type;
-    };
+    void JsonObject::writePacked(JsonWriter& writer, unsigned int depth, bool min) const {
+        const Packed& packed = _packed.get();
+        size_t count = size();
+        bool compact = !min && isCompactArray(writer.style());
+
+        JSONMINI_STAT(nodes[JSON_NUMBER] += count);
+
+        writer.put('[');
+
+        if (!min && !compact && count > 0) writer.writeNewLine(depth);
+
+        if (packed.real) writer.writeReals(packed.reals.data(), count, min, compact, depth);
+        else writer.writeIntegers(packed.integers.data(), count, min, compact, depth);
+
+        if (!min && !compact && count > 0) writer.writeNewLine(depth - 1);
+
+        writer.put(']');
+    }
+
+    // the output since mark is kept with the settings it was written with, short of the parts from firstPart on:
+    // those are referred to and replaced by this container, so no byte is copied twice however deep the tree is
+    void JsonObject::keepSerialized(JsonWriter& writer, size_t mark, std::vector<SerializedPart>& parts, size_t firstPart,
+        unsigned int depth, bool min, bool ignoreNull) const {
+        std::string_view out = writer.since(mark);
+        writer.release();
+
+        // short output is cheaper to write again than to keep, nothing inside of it was kept either
+        if (out.size() < CACHE_MIN_SIZE) return;
+
+        auto serialized = std::make_shared<Serialized>(Serialized{ std::string(), {}, out.size(), writer.style(), min ? 0 : depth, min, ignoreNull });
+        size_t pos = 0;
+
+        serialized->parts.reserve(parts.size() - firstPart);
+
+        for (size_t i = firstPart; i < parts.size(); i++) {
+            size_t at = parts[i].offset - mark;
+
+            serialized->bytes.append(out.substr(pos, at - pos));
+            serialized->parts.emplace_back(serialized->bytes.size(), std::move(parts[i].serialized));
+            pos = at + serialized->parts.back().second->size;
+        }
+
+        serialized->bytes.append(out.substr(pos));
+
+        parts.resize(firstPart);
+        parts.push_back(SerializedPart{ mark, serialized });
+        _serialized = std::move(serialized);
+    }
+
+    // cached parts are nested as deep as the containers they come from, they are walked on an explicit stack
+    void JsonObject::writeSerialized(JsonWriter& writer, const Serialized& serialized) {
+        struct Frame {
+            const Serialized* serialized;
+            size_t part;
+            size_t pos;
+        };
+
+        std::vector<Frame> stack;
+        stack.push_back(Frame{ &serialized, 0, 0 });
+
+        while (!stack.empty()) {
+            Frame& frame = stack.back();
+            const Serialized* current = frame.serialized;
+
+            if (frame.part == current->parts.size()) {
+                writer.writeRaw(current->bytes.data() + frame.pos, current->bytes.size() - frame.pos);
+                stack.pop_back();
+                continue;
+            }
+
+            const auto& part = current->parts[frame.part++];
 
-    JsonObject::JsonObject(unsigned int pdepth, size_t pos, char lchar) {
-        _pdepth = pdepth;
-        _pos = pos;
-        _lchar = lchar;
+            writer.writeRaw(current->bytes.data() + frame.pos, part.first - frame.pos);
+            frame.pos = part.first;
+            stack.push_back(Frame{ part.second.get(), 0, 0 });
+        }
     }
 
-    void JsonObject::fillDepth(std::ostream& stream, unsigned int depth) {
-        for (unsigned int i = 0; i < depth; i++) {
-            stream << '\t';
+    const JsonObject::Serialized* JsonObject::serializedFor(const JsonStyle& style, unsigned int depth, bool min, bool ignoreNull) const {
+        const Serialized* serialized = _serialized.get();
+
+        // indentation only matters to pretty output
+        if (!serialized || serialized->min != min || serialized->ignoreNull != ignoreNull) return nullptr;
+        if (!min && (serialized->depth != depth || serialized->style.indentChar != style.indentChar ||
+            serialized->style.indentWidth != style.indentWidth ||
+            serialized->style.compactArrayThreshold != style.compactArrayThreshold)) return nullptr;
+
+        return serialized;
+    }
+
+    bool JsonObject::isCompactArray(const JsonStyle& style) const {
+        if (size() > style.compactArrayThreshold) return false;
+
+        for (auto& item : _arr.get()) {
+            if (item.isMap() || item.isArray()) return false;
+        }
+
+        return true;
+    }
+
+    // red-black tree node links and color of a std::map entry
+    static const size_t _MAP_NODE_HEADER = 4 * sizeof(void*);
+
+    // typical malloc chunk header and alignment loss per allocation
+    static const size_t _ALLOC_OVERHEAD = 16;
+
+    // reference counts and vtable pointer of a make_shared block
+    static const size_t _SHARED_HEADER = 2 * sizeof(int) + sizeof(void*);
+
+    void JsonObject::addFootprint(JsonFootprint& fp) const {
+        fp.nodes++;
+        fp.nodeBytes += sizeof(JsonObject);
+
+        addStringFootprint(_str, fp);
+
+        // like containers, cached output shared by copies is counted once per owner
+        if (_serialized) {
+            const std::string& bytes = _serialized->bytes;
+            const char* object = (const char*)&bytes;
+
+            fp.allocations++;
+            fp.overheadBytes += _ALLOC_OVERHEAD;
+            fp.cacheBytes += _SHARED_HEADER + sizeof(Serialized);
+
+            if (bytes.data() < object || bytes.data() >= object + sizeof(std::string)) {
+                fp.allocations++;
+                fp.overheadBytes += _ALLOC_OVERHEAD;
+                fp.cacheBytes += bytes.capacity() + 1;
+            }
+
+            // the parts themselves belong to the containers they were written for
+            if (_serialized->parts.capacity() > 0) {
+                fp.allocations++;
+                fp.overheadBytes += _ALLOC_OVERHEAD;
+                fp.cacheBytes += _serialized->parts.capacity() * sizeof(_serialized->parts[0]);
+            }
+        }
+
+        // shared containers are counted once per owner
+        if (_arr.isSet()) {
+            addSharedFootprint(sizeof(std::vector<JsonObject>), fp);
+        }
+
+        if (_map.isSet()) {
+            addSharedFootprint(sizeof(std::map<std::string, JsonObject>), fp);
+        }
+
+        // packed items are a buffer of the container, not nodes
+        if (_packed.isSet()) {
+            const Packed& packed = _packed.get();
+            size_t capacity = packed.integers.capacity() * sizeof(long) + packed.reals.capacity() * sizeof(double);
+            size_t spare = capacity - packed.integers.size() * sizeof(long) - packed.reals.size() * sizeof(double);
+
+            addSharedFootprint(sizeof(Packed), fp);
+
+            if (capacity > 0) {
+                fp.allocations++;
+                fp.overheadBytes += _ALLOC_OVERHEAD;
+                fp.containerBytes += capacity;
+                fp.slackBytes += spare;
+            }
+        }
+
+        const auto& arr = _arr.get();
+
+        if (arr.capacity() > 0) {
+            size_t spare = (arr.capacity() - arr.size()) * sizeof(JsonObject);
+
+            fp.allocations++;
+            fp.overheadBytes += _ALLOC_OVERHEAD;
+            fp.containerBytes += spare;
+            fp.slackBytes += spare;
         }
+
+        for (auto& item : arr) {
+            item.addFootprint(fp);
+        }
+
+        for (auto& pair : _map.get()) {
+            fp.allocations++;
+            fp.overheadBytes += _ALLOC_OVERHEAD;
+            fp.containerBytes += _MAP_NODE_HEADER + sizeof(std::string);
+
+            addStringFootprint(pair.first, fp);
+            pair.second.addFootprint(fp);
+        }
+    }
+
+    void JsonObject::addSharedFootprint(size_t size, JsonFootprint& fp) {
+        fp.allocations++;
+        fp.overheadBytes += _ALLOC_OVERHEAD;
+        fp.containerBytes += _SHARED_HEADER + size;
+    }
+
+    void JsonObject::addStringFootprint(const std::string& str, JsonFootprint& fp) {
+        const char* object = (const char*)&str;
+
+        // short strings live inside of the object itself
+        if (str.data() >= object && str.data() < object + sizeof(std::string)) return;
+
+        fp.allocations++;
+        fp.overheadBytes += _ALLOC_OVERHEAD;
+        fp.stringBytes += str.capacity() + 1;
+        fp.slackBytes += str.capacity() - str.size();
+    }
+
+    void JsonObject::checkStreamBytes(size_t pos, const JsonLimits& limits) {
+        if (pos > limits.maxBytes) JSONMINI_THROW(JsonObjectException(errorMessage(JSON_ERROR_INPUT_TOO_LARGE), limits.maxBytes));
     }
 
     bool JsonObject::isDigit(char byte) {
         return byte >= '0' && byte <= '9';
     }
 
+    // only the four whitespace characters of the grammar, unlike std::isspace
+    bool JsonObject::isSpace(char byte) {
+        return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r';
+    }
+
     bool JsonObject::isControl(char signedByte) {
         unsigned char byte = signedByte;
         return (byte <= 0x1f) || (byte >= 0x80 && byte <= 0x9f);
     }
 
-    bool JsonObject::isHex(char byte) {
-        return (byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'f') || (byte >= 'A' && byte <= 'F');
-    }
-
     size_t JsonObject::utf8CharSize(char signedByte) {
         unsigned char byte = signedByte;
 
-        if ((byte >= 0x80 && byte <= 0xc0)) {
-            // invalid byte
+        if ((byte >= 0x80 && byte <= 0xc1) || byte >= 0xf5) {
+            // continuation, overlong lead or beyond U+10FFFF
             return 0;
         }
         if (byte >= 0xf0) {
@@ -770,37 +1850,4 @@ namespace jsonmini {
 
         return 1;
     }
-
-    void JsonObject::codeToByteSeq(int code, size_t& size, char* arr) {
-        if (code <= 0x7f) {
-            size = 1;
-            arr[0] = code;
-            return;
-        }
-
-        if (code <= 0x7ff) {
-            size = 2;
-            arr[0] = 0xc0 | (code >> 6);
-            arr[1] = 0x80 | (code & 0x3f);
-            return;
-        }
-
-        if (code <= 0xffff) {
-            size = 3;
-            arr[0] = 0xe0 | (code >> 12);
-            arr[1] = 0x80 | ((code >> 6) & 0x3f);
-            arr[2] = 0x80 | (code & 0x3f);
-            return;
-        }
-
-        if (code <= 0x10ffff) {
-            size = 4;
-
-            arr[0] = 0xf0 | (code >> 18);
-            arr[1] = 0x80 | ((code >> 12) & 0x3f);
-            arr[2] = 0x80 | ((code >> 6) & 0x3f);
-            arr[3] = 0x80 | (code & 0x3f);
-            return;
-        }
-    }
 }
@@ -4,11 +4,24 @@
 #include <cstddef>
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
+#include "jsonerror.hpp"
+#include "jsonfootprint.hpp"
+#include "jsonlimits.hpp"
+#include "jsonshared.hpp"
 #include "jsontype.hpp"
+#include "jsonwriter.hpp"
 
 namespace jsonmini {
+    class JsonReader;
+
     class JsonObject {
+        friend class JsonCbor;
+        friend class JsonImage;
+        friend class JsonParser;
+        friend class JsonQuery;
+        friend class JsonSchema;
     public:
         JsonObject();
         JsonObject(double value);
@@ -17,17 +30,60 @@ namespace jsonmini {
         JsonObject(const char* value);
         JsonObject(std::string value);
 
+        // nested containers owned by this object alone are released without recursion
+        ~JsonObject();
+        JsonObject(const JsonObject&) = default;
+        JsonObject(JsonObject&&) = default;
+        JsonObject& operator =(const JsonObject&) = default;
+        JsonObject& operator =(JsonObject&&) = default;
+
         static JsonObject makeMap();
         static JsonObject makeArray();
+        // arrays holding only integers or only reals can keep them in one buffer instead of one node per item;
+        // JsonObject::parse packs them with JsonLimits::packNumbers set, non-const access to the items as nodes unpacks the array first,
+        // const access only reads them: see itemAt, asLongs and asDoubles
+        static JsonObject makeArray(std::vector<long> values);
+        static JsonObject makeArray(std::vector<double> values);
         static JsonObject fromStr(std::string&);
 
+        // non-throwing deserialization, out is reset to null on failure
+        static JsonResult parse(const char* data, size_t size, JsonObject& out, const JsonLimits& limits = JsonLimits()) noexcept;
+        static JsonResult parse(const std::string& str, JsonObject& out, const JsonLimits& limits = JsonLimits()) noexcept;
+
+        // grammar and utf-8 checks only, no tree is built and nothing is allocated
+        static JsonResult validate(const char* data, size_t size, const JsonLimits& limits = JsonLimits()) noexcept;
+        static JsonResult validate(const std::string& str, const JsonLimits& limits = JsonLimits()) noexcept;
+
         void remove(size_t index);
+
+        // RFC 7386 merge patch applied in place, null members of the patch remove keys;
+        // an rvalue patch hands its map nodes over instead of copying them, nesting costs no call stack
+        void merge(const JsonObject& patch);
+        void merge(JsonObject&& patch);
+        // merges a patch straight from JSON text without building it, nothing changes if it is malformed
+        // or crosses one of the limits
+        JsonResult mergeFrom(const char* data, size_t size, const JsonLimits& limits = JsonLimits()) noexcept;
+        JsonResult mergeFrom(const std::string& str, const JsonLimits& limits = JsonLimits()) noexcept;
+
         void setMinificationEnabled(bool value);
         void setNullPropertyIgnoringEnabled(bool value);
+        void setStyle(const JsonStyle& style);
+        // operator >> keeps the bytes of every container it writes and copies them while the container is unchanged;
+        // changes reach the cache the way they reach the hash, through accessors called on the way from the root,
+        // so a reference into the tree must not be written through after the tree has been serialized.
+        // containers writing less than CACHE_MIN_SIZE bytes are kept inside of their parent's bytes, the others
+        // hold only what is between their cached children and point at those, each byte is kept once
+        void setSerializationCacheEnabled(bool value);
+        static const size_t CACHE_MIN_SIZE = 256;
         void clear();
         bool remove(std::string key);
         bool hasKey(std::string key);
+        // packs an array of numbers of one kind, false if it holds anything else
+        bool pack();
+        bool isPacked() const;
 
+        // non-const access detaches shared containers first, references taken
+        // before the object was copied must not be written through afterwards
         JsonObject& operator [](size_t index);
         JsonObject& operator [](std::string key);
 
@@ -39,6 +95,17 @@ namespace jsonmini {
 
         JsonType type() const;
 
+        // deep comparison, numbers compare by value so 1 and 1.0 are equal
+        bool operator ==(const JsonObject& other) const;
+        bool operator !=(const JsonObject& other) const;
+
+        // structural hash, cached per subtree until the subtree is accessed for writing
+        size_t hash() const;
+
+        // memory accounting for the tree rooted at this object
+        JsonFootprint footprint() const;
+        void shrinkToFit();
+
         size_t size() const;
 
         bool isArray() const;
@@ -48,17 +115,37 @@ namespace jsonmini {
         bool isBoolean() const;
         bool isNull() const;
 
-        std::string str();
-        bool boolean();
-        double number();
-        long numberLong();
+        std::string str() const;
+        bool boolean() const;
+        double number() const;
+        long numberLong() const;
 
         std::map<std::string, JsonObject>* map();
         std::vector<JsonObject>* vector();
 
+        // checked accessors, return null instead of throwing;
+        // the const ones return null for the items of a packed array as well, they are not nodes until unpacked
+        JsonObject* get(size_t index) noexcept;
+        const JsonObject* get(size_t index) const noexcept;
+        JsonObject* get(const std::string& key) noexcept;
+        const JsonObject* get(const std::string& key) const noexcept;
+        std::map<std::string, JsonObject>* asMap() noexcept;
+        const std::map<std::string, JsonObject>* asMap() const noexcept;
+        std::vector<JsonObject>* asVector() noexcept;
+        const std::vector<JsonObject>* asVector() const noexcept;
+        // items of a packed array, null if it is not packed or holds the other kind
+        std::vector<long>* asLongs() noexcept;
+        const std::vector<long>* asLongs() const noexcept;
+        std::vector<double>* asDoubles() noexcept;
+        const std::vector<double>* asDoubles() const noexcept;
+        // copy of an item, packed or not, without unpacking the array
+        JsonObject itemAt(size_t index) const;
+
         // deserialization function
         void operator <<(const char* jsonSt);
         void operator <<(std::istream& stream);
+        // stream deserialization under limits, throws at the byte where one was crossed
+        void readStream(std::istream& stream, const JsonLimits& limits);
 
         // serialization function
         void operator >>(std::ostream& stream);
@@ -69,33 +156,92 @@ namespace jsonmini {
         // formatting parameters
         bool _min = true;
         bool _ignoreNull = false;
-        unsigned int _fdepth = 1;
-
-        // serialization parameters
-        unsigned int _pdepth = 1;
-        char _lchar = '\0';
-        size_t _pos = 0;
-        bool _fin = false;
-
-        // possible values
-        std::map<std::string, JsonObject> _map;
-        std::vector<JsonObject> _arr;
+        bool _cacheSerialized = false;
+        JsonStyle _style;
+
+        // items of a packed array, _arr is unset while they are here
+        struct Packed {
+            std::vector<long> integers;
+            std::vector<double> reals;
+            bool real = false;
+        };
+
+        // possible values, containers are shared between copies until modified
+        JsonShared<std::map<std::string, JsonObject>> _map;
+        JsonShared<std::vector<JsonObject>> _arr;
+        JsonShared<Packed> _packed;
         std::string _str;
         double _num = 0;
+        long _long = 0;
         bool _realNum = false;
         bool _bool = false;
 
+        // 0 while not computed
+        mutable size_t _hash = 0;
+
+        // output of the last serialization of a container, with the settings it was written with;
+        // the output of the cached containers inside of it is left out of bytes, parts says where it goes
+        struct Serialized {
+            std::string bytes;
+            std::vector<std::pair<size_t, std::shared_ptr<const Serialized>>> parts;
+            size_t size;
+            JsonStyle style;
+            unsigned int depth;
+            bool min;
+            bool ignoreNull;
+        };
+
+        // null while not written, shared with copies and with the parts of cached parents
+        mutable std::shared_ptr<const Serialized> _serialized;
+
+        // cached container written inside of the one being cached, at an offset of the output
+        struct SerializedPart {
+            size_t offset;
+            std::shared_ptr<const Serialized> serialized;
+        };
+
         JsonObject(JsonType type);
-        JsonObject(unsigned int pdepth, size_t pos, char lchar);
+
+        void reset();
+        void touch();
+        void unpack();
+        void releaseNested(std::vector<JsonObject>& released);
+        void assignValue(const JsonObject& value);
+        void assignValue(JsonObject&& value);
+        void mergeNode(const JsonObject& patch);
+        void mergeNode(JsonObject&& patch);
+        bool mergeRead(JsonReader& reader);
+        bool hasNullMembers() const;
+        bool equals(const JsonObject& other) const;
+        bool read(JsonReader& reader);
+        bool readNumbers(JsonReader& reader, bool& first, JsonObject*& item);
+        void write(JsonWriter& writer, unsigned int depth, bool min, bool ignoreNull, bool cache) const;
+        void writePacked(JsonWriter& writer, unsigned int depth, bool min) const;
+        const Serialized* serializedFor(const JsonStyle& style, unsigned int depth, bool min, bool ignoreNull) const;
+        void keepSerialized(JsonWriter& writer, size_t mark, std::vector<SerializedPart>& parts, size_t firstPart,
+            unsigned int depth, bool min, bool ignoreNull) const;
+        static void writeSerialized(JsonWriter& writer, const Serialized& serialized);
+        bool isCompactArray(const JsonStyle& style) const;
+        void addFootprint(JsonFootprint& fp) const;
 
         // utility functions
-        static void fillDepth(std::ostream& stream, unsigned int depth);
+        // stream input has no known size, the byte limit is checked as it is consumed
+        static void checkStreamBytes(size_t pos, const JsonLimits& limits);
         static bool isDigit(char byte);
+        static bool isSpace(char byte);
         static bool isControl(char byte);
-        static bool isHex(char byte);
-        static void codeToByteSeq(int code, size_t& size, char* arr);
         static size_t utf8CharSize(char signedByte);
+        static size_t numberHash(double num, long integer, bool real);
+        static void addSharedFootprint(size_t size, JsonFootprint& fp);
+        static void addStringFootprint(const std::string& str, JsonFootprint& fp);
     };
 };
 
+namespace std {
+    template<>
+    struct hash<jsonmini::JsonObject> {
+        size_t operator ()(const jsonmini::JsonObject& obj) const { return obj.hash(); }
+    };
+}
+
 #endif
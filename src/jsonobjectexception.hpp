@@ -1,11 +1,22 @@
 #ifndef JSONOBJECTEXCEPTION_HPP
 #define JSONOBJECTEXCEPTION_HPP
 
+#include <cstdlib>
 #include <string>
 
+// builds without exception support abort where JsonObjectException would be thrown,
+// the non-throwing API (JsonObject::parse, get, asMap, asVector, tryDecode) stays usable
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define JSONMINI_THROW(exception) throw exception
+#else
+#define JSONMINI_THROW(exception) std::abort()
+#endif
+
 namespace jsonmini {
     class JsonObjectException : public std::exception {
         friend class JsonObject;
+        friend class JsonReader;
+        friend class JsonLiteralParser;
     private:
         const std::string _what;
         const size_t _pos = 0;
@@ -0,0 +1,203 @@
+#include "jsonparser.hpp"
+
+#include "jsonstats.hpp"
+
+namespace jsonmini {
+    JsonObject& JsonDocument::root() {
+        return _root;
+    }
+
+    const JsonObject& JsonDocument::root() const {
+        return _root;
+    }
+
+    size_t JsonDocument::spareMembers() const {
+        return _spareMembers.size();
+    }
+
+    size_t JsonDocument::spareValues() const {
+        return _spareValues.size();
+    }
+
+    void JsonDocument::clear() {
+        _root = JsonObject();
+        std::vector<Member>().swap(_spareMembers);
+        std::vector<JsonObject>().swap(_spareValues);
+    }
+
+    JsonParser::JsonParser(const JsonLimits& limits) : _reader(nullptr, 0, limits) { }
+
+    JsonResult JsonParser::parse(const char* data, size_t size, JsonDocument& doc) noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+
+        _reader.reset(data, size);
+
+        if (read(doc) && !_reader.atEnd()) {
+            _reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        if (_reader.failed()) {
+            _stack.clear();
+            doc._root.reset();
+        }
+
+        JSONMINI_STAT(bytesRead += _reader.pos());
+        return _reader.result();
+    }
+
+    JsonResult JsonParser::parse(const std::string& str, JsonDocument& doc) noexcept {
+        return parse(str.data(), str.size(), doc);
+    }
+
+    // same traversal as JsonObject::read, every value lands on storage of the previous parse if there is some
+    bool JsonParser::read(JsonDocument& doc) {
+        JsonObject* value = &doc._root;
+
+        while (true) {
+            JsonType type;
+
+            if (!_reader.peekType(type)) return false;
+
+            recycle(*value, type);
+
+            switch (type) {
+                case JSON_MAP:
+                    if (!_reader.beginMap()) return false;
+
+                    // a container still shared with a copy of an earlier tree is left to that copy
+                    if (value->_map.isShared()) value->_map.reset();
+                    if (!value->_map.isSet()) JSONMINI_STAT(allocations++);
+
+                    _stack.push_back(Frame{ value, {}, 0, true });
+                    _stack.back().previous.swap(value->_map.mut());
+                break;
+                case JSON_ARRAY:
+                    if (!_reader.beginArray()) return false;
+
+                    if (value->_arr.isShared()) value->_arr.reset();
+                    if (!value->_arr.isSet()) JSONMINI_STAT(allocations++);
+
+                    value->_arr.mut();
+                    _stack.push_back(Frame{ value, {}, 0, true });
+                break;
+                case JSON_STRING:
+                    if (!_reader.readString(value->_str)) return false;
+                break;
+                case JSON_NUMBER:
+                    if (!_reader.readNumber(value->_num, value->_long, value->_realNum)) return false;
+                break;
+                case JSON_BOOLEAN:
+                    if (!_reader.readBoolean(value->_bool)) return false;
+                break;
+                default:
+                    if (!_reader.readNull()) return false;
+                break;
+            }
+
+            // closes finished containers until one has another element
+            value = nullptr;
+
+            while (!_stack.empty()) {
+                Frame& frame = _stack.back();
+
+                value = frame.container->isMap() ? nextMember(frame, doc) : nextItem(frame, doc);
+                if (value) break;
+
+                if (_reader.failed()) return false;
+
+                closeContainer(frame, doc);
+                _stack.pop_back();
+            }
+
+            if (!value) return true;
+        }
+    }
+
+    JsonObject* JsonParser::nextMember(Frame& frame, JsonDocument& doc) {
+        std::string_view key;
+
+        if (!_reader.nextMember(frame.first)) return nullptr;
+        if (!_reader.checkKeys(++frame.count) || !_reader.readKey(key)) return nullptr;
+
+        auto& map = frame.container->_map.mut();
+
+        // the lookup key keeps its capacity, views of the input cannot be used to search the map
+        _key.assign(key.data(), key.size());
+
+        // the member of the previous parse with that key, otherwise any spare one
+        JsonDocument::Member member = frame.previous.extract(_key);
+
+        if (member.empty() && !doc._spareMembers.empty()) {
+            member = std::move(doc._spareMembers.back());
+            doc._spareMembers.pop_back();
+            member.key() = _key;
+        }
+
+        if (member.empty()) {
+            JSONMINI_STAT(allocations++);
+            return &map.try_emplace(_key).first->second;
+        }
+
+        auto inserted = map.insert(std::move(member));
+
+        // duplicate keys keep the last value, the node is not needed
+        if (!inserted.inserted) doc._spareMembers.push_back(std::move(inserted.node));
+
+        return &inserted.position->second;
+    }
+
+    JsonObject* JsonParser::nextItem(Frame& frame, JsonDocument& doc) {
+        if (!_reader.nextItem(frame.first)) return nullptr;
+
+        auto& arr = frame.container->_arr.mut();
+
+        if (frame.count < arr.size()) return &arr[frame.count++];
+
+        frame.count++;
+        JSONMINI_STAT(allocations += (arr.size() == arr.capacity()));
+
+        if (doc._spareValues.empty()) return &arr.emplace_back();
+
+        arr.push_back(std::move(doc._spareValues.back()));
+        doc._spareValues.pop_back();
+
+        return &arr.back();
+    }
+
+    void JsonParser::closeContainer(Frame& frame, JsonDocument& doc) {
+        // what the previous parse had beyond this message is kept aside
+        if (frame.container->isMap()) {
+            while (!frame.previous.empty()) {
+                doc._spareMembers.push_back(frame.previous.extract(frame.previous.begin()));
+            }
+
+            return;
+        }
+
+        auto& arr = frame.container->_arr.mut();
+
+        for (size_t i = frame.count; i < arr.size(); i++) {
+            doc._spareValues.push_back(std::move(arr[i]));
+        }
+
+        arr.resize(frame.count);
+    }
+
+    void JsonParser::recycle(JsonObject& value, JsonType type) {
+        value.touch();
+
+        // containers of another type are released, a string keeps its capacity
+        if (type != JSON_MAP) value._map.reset();
+        if (type != JSON_ARRAY) value._arr.reset();
+
+        // items are read into nodes, packed ones of an assigned tree are dropped
+        value._packed.reset();
+
+        value._type = type;
+        value._str.clear();
+        value._num = 0;
+        value._long = 0;
+        value._realNum = false;
+        value._bool = false;
+    }
+}
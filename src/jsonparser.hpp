@@ -0,0 +1,69 @@
+#ifndef JSONPARSER_HPP
+#define JSONPARSER_HPP
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "jsonerror.hpp"
+#include "jsonlimits.hpp"
+#include "jsonobject.hpp"
+#include "jsonreader.hpp"
+
+namespace jsonmini {
+    // a tree that hands its storage over to the next parse instead of freeing it;
+    // values and members dropped by a parse are kept aside until a later one needs them
+    class JsonDocument {
+        friend class JsonParser;
+    public:
+        JsonObject& root();
+        const JsonObject& root() const;
+
+        // map members and array items kept for reuse, with their own storage
+        size_t spareMembers() const;
+        size_t spareValues() const;
+
+        // drops the tree and everything kept for reuse
+        void clear();
+
+    private:
+        typedef std::map<std::string, JsonObject>::node_type Member;
+
+        JsonObject _root;
+        std::vector<Member> _spareMembers;
+        std::vector<JsonObject> _spareValues;
+    };
+
+    // parses message after message into documents; when a message has the shape of the previous
+    // one, its strings, containers and map nodes are overwritten in place and nothing is allocated
+    class JsonParser {
+    public:
+        explicit JsonParser(const JsonLimits& limits = JsonLimits());
+
+        // non-throwing, the root is reset to null on failure
+        JsonResult parse(const char* data, size_t size, JsonDocument& doc) noexcept;
+        JsonResult parse(const std::string& str, JsonDocument& doc) noexcept;
+
+    private:
+        struct Frame {
+            JsonObject* container;
+            // members of the previous parse, moved back into the map as their keys come again
+            std::map<std::string, JsonObject> previous;
+            size_t count;
+            bool first;
+        };
+
+        JsonReader _reader;
+        std::vector<Frame> _stack;
+        std::string _key;
+
+        bool read(JsonDocument& doc);
+        JsonObject* nextMember(Frame& frame, JsonDocument& doc);
+        JsonObject* nextItem(Frame& frame, JsonDocument& doc);
+        void closeContainer(Frame& frame, JsonDocument& doc);
+
+        static void recycle(JsonObject& value, JsonType type);
+    };
+}
+
+#endif
@@ -0,0 +1,307 @@
+#include "jsonpatch.hpp"
+
+#include "jsonobject.hpp"
+#include <algorithm>
+
+namespace jsonmini {
+    JsonObject JsonPatch::diff(const JsonObject& from, const JsonObject& to) {
+        JsonObject ops = JsonObject::makeArray();
+        diffNode(from, to, "", ops);
+        return ops;
+    }
+
+    JsonResult JsonPatch::apply(JsonObject& doc, const JsonObject& patch) noexcept {
+        if (!patch.isArray()) return JsonResult { JSON_ERROR_INVALID_PATCH, 0 };
+
+        // the copy shares the whole tree, only the paths touched by the patch get cloned
+        JsonObject result = doc;
+
+        for (size_t i = 0; i < patch.size(); i++) {
+            JsonError error = applyOperation(result, patch.itemAt(i));
+            if (error != JSON_OK) return JsonResult { error, i };
+        }
+
+        doc = result;
+        return JsonResult();
+    }
+
+    std::string JsonPatch::escapeToken(const std::string& token) {
+        std::string escaped;
+        escaped.reserve(token.size());
+
+        for (char c : token) {
+            if (c == '~') escaped += "~0";
+            else if (c == '/') escaped += "~1";
+            else escaped += c;
+        }
+
+        return escaped;
+    }
+
+    void JsonPatch::diffNode(const JsonObject& from, const JsonObject& to, const std::string& path, JsonObject& ops) {
+        if (from.hash() == to.hash() && from == to) return;
+
+        if (from.isMap() && to.isMap()) {
+            const auto& a = *from.asMap();
+            const auto& b = *to.asMap();
+
+            for (auto& pair : a) {
+                auto iter = b.find(pair.first);
+                std::string childPath = path + "/" + escapeToken(pair.first);
+
+                if (iter == b.end()) addOperation(ops, "remove", childPath, nullptr);
+                else diffNode(pair.second, iter->second, childPath, ops);
+            }
+
+            for (auto& pair : b) {
+                if (a.find(pair.first) == a.end()) {
+                    addOperation(ops, "add", path + "/" + escapeToken(pair.first), &pair.second);
+                }
+            }
+
+            return;
+        }
+
+        if (from.isArray() && to.isArray()) {
+            // items are copies, packed arrays are read without being unpacked
+            size_t common = (from.size() < to.size() ? from.size() : to.size());
+
+            for (size_t i = 0; i < common; i++) {
+                diffNode(from.itemAt(i), to.itemAt(i), path + "/" + std::to_string(i), ops);
+            }
+
+            for (size_t i = common; i < to.size(); i++) {
+                JsonObject item = to.itemAt(i);
+                addOperation(ops, "add", path + "/" + std::to_string(i), &item);
+            }
+
+            // from the back so the remaining indices stay valid
+            for (size_t i = from.size(); i > common; i--) {
+                addOperation(ops, "remove", path + "/" + std::to_string(i - 1), nullptr);
+            }
+
+            return;
+        }
+
+        addOperation(ops, "replace", path, &to);
+    }
+
+    void JsonPatch::addOperation(JsonObject& ops, const char* op, const std::string& path, const JsonObject* value) {
+        JsonObject entry = JsonObject::makeMap();
+
+        entry["op"] = JsonObject(op);
+        entry["path"] = JsonObject(path);
+
+        if (value) entry["value"] = *value;
+
+        ops.vector()->push_back(entry);
+    }
+
+    bool JsonPatch::parsePointer(const std::string& str, Pointer& pointer) {
+        pointer.clear();
+
+        if (str.empty()) return true;
+        if (str[0] != '/') return false;
+
+        for (size_t i = 0; i < str.size(); i++) {
+            char c = str[i];
+
+            if (c == '/') {
+                pointer.emplace_back();
+                continue;
+            }
+
+            if (c == '~') {
+                if (i + 1 == str.size() || (str[i + 1] != '0' && str[i + 1] != '1')) return false;
+
+                c = (str[++i] == '0' ? '~' : '/');
+            }
+
+            pointer.back() += c;
+        }
+
+        return true;
+    }
+
+    bool JsonPatch::parseIndex(const std::string& token, size_t size, bool append, size_t& index) {
+        if (token == "-") {
+            index = size;
+            return append;
+        }
+
+        if (token.empty() || token.size() > 18 || (token[0] == '0' && token.size() > 1)) return false;
+
+        index = 0;
+
+        for (char c : token) {
+            if (c < '0' || c > '9') return false;
+            index = index * 10 + (c - '0');
+        }
+
+        return append ? index <= size : index < size;
+    }
+
+    JsonObject* JsonPatch::find(JsonObject& doc, const Pointer& pointer, size_t depth) {
+        JsonObject* cur = &doc;
+
+        for (size_t i = 0; i < depth && cur; i++) {
+            size_t index;
+
+            if (cur->isMap()) cur = cur->get(pointer[i]);
+            else if (cur->isArray() && parseIndex(pointer[i], cur->size(), false, index)) cur = cur->get(index);
+            else cur = nullptr;
+        }
+
+        return cur;
+    }
+
+    // the document is only read, the items of packed arrays are copied out of them
+    bool JsonPatch::findValue(const JsonObject& doc, const Pointer& pointer, JsonObject& value) {
+        const JsonObject* cur = &doc;
+
+        for (size_t i = 0; i < pointer.size() && cur; i++) {
+            size_t index;
+
+            if (cur->isMap()) cur = cur->get(pointer[i]);
+            else if (cur->isArray() && parseIndex(pointer[i], cur->size(), false, index)) {
+                // packed items are numbers, there is nothing below them
+                if (cur->isPacked()) {
+                    if (i + 1 < pointer.size()) return false;
+
+                    value = cur->itemAt(index);
+                    return true;
+                }
+
+                cur = cur->get(index);
+            }
+            else cur = nullptr;
+        }
+
+        if (!cur) return false;
+
+        value = *cur;
+        return true;
+    }
+
+    JsonError JsonPatch::applyOperation(JsonObject& doc, const JsonObject& op) {
+        const JsonObject* name = op.get("op");
+        const JsonObject* path = op.get("path");
+        const JsonObject* value = op.get("value");
+        const JsonObject* from = op.get("from");
+        Pointer pointer, fromPointer;
+
+        if (!name || !name->isString() || !path || !path->isString()) return JSON_ERROR_INVALID_PATCH;
+        if (!parsePointer(path->str(), pointer)) return JSON_ERROR_INVALID_PATCH;
+
+        std::string kind = name->str();
+
+        if (kind == "add" || kind == "replace" || kind == "test") {
+            if (!value) return JSON_ERROR_INVALID_PATCH;
+        }
+        else if (kind == "move" || kind == "copy") {
+            if (!from || !from->isString() || !parsePointer(from->str(), fromPointer)) return JSON_ERROR_INVALID_PATCH;
+        }
+        else if (kind != "remove") {
+            return JSON_ERROR_INVALID_PATCH;
+        }
+
+        if (kind == "add") return addValue(doc, pointer, *value);
+        if (kind == "remove") return removeValue(doc, pointer, nullptr);
+
+        if (kind == "replace") {
+            JsonObject* target = find(doc, pointer, pointer.size());
+            if (!target) return JSON_ERROR_PATH_NOT_FOUND;
+
+            *target = *value;
+            return JSON_OK;
+        }
+
+        if (kind == "test") {
+            JsonObject target;
+            if (!findValue(doc, pointer, target)) return JSON_ERROR_PATH_NOT_FOUND;
+
+            return target == *value ? JSON_OK : JSON_ERROR_TEST_FAILED;
+        }
+
+        if (kind == "copy") {
+            JsonObject copy;
+            if (!findValue(doc, fromPointer, copy)) return JSON_ERROR_PATH_NOT_FOUND;
+
+            return addValue(doc, pointer, copy);
+        }
+
+        // a value cannot be moved into its own subtree
+        if (fromPointer.size() < pointer.size() && std::equal(fromPointer.begin(), fromPointer.end(), pointer.begin())) {
+            return JSON_ERROR_INVALID_PATCH;
+        }
+
+        if (fromPointer == pointer) {
+            JsonObject source;
+            return findValue(doc, fromPointer, source) ? JSON_OK : JSON_ERROR_PATH_NOT_FOUND;
+        }
+
+        JsonObject moved;
+        JsonError error = removeValue(doc, fromPointer, &moved);
+
+        return error != JSON_OK ? error : addValue(doc, pointer, moved);
+    }
+
+    JsonError JsonPatch::addValue(JsonObject& doc, const Pointer& pointer, const JsonObject& value) {
+        if (pointer.empty()) {
+            doc = value;
+            return JSON_OK;
+        }
+
+        JsonObject* parent = find(doc, pointer, pointer.size() - 1);
+        size_t index;
+
+        if (!parent) return JSON_ERROR_PATH_NOT_FOUND;
+
+        if (parent->isMap()) {
+            (*parent)[pointer.back()] = value;
+            return JSON_OK;
+        }
+
+        if (!parent->isArray() || !parseIndex(pointer.back(), parent->size(), true, index)) {
+            return JSON_ERROR_PATH_NOT_FOUND;
+        }
+
+        auto arr = parent->vector();
+        arr->insert(arr->begin() + index, value);
+
+        return JSON_OK;
+    }
+
+    JsonError JsonPatch::removeValue(JsonObject& doc, const Pointer& pointer, JsonObject* removed) {
+        if (pointer.empty()) {
+            if (removed) *removed = doc;
+
+            doc = JsonObject();
+            return JSON_OK;
+        }
+
+        JsonObject* parent = find(doc, pointer, pointer.size() - 1);
+        size_t index;
+
+        if (!parent) return JSON_ERROR_PATH_NOT_FOUND;
+
+        if (parent->isMap()) {
+            const JsonObject* target = ((const JsonObject*)parent)->get(pointer.back());
+            if (!target) return JSON_ERROR_PATH_NOT_FOUND;
+
+            if (removed) *removed = *target;
+
+            parent->remove(pointer.back());
+            return JSON_OK;
+        }
+
+        if (!parent->isArray() || !parseIndex(pointer.back(), parent->size(), false, index)) {
+            return JSON_ERROR_PATH_NOT_FOUND;
+        }
+
+        if (removed) *removed = parent->itemAt(index);
+
+        parent->remove(index);
+        return JSON_OK;
+    }
+}
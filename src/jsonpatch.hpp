@@ -0,0 +1,39 @@
+#ifndef JSONPATCH_HPP
+#define JSONPATCH_HPP
+
+#include <string>
+#include <vector>
+#include "jsonerror.hpp"
+
+namespace jsonmini {
+    class JsonObject;
+
+    // JSON Patch (RFC 6902) generation and application, paths are JSON Pointers (RFC 6901)
+    class JsonPatch {
+    public:
+        // operations turning from into to, equal subtrees are skipped by their cached hashes
+        static JsonObject diff(const JsonObject& from, const JsonObject& to);
+
+        // applies every operation or none, pos of a failure is the index of the operation
+        static JsonResult apply(JsonObject& doc, const JsonObject& patch) noexcept;
+
+        static std::string escapeToken(const std::string& token);
+
+    private:
+        typedef std::vector<std::string> Pointer;
+
+        static void diffNode(const JsonObject& from, const JsonObject& to, const std::string& path, JsonObject& ops);
+        static void addOperation(JsonObject& ops, const char* op, const std::string& path, const JsonObject* value);
+
+        static bool parsePointer(const std::string& str, Pointer& pointer);
+        static bool parseIndex(const std::string& token, size_t size, bool append, size_t& index);
+        static JsonObject* find(JsonObject& doc, const Pointer& pointer, size_t depth);
+        static bool findValue(const JsonObject& doc, const Pointer& pointer, JsonObject& value);
+
+        static JsonError applyOperation(JsonObject& doc, const JsonObject& op);
+        static JsonError addValue(JsonObject& doc, const Pointer& pointer, const JsonObject& value);
+        static JsonError removeValue(JsonObject& doc, const Pointer& pointer, JsonObject* removed);
+    };
+}
+
+#endif
@@ -0,0 +1,140 @@
+#include "jsonpipe.hpp"
+
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+namespace jsonmini {
+    JsonPipe::JsonPipe(int fd, size_t blockSize) : _fd(fd) {
+        _blocks[0].resize(blockSize > 0 ? blockSize : BLOCK_SIZE);
+        _blocks[1].resize(_blocks[0].size());
+
+        // without a way to wake it, the thread could only stop once the descriptor has data
+        if (pipe(_wake) != 0) {
+            _error = errno;
+            _done = true;
+            return;
+        }
+
+        _thread = std::thread(&JsonPipe::run, this);
+    }
+
+    JsonPipe::~JsonPipe() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+
+        _changed.notify_all();
+
+        if (_thread.joinable()) {
+            char byte = 0;
+            while (write(_wake[1], &byte, 1) < 0 && errno == EINTR) {}
+
+            _thread.join();
+        }
+
+        if (_wake[0] >= 0) close(_wake[0]);
+        if (_wake[1] >= 0) close(_wake[1]);
+    }
+
+    size_t JsonPipe::bytesRead() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _bytes;
+    }
+
+    size_t JsonPipe::stalls() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stalls;
+    }
+
+    int JsonPipe::error() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _error;
+    }
+
+    // hands the drained block back to the reading thread and takes the next one
+    JsonPipe::int_type JsonPipe::underflow() {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (_holding) {
+            _consumed++;
+            _holding = false;
+            _changed.notify_all();
+        }
+
+        if (_produced == _consumed && !_done) {
+            _stalls++;
+            _changed.wait(lock, [this]() { return _produced > _consumed || _done; });
+        }
+
+        if (_produced == _consumed) {
+            setg(nullptr, nullptr, nullptr);
+            return traits_type::eof();
+        }
+
+        size_t index = _consumed % 2;
+        char* block = _blocks[index].data();
+
+        _holding = true;
+        setg(block, block, block + _sizes[index]);
+
+        return traits_type::to_int_type(*block);
+    }
+
+    void JsonPipe::run() {
+        while (true) {
+            size_t index;
+
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _changed.wait(lock, [this]() { return _produced - _consumed < 2 || _stopped; });
+
+                if (_stopped) break;
+                index = _produced % 2;
+            }
+
+            // the block is not seen by the reader of the stream until it is counted as produced
+            long size = fill(_blocks[index].data());
+
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (size > 0) {
+                _sizes[index] = (size_t)size;
+                _bytes += (size_t)size;
+                _produced++;
+            }
+            else {
+                if (size < 0) _error = errno;
+                _done = true;
+            }
+
+            _changed.notify_all();
+            if (_done) return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _changed.notify_all();
+    }
+
+    long JsonPipe::fill(char* block) {
+        pollfd fds[2] = { { _fd, POLLIN, 0 }, { _wake[0], POLLIN, 0 } };
+
+        while (true) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+
+            if (fds[1].revents) return 0;
+
+            ssize_t size = read(_fd, block, _blocks[0].size());
+
+            if (size >= 0) return (long)size;
+            if (errno != EINTR && errno != EAGAIN) return -1;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef JSONPIPE_HPP
+#define JSONPIPE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace jsonmini {
+    // input buffer that reads a file descriptor on its own thread, one block ahead of the reader:
+    // the stream parser drains one block while the next is being read, e.g.
+    //   JsonPipe pipe(socket);
+    //   std::istream in(&pipe);
+    //   obj.readStream(in, limits);
+    // the descriptor stays open, the reading thread is stopped when the pipe is destroyed
+    class JsonPipe : public std::streambuf {
+    public:
+        explicit JsonPipe(int fd, size_t blockSize = BLOCK_SIZE);
+        ~JsonPipe();
+
+        JsonPipe(const JsonPipe&) = delete;
+        JsonPipe& operator =(const JsonPipe&) = delete;
+
+        // bytes read from the descriptor so far
+        size_t bytesRead() const;
+        // times the reader of the stream had to wait for the next block
+        size_t stalls() const;
+        // errno of a failed read, 0 if the input ended normally
+        int error() const;
+
+        static const size_t BLOCK_SIZE = 65536;
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        int _fd;
+        // signals the reading thread to stop waiting for the descriptor
+        int _wake[2] = { -1, -1 };
+
+        std::vector<char> _blocks[2];
+        size_t _sizes[2] = { 0, 0 };
+
+        // blocks filled and drained, block n is _blocks[n % 2]
+        size_t _produced = 0;
+        size_t _consumed = 0;
+        bool _holding = false;
+        bool _done = false;
+        bool _stopped = false;
+
+        size_t _bytes = 0;
+        size_t _stalls = 0;
+        int _error = 0;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _changed;
+        std::thread _thread;
+
+        void run();
+        // reads once into the block, 0 at the end of input or when stopped, -1 on failure
+        long fill(char* block);
+    };
+}
+
+#endif
@@ -0,0 +1,649 @@
+#include "jsonquery.hpp"
+
+#include <thread>
+#include "jsonstats.hpp"
+
+namespace jsonmini {
+    // what a path that reaches nothing compares as
+    static const JsonObject _MISSING;
+
+    // parentheses and negations a condition may nest
+    static const size_t _MAX_NESTING = 64;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool isIdentifierStart(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    }
+
+    static bool isIdentifierChar(char c) {
+        return isIdentifierStart(c) || (c >= '0' && c <= '9');
+    }
+
+    // recursive descent over the expression, pos is where it stopped on failure
+    struct JsonQuery::Compiler {
+        const std::string& text;
+        JsonQuery& out;
+        size_t pos = 0;
+        size_t nesting = 0;
+
+        char peek() {
+            while (pos < text.size() && isSpace(text[pos])) pos++;
+            return pos < text.size() ? text[pos] : '\0';
+        }
+
+        bool consume(const char* token) {
+            peek();
+
+            size_t size = std::char_traits<char>::length(token);
+            if (text.compare(pos, size, token) != 0) return false;
+
+            pos += size;
+            return true;
+        }
+
+        bool identifier(std::string& name) {
+            if (!isIdentifierStart(peek())) return false;
+
+            size_t begin = pos;
+            while (pos < text.size() && isIdentifierChar(text[pos])) pos++;
+
+            name.assign(text, begin, pos - begin);
+            return true;
+        }
+
+        // a JSON value, read the way the parser reads it
+        bool literal(JsonObject& value) {
+            JsonReader reader(text.data() + pos, text.size() - pos);
+
+            if (!value.read(reader)) {
+                pos += reader.errorPos();
+                return false;
+            }
+
+            pos += reader.pos();
+            return true;
+        }
+
+        bool query() {
+            size_t begin = pos;
+            std::string name;
+
+            if (peek() == '\0') return false;
+
+            if (identifier(name) && peek() == '(') {
+                if (name == "count") out._aggregate = COUNT;
+                else if (name == "sum") out._aggregate = SUM;
+                else if (name == "min") out._aggregate = MIN;
+                else if (name == "max") out._aggregate = MAX;
+                else {
+                    pos = begin;
+                    return false;
+                }
+
+                pos++;
+                if (!path(out._steps, false) || !consume(")")) return false;
+            }
+            else {
+                pos = begin;
+                if (!path(out._steps, false)) return false;
+            }
+
+            return peek() == '\0';
+        }
+
+        // relative paths only have members and items, a top-level one may be empty
+        bool path(std::vector<Step>& steps, bool relative) {
+            char c = peek();
+            std::string name;
+
+            if (c == '@') pos++;
+            else if (identifier(name)) steps.push_back(Step{ MEMBER, name });
+            else if (c == '*' && !relative) {
+                pos++;
+                steps.push_back(Step{ VALUES, "" });
+            }
+            else if (c != '[' && relative) return false;
+
+            while (true) {
+                if (consume(".")) {
+                    if (identifier(name)) steps.push_back(Step{ MEMBER, name });
+                    else if (relative) return false;
+                    else if (consume("*")) steps.push_back(Step{ VALUES, "" });
+                    else if (consume("{")) return fields(steps);
+                    else return false;
+                }
+                else if (consume("[")) {
+                    c = peek();
+
+                    if (c == '"' || c == '-' || (c >= '0' && c <= '9')) {
+                        size_t begin = pos;
+                        JsonObject key;
+                        if (!literal(key)) return false;
+
+                        if (key.isString()) steps.push_back(Step{ MEMBER, key.str() });
+                        else if (key.isNumber() && !key._realNum) steps.push_back(Step{ INDEX, "", key._long });
+                        else {
+                            pos = begin;
+                            return false;
+                        }
+                    }
+                    else if (relative) return false;
+                    else if (consume("*")) steps.push_back(Step{ ITEMS, "" });
+                    else if (consume("?")) {
+                        Step step{ FILTER, "" };
+                        if (!condition(step.first)) return false;
+                        steps.push_back(step);
+                    }
+                    else return false;
+
+                    if (!consume("]")) return false;
+                }
+                else return true;
+            }
+        }
+
+        // the projection is the last step, the caller checks that nothing follows it
+        bool fields(std::vector<Step>& steps) {
+            Step step{ PROJECT, "" };
+            step.first = out._fields.size();
+
+            do {
+                Field field;
+
+                if (peek() == '"') {
+                    JsonObject key;
+                    if (!literal(key) || !key.isString()) return false;
+                    field.name = key.str();
+                }
+                else if (!identifier(field.name)) return false;
+
+                if (!consume(":")) return false;
+
+                peek();
+                size_t begin = pos;
+                if (!operand(field.path)) return false;
+
+                if (field.path.isLiteral) {
+                    pos = begin;
+                    return false;
+                }
+
+                out._fields.push_back(std::move(field));
+                step.count++;
+            }
+            while (consume(","));
+
+            if (!consume("}")) return false;
+
+            steps.push_back(step);
+            return true;
+        }
+
+        bool condition(size_t& index) {
+            if (++nesting > _MAX_NESTING || !conjunction(index)) return false;
+
+            while (consume("||")) {
+                size_t right;
+                if (!conjunction(right)) return false;
+
+                out._conditions.push_back(Condition{ OR, {}, {}, index, right });
+                index = out._conditions.size() - 1;
+            }
+
+            nesting--;
+            return true;
+        }
+
+        bool conjunction(size_t& index) {
+            if (!unary(index)) return false;
+
+            while (consume("&&")) {
+                size_t right;
+                if (!unary(right)) return false;
+
+                out._conditions.push_back(Condition{ AND, {}, {}, index, right });
+                index = out._conditions.size() - 1;
+            }
+
+            return true;
+        }
+
+        bool unary(size_t& index) {
+            if (peek() == '!' && text.compare(pos, 2, "!=") != 0) {
+                pos++;
+
+                size_t operand;
+                if (++nesting > _MAX_NESTING || !unary(operand)) return false;
+                nesting--;
+
+                out._conditions.push_back(Condition{ NOT, {}, {}, operand });
+                index = out._conditions.size() - 1;
+                return true;
+            }
+
+            if (consume("(")) return condition(index) && consume(")");
+
+            return comparison(index);
+        }
+
+        bool comparison(size_t& index) {
+            Condition cond{ TRUTHY, {}, {} };
+
+            if (!operand(cond.left)) return false;
+
+            if (consume("==")) cond.op = EQ;
+            else if (consume("!=")) cond.op = NE;
+            else if (consume("<=")) cond.op = LE;
+            else if (consume(">=")) cond.op = GE;
+            else if (consume("<")) cond.op = LT;
+            else if (consume(">")) cond.op = GT;
+            else if (cond.left.isLiteral) return false;
+
+            if (cond.op != TRUTHY && !operand(cond.right)) return false;
+
+            out._conditions.push_back(std::move(cond));
+            index = out._conditions.size() - 1;
+            return true;
+        }
+
+        // JSON literals, also between backticks as in JMESPath; other words start paths
+        bool operand(Operand& result) {
+            char c = peek();
+            size_t begin = pos;
+            std::string name;
+
+            if (c == '`') {
+                size_t end = text.find('`', ++pos);
+                if (end == std::string::npos) return false;
+
+                JsonResult parsed = JsonObject::parse(text.data() + pos, end - pos, result.literal);
+
+                if (!parsed) {
+                    pos += parsed.pos;
+                    return false;
+                }
+
+                pos = end + 1;
+                result.isLiteral = true;
+                return true;
+            }
+
+            if (c == '"' || c == '-' || (c >= '0' && c <= '9') ||
+                (identifier(name) && (name == "true" || name == "false" || name == "null"))) {
+                pos = begin;
+                result.isLiteral = true;
+                return literal(result.literal);
+            }
+
+            pos = begin;
+            return path(result.steps, true);
+        }
+    };
+
+    JsonResult JsonQuery::compile(const std::string& expression, JsonQuery& out) {
+        JsonResult result;
+
+        out = JsonQuery();
+        Compiler compiler{ expression, out };
+
+        if (!compiler.query()) {
+            result.error = JSON_ERROR_INVALID_QUERY;
+            result.pos = compiler.pos < expression.size() ? compiler.pos : expression.size();
+            out = JsonQuery();
+        }
+
+        return result;
+    }
+
+    JsonObject JsonQuery::evaluate(const JsonObject& root, unsigned int threads) const {
+        Collector collector{ _aggregate };
+
+        walk(nodeValue(root), 0, collector, threads);
+        return collector.result();
+    }
+
+    JsonResult JsonQuery::evaluate(const char* data, size_t size, JsonObject& out, const JsonLimits& limits) const noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+        JsonReader reader(data, size, limits);
+        Collector collector{ _aggregate };
+
+        out = JsonObject();
+
+        if (walkText(reader, 0, collector) && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        if (!reader.failed()) out = collector.result();
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+        return reader.result();
+    }
+
+    JsonResult JsonQuery::evaluate(const std::string& str, JsonObject& out, const JsonLimits& limits) const noexcept {
+        return evaluate(str.data(), str.size(), out, limits);
+    }
+
+    // the tree is only read through const members that cache nothing, threads can share it
+    void JsonQuery::walk(const Value& value, size_t step, Collector& out, unsigned int threads) const {
+        if (step == _steps.size()) {
+            out.add(value);
+            return;
+        }
+
+        const Step& current = _steps[step];
+        const JsonObject* node = value.node;
+
+        switch (current.kind) {
+            case MEMBER:
+                if (node && node->isMap()) {
+                    const auto& map = node->_map.get();
+                    auto iter = map.find(current.name);
+
+                    if (iter != map.end()) walk(nodeValue(iter->second), step + 1, out, threads);
+                }
+            break;
+            case INDEX:
+                if (node && node->isArray()) {
+                    long size = (long)node->size();
+                    long index = current.index < 0 ? current.index + size : current.index;
+
+                    if (index >= 0 && index < size) walk(itemValue(*node, index), step + 1, out, threads);
+                }
+            break;
+            case VALUES:
+                if (node && node->isMap()) {
+                    for (auto& pair : node->_map.get()) {
+                        walk(nodeValue(pair.second), step + 1, out, threads);
+                    }
+                }
+            break;
+            case ITEMS:
+            case FILTER:
+            {
+                if (!node || !node->isArray()) break;
+
+                size_t size = node->size();
+                size_t parts = std::min<size_t>(threads, size / PARALLEL_ITEMS);
+
+                if (parts < 2) {
+                    walkItems(*node, step, 0, size, out, threads);
+                    break;
+                }
+
+                // ranges in order, the first one on this thread; arrays below are walked on one thread
+                std::vector<Collector> collectors(parts, Collector{ _aggregate });
+                std::vector<std::thread> workers;
+
+                for (size_t i = 1; i < parts; i++) {
+                    workers.emplace_back([this, node, step, size, parts, i, &collectors]() {
+                        walkItems(*node, step, size * i / parts, size * (i + 1) / parts, collectors[i], 1);
+                    });
+                }
+
+                walkItems(*node, step, 0, size / parts, collectors[0], 1);
+
+                for (auto& worker : workers) worker.join();
+                for (auto& collector : collectors) out.merge(collector);
+            }
+            break;
+            case PROJECT:
+            {
+                JsonObject projected = project(current, value);
+                out.add(nodeValue(projected));
+            }
+            break;
+        }
+    }
+
+    void JsonQuery::walkItems(const JsonObject& arr, size_t step, size_t begin, size_t end, Collector& out, unsigned int threads) const {
+        const Step& current = _steps[step];
+
+        for (size_t i = begin; i < end; i++) {
+            Value item = itemValue(arr, i);
+
+            if (current.kind == FILTER && !test(current.first, item)) continue;
+
+            walk(item, step + 1, out, threads);
+        }
+    }
+
+    // members and items the query does not reach are skipped without being built; values it reaches
+    // in full, items of a filter and steps that need the whole value are read into a tree and walked there
+    bool JsonQuery::walkText(JsonReader& reader, size_t step, Collector& out) const {
+        if (step == _steps.size() || _steps[step].kind == PROJECT || (_steps[step].kind == INDEX && _steps[step].index < 0)) {
+            JsonObject value;
+            if (!value.read(reader)) return false;
+
+            walk(nodeValue(value), step, out, 1);
+            return true;
+        }
+
+        const Step& current = _steps[step];
+        JsonType type;
+        bool first = true;
+
+        if (!reader.peekType(type)) return false;
+
+        if (current.kind == MEMBER || current.kind == VALUES) {
+            if (type != JSON_MAP) return reader.skipValue();
+            if (!reader.beginMap()) return false;
+
+            std::string_view key;
+            size_t members = 0;
+
+            while (reader.nextMember(first)) {
+                if (!reader.checkKeys(++members) || !reader.readKey(key)) return false;
+
+                bool reached = current.kind == VALUES || key == current.name;
+                if (!(reached ? walkText(reader, step + 1, out) : reader.skipValue())) return false;
+            }
+
+            return !reader.failed();
+        }
+
+        if (type != JSON_ARRAY) return reader.skipValue();
+        if (!reader.beginArray()) return false;
+
+        size_t index = 0;
+
+        while (reader.nextItem(first)) {
+            bool read;
+
+            if (current.kind == FILTER) {
+                JsonObject item;
+                read = item.read(reader);
+
+                if (read && test(current.first, nodeValue(item))) walk(nodeValue(item), step + 1, out, 1);
+            }
+            else if (current.kind == ITEMS || index == (size_t)current.index) read = walkText(reader, step + 1, out);
+            else read = reader.skipValue();
+
+            if (!read) return false;
+            index++;
+        }
+
+        return !reader.failed();
+    }
+
+    bool JsonQuery::test(size_t condition, const Value& value) const {
+        const Condition& cond = _conditions[condition];
+        Value left, right;
+
+        switch (cond.op) {
+            case AND:
+                return test(cond.a, value) && test(cond.b, value);
+            case OR:
+                return test(cond.a, value) || test(cond.b, value);
+            case NOT:
+                return !test(cond.a, value);
+            case TRUTHY:
+                if (!resolve(cond.left, value, left)) return false;
+                return left.node ? !left.node->isNull() && !(left.node->isBoolean() && !left.node->boolean()) : true;
+            default:
+                if (!resolve(cond.left, value, left)) left = nodeValue(_MISSING);
+                if (!resolve(cond.right, value, right)) right = nodeValue(_MISSING);
+
+                return compare(cond.op, left, right);
+        }
+    }
+
+    JsonObject JsonQuery::project(const Step& step, const Value& value) const {
+        JsonObject obj = JsonObject::makeMap();
+        auto& map = *obj.map();
+
+        for (size_t i = step.first; i < step.first + step.count; i++) {
+            const Field& field = _fields[i];
+            Value member;
+
+            map[field.name] = resolve(field.path, value, member) ? toObject(member) : JsonObject();
+        }
+
+        return obj;
+    }
+
+    JsonQuery::Value JsonQuery::nodeValue(const JsonObject& node) {
+        return Value{ &node, node._num, node._long, node._realNum };
+    }
+
+    JsonQuery::Value JsonQuery::itemValue(const JsonObject& arr, size_t index) {
+        if (!arr._packed.isSet()) return nodeValue(arr._arr.get()[index]);
+
+        const auto& packed = arr._packed.get();
+
+        if (packed.real) return Value{ nullptr, packed.reals[index], 0, true };
+        return Value{ nullptr, (double)packed.integers[index], packed.integers[index], false };
+    }
+
+    bool JsonQuery::resolve(const std::vector<Step>& steps, Value& value) {
+        for (const Step& step : steps) {
+            const JsonObject* node = value.node;
+
+            if (step.kind == MEMBER) {
+                if (!node || !node->isMap()) return false;
+
+                const auto& map = node->_map.get();
+                auto iter = map.find(step.name);
+
+                if (iter == map.end()) return false;
+                value = nodeValue(iter->second);
+            }
+            else {
+                if (!node || !node->isArray()) return false;
+
+                long size = (long)node->size();
+                long index = step.index < 0 ? step.index + size : step.index;
+
+                if (index < 0 || index >= size) return false;
+                value = itemValue(*node, index);
+            }
+        }
+
+        return true;
+    }
+
+    bool JsonQuery::resolve(const Operand& operand, const Value& value, Value& out) {
+        out = operand.isLiteral ? nodeValue(operand.literal) : value;
+        return resolve(operand.steps, out);
+    }
+
+    // numbers order by value and strings by their bytes, other values are only equal or not
+    bool JsonQuery::compare(Op op, const Value& left, const Value& right) {
+        bool leftNumber = !left.node || left.node->isNumber();
+        bool rightNumber = !right.node || right.node->isNumber();
+
+        if (op == EQ || op == NE) {
+            bool equal = (left.node && right.node) ? left.node->equals(*right.node) : toObject(left).equals(toObject(right));
+            return (op == EQ) == equal;
+        }
+
+        int order;
+
+        if (leftNumber && rightNumber) {
+            if (!left.real && !right.real) order = (left.integer > right.integer) - (left.integer < right.integer);
+            else order = (left.num > right.num) - (left.num < right.num);
+        }
+        else if (left.node && right.node && left.node->isString() && right.node->isString()) {
+            order = left.node->_str.compare(right.node->_str);
+        }
+        else return false;
+
+        switch (op) {
+            case LT: return order < 0;
+            case LE: return order <= 0;
+            case GT: return order > 0;
+            default: return order >= 0;
+        }
+    }
+
+    JsonObject JsonQuery::toObject(const Value& value) {
+        if (value.node) return *value.node;
+        return value.real ? JsonObject(value.num) : JsonObject(value.integer);
+    }
+
+    void JsonQuery::Collector::add(const Value& value) {
+        count++;
+
+        if (aggregate == NONE) {
+            items.push_back(toObject(value));
+            return;
+        }
+
+        if (aggregate == COUNT || (value.node && !value.node->isNumber())) return;
+
+        if (aggregate == SUM) {
+            long sum;
+
+            // integers stay exact until one of them is a real or the sum overflows
+            if (value.real || __builtin_add_overflow(integerSum, value.integer, &sum)) {
+                realSum += value.num;
+                realResult = true;
+            }
+            else integerSum = sum;
+
+            return;
+        }
+
+        Value number{ nullptr, value.num, value.integer, value.real };
+
+        if (!hasBest || compare(aggregate == MIN ? LT : GT, number, best)) best = number;
+        hasBest = true;
+    }
+
+    void JsonQuery::Collector::merge(Collector& other) {
+        count += other.count;
+
+        for (auto& item : other.items) items.push_back(std::move(item));
+
+        long sum;
+
+        if (__builtin_add_overflow(integerSum, other.integerSum, &sum)) realSum += (double)other.integerSum;
+        else integerSum = sum;
+
+        realSum += other.realSum;
+        realResult = realResult || other.realResult || sum != integerSum;
+
+        if (other.hasBest && (!hasBest || compare(aggregate == MIN ? LT : GT, other.best, best))) best = other.best;
+        hasBest = hasBest || other.hasBest;
+    }
+
+    JsonObject JsonQuery::Collector::result() {
+        switch (aggregate) {
+            case COUNT:
+                return JsonObject((long)count);
+            case SUM:
+                return realResult ? JsonObject(realSum + (double)integerSum) : JsonObject(integerSum);
+            case MIN:
+            case MAX:
+                return hasBest ? toObject(best) : JsonObject();
+            default:
+            {
+                JsonObject arr = JsonObject::makeArray();
+                arr.vector()->swap(items);
+                return arr;
+            }
+        }
+    }
+}
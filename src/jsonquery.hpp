@@ -0,0 +1,146 @@
+#ifndef JSONQUERY_HPP
+#define JSONQUERY_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "jsonerror.hpp"
+#include "jsonlimits.hpp"
+#include "jsonobject.hpp"
+#include "jsonreader.hpp"
+
+namespace jsonmini {
+    // a compiled path expression, a JMESPath-like subset; a path gives the values it reaches in document order:
+    //   a.b  a["b c"]  member          a[2]  a[-1]  item, negative from the end
+    //   a[*]  every item               a.*  every member value
+    //   a[?cond]  items for which cond holds, cond compares relative paths (@ is the item) and JSON
+    //             literals with == != < <= > >=, combined with && || ! and parentheses; a path alone
+    //             holds if it reaches something other than null or false
+    //   a.{x: p, y: q}  a map of relative paths for each value, as the last step
+    //   count(path) sum(path) min(path) max(path)  one number, only numbers are summed and compared
+    // the tree is only read: values are copied into the result once, nothing is copied along the way
+    class JsonQuery {
+    public:
+        static JsonResult compile(const std::string& expression, JsonQuery& out);
+
+        // the reached values as an array, or the aggregate (min and max of no numbers are null);
+        // with threads, the items of large arrays are split between that many threads
+        JsonObject evaluate(const JsonObject& root, unsigned int threads = 1) const;
+
+        // the query run while the text is read, only values it reaches are built;
+        // a member that is in the text twice is reached twice, out is reset to null on failure
+        JsonResult evaluate(const char* data, size_t size, JsonObject& out, const JsonLimits& limits = JsonLimits()) const noexcept;
+        JsonResult evaluate(const std::string& str, JsonObject& out, const JsonLimits& limits = JsonLimits()) const noexcept;
+
+        // items each thread gets at least before an array is split
+        static const size_t PARALLEL_ITEMS = 4096;
+
+    private:
+        enum Aggregate {
+            NONE,
+            COUNT,
+            SUM,
+            MIN,
+            MAX
+        };
+
+        enum StepKind {
+            MEMBER,
+            INDEX,
+            ITEMS,
+            VALUES,
+            FILTER,
+            PROJECT
+        };
+
+        enum Op {
+            EQ,
+            NE,
+            LT,
+            LE,
+            GT,
+            GE,
+            TRUTHY,
+            AND,
+            OR,
+            NOT
+        };
+
+        struct Step {
+            StepKind kind;
+            std::string name;
+            long index = 0;
+            // FILTER: root of its condition; PROJECT: first of its fields
+            size_t first = 0;
+            size_t count = 0;
+        };
+
+        // a relative path of members and items, or a literal when it has no steps
+        struct Operand {
+            std::vector<Step> steps;
+            JsonObject literal;
+            bool isLiteral = false;
+        };
+
+        struct Condition {
+            Op op;
+            Operand left;
+            Operand right;
+            // AND, OR, NOT
+            size_t a = 0;
+            size_t b = 0;
+        };
+
+        struct Field {
+            std::string name;
+            Operand path;
+        };
+
+        // a reached value, items of packed arrays have no node of their own
+        struct Value {
+            const JsonObject* node;
+            double num;
+            long integer;
+            bool real;
+        };
+
+        struct Collector {
+            explicit Collector(Aggregate kind) : aggregate(kind) { }
+
+            Aggregate aggregate;
+            std::vector<JsonObject> items;
+            size_t count = 0;
+            long integerSum = 0;
+            double realSum = 0;
+            bool realResult = false;
+            bool hasBest = false;
+            Value best;
+
+            void add(const Value& value);
+            void merge(Collector& other);
+            JsonObject result();
+        };
+
+        struct Compiler;
+
+        Aggregate _aggregate = NONE;
+        std::vector<Step> _steps;
+        std::vector<Condition> _conditions;
+        std::vector<Field> _fields;
+
+        void walk(const Value& value, size_t step, Collector& out, unsigned int threads) const;
+        void walkItems(const JsonObject& arr, size_t step, size_t begin, size_t end, Collector& out, unsigned int threads) const;
+        bool walkText(JsonReader& reader, size_t step, Collector& out) const;
+        bool test(size_t condition, const Value& value) const;
+        JsonObject project(const Step& step, const Value& value) const;
+
+        static Value nodeValue(const JsonObject& node);
+        static Value itemValue(const JsonObject& arr, size_t index);
+        static bool resolve(const std::vector<Step>& steps, Value& value);
+        static bool resolve(const Operand& operand, const Value& value, Value& out);
+        static bool compare(Op op, const Value& left, const Value& right);
+        static JsonObject toObject(const Value& value);
+    };
+}
+
+#endif
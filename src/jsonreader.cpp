@@ -0,0 +1,662 @@
+#include "jsonreader.hpp"
+
+#include "jsonescape.hpp"
+#include "jsonobjectexception.hpp"
+#include "jsonstats.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace jsonmini {
+    // byte classes inside of a string: 0 - plain, 1 - quote, 2 - backslash, 3 - control, 4 - non-ascii
+    static const unsigned char _STRCLASS[256] = {
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+        0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+    };
+
+    // true if the word holds a quote, a backslash, a control or a non-ascii byte
+    static bool hasSpecialByte(uint64_t word) {
+        const uint64_t ones = 0x0101010101010101ull;
+        const uint64_t high = 0x8080808080808080ull;
+
+        uint64_t quote = word ^ (ones * '"');
+        uint64_t backslash = word ^ (ones * '\\');
+
+        uint64_t special = ((word - ones * 0x20) & ~word)
+            | ((quote - ones) & ~quote)
+            | ((backslash - ones) & ~backslash)
+            | word;
+
+        return (special & high) != 0;
+    }
+
+    static bool isDigit(char byte) {
+        return byte >= '0' && byte <= '9';
+    }
+
+    static bool isAlpha(char byte) {
+        return (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z');
+    }
+
+    JsonReader::JsonReader(const char* data, size_t size, const JsonLimits& limits) : _limits(limits) {
+        reset(data, size);
+    }
+
+    JsonReader::JsonReader(const std::string& str, const JsonLimits& limits)
+        : JsonReader(str.data(), str.size(), limits) { }
+
+    void JsonReader::reset(const char* data, size_t size) {
+        _begin = data;
+        _cur = data;
+        _end = data + size;
+        _error = JSON_OK;
+        _errorPos = 0;
+        _depth = 0;
+        _nodes = 0;
+
+        // oversized input is rejected before anything is read
+        if (size > _limits.maxBytes) {
+            fail(JSON_ERROR_INPUT_TOO_LARGE, data + _limits.maxBytes);
+            _end = _cur;
+        }
+    }
+
+    const JsonLimits& JsonReader::limits() const {
+        return _limits;
+    }
+
+    char JsonReader::peek() {
+        skipWhitespace();
+        return _cur < _end ? *_cur : '\0';
+    }
+
+    bool JsonReader::consume(char c) {
+        skipWhitespace();
+
+        if (_cur < _end && *_cur == c) {
+            _cur++;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool JsonReader::atEnd() {
+        skipWhitespace();
+        return _cur == _end;
+    }
+
+    bool JsonReader::peekType(JsonType& type) {
+        switch (peek()) {
+            case '{':
+                type = JSON_MAP;
+                return true;
+            case '[':
+                type = JSON_ARRAY;
+                return true;
+            case '"':
+                type = JSON_STRING;
+                return true;
+            case 't':
+            case 'f':
+                type = JSON_BOOLEAN;
+                return true;
+            case 'n':
+                type = JSON_NULL;
+                return true;
+            default:
+                if (_cur == _end) return fail(JSON_ERROR_VALUE_EXPECTED, _cur);
+
+                if (isDigit(*_cur) || *_cur == '-') {
+                    type = JSON_NUMBER;
+                    return true;
+                }
+
+                if (isAlpha(*_cur)) return readKeyword("", 0);
+
+                return fail(JSON_ERROR_CHARACTER_NOT_ALLOWED, _cur);
+        }
+    }
+
+    bool JsonReader::readString(std::string& out) {
+        out.clear();
+        return appendString(out);
+    }
+
+    bool JsonReader::appendString(std::string& out) {
+        if (peek() != '"') return fail(JSON_ERROR_STRING_EXPECTED, _cur);
+        if (!countNode(_cur)) return false;
+
+        JSONMINI_STAT(nodes[JSON_STRING]++);
+        return scanString(&out);
+    }
+
+    bool JsonReader::readKey(std::string_view& key) {
+        if (peek() != '"') return fail(JSON_ERROR_KEY_EXPECTED, _cur);
+
+        const char* open = _cur;
+        bool escaped = false;
+
+        // keys without escape sequences are returned as views into the buffer
+        for (const char* p = open + 1; p < _end; p++) {
+            if (*p == '\\') {
+                escaped = true;
+                break;
+            }
+
+            if (*p == '"') break;
+        }
+
+        if (escaped) {
+            _scratch.clear();
+            if (!scanString(&_scratch)) return false;
+            key = _scratch;
+        }
+        else {
+            if (!scanString(nullptr)) return false;
+            key = std::string_view(open + 1, _cur - open - 2);
+        }
+
+        if (!consume(':')) return fail(JSON_ERROR_KEY_SEPARATOR_EXPECTED, _cur);
+
+        return true;
+    }
+
+    bool JsonReader::readNumber(double& value, bool& real) {
+        const char* begin;
+
+        if (!scanNumber(begin, real)) return false;
+
+        auto result = std::from_chars(begin, _cur, value);
+
+        if (result.ec == std::errc::result_out_of_range) return fail(JSON_ERROR_NUMBER_OUT_OF_RANGE, begin);
+
+        return true;
+    }
+
+    bool JsonReader::readNumber(double& value, long& integer, bool& real) {
+        const char* begin;
+
+        if (!scanNumber(begin, real)) return false;
+
+        auto result = std::from_chars(begin, _cur, value);
+
+        if (result.ec == std::errc::result_out_of_range) return fail(JSON_ERROR_NUMBER_OUT_OF_RANGE, begin);
+
+        if (real || std::from_chars(begin, _cur, integer).ec == std::errc::result_out_of_range) {
+            real = true;
+            integer = 0;
+        }
+
+        return true;
+    }
+
+    bool JsonReader::readInteger(long long& value) {
+        const char* begin;
+        bool real;
+
+        if (!scanNumber(begin, real)) return false;
+        if (real) return fail(JSON_ERROR_INTEGER_EXPECTED, begin);
+
+        auto result = std::from_chars(begin, _cur, value);
+
+        if (result.ec == std::errc::result_out_of_range) return fail(JSON_ERROR_NUMBER_OUT_OF_RANGE, begin);
+
+        return true;
+    }
+
+    bool JsonReader::readBoolean(bool& value) {
+        switch (peek()) {
+            case 't':
+                value = true;
+                JSONMINI_STAT(nodes[JSON_BOOLEAN]++);
+                return countNode(_cur) && readKeyword("true", 4);
+            case 'f':
+                value = false;
+                JSONMINI_STAT(nodes[JSON_BOOLEAN]++);
+                return countNode(_cur) && readKeyword("false", 5);
+            default:
+                return fail(JSON_ERROR_BOOLEAN_EXPECTED, _cur);
+        }
+    }
+
+    bool JsonReader::readNull() {
+        if (peek() != 'n') return fail(JSON_ERROR_NULL_EXPECTED, _cur);
+        JSONMINI_STAT(nodes[JSON_NULL]++);
+        return countNode(_cur) && readKeyword("null", 4);
+    }
+
+    bool JsonReader::skipValue() {
+        // nesting is kept as a bit stack (1 - map, 0 - array), the first SKIP_DEPTH levels without allocating;
+        // deeper ones, allowed by a raised maxDepth, go on the heap
+        uint64_t maps[SKIP_DEPTH / 64];
+        std::vector<uint64_t> deepMaps;
+        size_t depth = 0;
+
+        // member counts of the open maps, only kept while maxKeys is set
+        uint32_t keys[SKIP_DEPTH];
+        std::vector<uint32_t> deepKeys;
+        bool countKeys = _limits.maxKeys < UINT32_MAX;
+
+        auto mapWord = [&](size_t level) -> uint64_t& {
+            return level < SKIP_DEPTH ? maps[level / 64] : deepMaps[(level - SKIP_DEPTH) / 64];
+        };
+
+        auto keyCount = [&](size_t level) -> uint32_t& {
+            return level < SKIP_DEPTH ? keys[level] : deepKeys[level - SKIP_DEPTH];
+        };
+
+        while (true) {
+            JsonType type;
+            bool first = false;
+
+            if (!peekType(type)) return false;
+
+            switch (type) {
+                case JSON_MAP:
+                case JSON_ARRAY:
+                {
+                    if (!enter(_cur)) return false;
+
+                    if (depth >= SKIP_DEPTH) {
+                        size_t deep = depth - SKIP_DEPTH;
+
+                        if (deep / 64 == deepMaps.size()) deepMaps.push_back(0);
+                        if (countKeys && deep == deepKeys.size()) deepKeys.push_back(0);
+                    }
+
+                    uint64_t bit = (uint64_t)1 << (depth % 64);
+
+                    if (type == JSON_MAP) mapWord(depth) |= bit;
+                    else mapWord(depth) &= ~bit;
+
+                    if (countKeys) keyCount(depth) = 0;
+
+                    depth++;
+                    _cur++;
+                    first = true;
+                    JSONMINI_STAT(nodes[type]++);
+                    JSONMINI_STAT(enter());
+                }
+                break;
+                case JSON_STRING:
+                    JSONMINI_STAT(nodes[JSON_STRING]++);
+                    if (!countNode(_cur) || !scanString(nullptr)) return false;
+                break;
+                case JSON_BOOLEAN:
+                {
+                    bool value;
+                    if (!readBoolean(value)) return false;
+                }
+                break;
+                case JSON_NULL:
+                    if (!readNull()) return false;
+                break;
+                default:
+                {
+                    const char* begin;
+                    bool real;
+                    if (!scanNumber(begin, real)) return false;
+                    if (!checkRange(begin, real)) return false;
+                }
+                break;
+            }
+
+            // move on to the next value, unwinding every container that gets closed
+            while (true) {
+                if (depth == 0) return true;
+
+                bool isMap = (mapWord(depth - 1) >> ((depth - 1) % 64)) & 1;
+
+                if (next(first, isMap ? '}' : ']')) {
+                    if (isMap && countKeys && !checkKeys(++keyCount(depth - 1))) return false;
+                    if (isMap && !skipKey()) return false;
+                    break;
+                }
+
+                if (failed()) return false;
+
+                depth--;
+                first = false;
+            }
+        }
+    }
+
+    bool JsonReader::reject(JsonError error) {
+        return fail(error, _cur);
+    }
+
+    bool JsonReader::checkKeys(size_t count) {
+        if (count > _limits.maxKeys) return fail(JSON_ERROR_TOO_MANY_KEYS, _cur);
+        return true;
+    }
+
+    bool JsonReader::beginMap() {
+        if (peek() != '{') return fail(JSON_ERROR_MAP_EXPECTED, _cur);
+        if (!enter(_cur)) return false;
+
+        _cur++;
+        JSONMINI_STAT(nodes[JSON_MAP]++);
+        JSONMINI_STAT(enter());
+        return true;
+    }
+
+    bool JsonReader::beginArray() {
+        if (peek() != '[') return fail(JSON_ERROR_ARRAY_EXPECTED, _cur);
+        if (!enter(_cur)) return false;
+
+        _cur++;
+        JSONMINI_STAT(nodes[JSON_ARRAY]++);
+        JSONMINI_STAT(enter());
+        return true;
+    }
+
+    bool JsonReader::nextMember(bool& first) {
+        return next(first, '}');
+    }
+
+    bool JsonReader::nextItem(bool& first) {
+        return next(first, ']');
+    }
+
+    bool JsonReader::failed() const {
+        return _error != JSON_OK;
+    }
+
+    JsonError JsonReader::error() const {
+        return _error;
+    }
+
+    size_t JsonReader::errorPos() const {
+        return _errorPos;
+    }
+
+    size_t JsonReader::pos() const {
+        return _cur - _begin;
+    }
+
+    JsonResult JsonReader::result() const {
+        return JsonResult { _error, _errorPos };
+    }
+
+    void JsonReader::check() const {
+        if (failed()) JSONMINI_THROW(JsonObjectException(errorMessage(_error), _errorPos));
+    }
+
+    bool JsonReader::fail(JsonError error, const char* at) {
+        if (!failed()) {
+            _error = error;
+            _errorPos = at - _begin;
+        }
+
+        return false;
+    }
+
+    bool JsonReader::countNode(const char* at) {
+        if (++_nodes > _limits.maxNodes) return fail(JSON_ERROR_TOO_MANY_NODES, at);
+        return true;
+    }
+
+    bool JsonReader::enter(const char* at) {
+        if (_depth == _limits.maxDepth) return fail(JSON_ERROR_DEPTH_EXCEEDED, at);
+
+        _depth++;
+        return countNode(at);
+    }
+
+    void JsonReader::skipWhitespace() {
+        while (_cur < _end && (unsigned char)*_cur <= ' ') {
+            if (*_cur != ' ' && *_cur != '\n' && *_cur != '\r' && *_cur != '\t') return;
+            _cur++;
+        }
+    }
+
+    bool JsonReader::next(bool& first, char closeChar) {
+        // a failed reader never hands out another element
+        if (failed()) return false;
+
+        skipWhitespace();
+
+        if (_cur == _end) return fail(JSON_ERROR_CLOSING_BRACKET_EXPECTED, _cur);
+
+        if (*_cur == closeChar) {
+            _cur++;
+            _depth--;
+            JSONMINI_STAT(leave());
+            return false;
+        }
+
+        if (*_cur == ',') {
+            if (first) return fail(JSON_ERROR_REDUNDANT_COMMA, _cur);
+
+            _cur++;
+            skipWhitespace();
+
+            if (_cur == _end) return fail(JSON_ERROR_CLOSING_BRACKET_EXPECTED, _cur);
+            if (*_cur == closeChar || *_cur == ',') return fail(JSON_ERROR_REDUNDANT_COMMA, _cur);
+        }
+        else if (!first) {
+            return fail(JSON_ERROR_COMMA_EXPECTED, _cur);
+        }
+
+        first = false;
+        return true;
+    }
+
+    bool JsonReader::skipKey() {
+        if (peek() != '"') return fail(JSON_ERROR_KEY_EXPECTED, _cur);
+        if (!scanString(nullptr)) return false;
+        if (!consume(':')) return fail(JSON_ERROR_KEY_SEPARATOR_EXPECTED, _cur);
+
+        return true;
+    }
+
+    bool JsonReader::scanString(std::string* out) {
+        const char* open = _cur++;
+
+        // scanning stops one byte past the longest content allowed, so the limit costs nothing per byte
+        size_t room = _end - _cur;
+        bool limited = room > _limits.maxStringLength;
+        const char* stop = limited ? _cur + _limits.maxStringLength + 1 : _end;
+
+        while (true) {
+            const char* run = _cur;
+
+            while (_cur < stop) {
+                // eight plain bytes at a time
+                while (stop - _cur >= 8) {
+                    uint64_t word;
+                    std::memcpy(&word, _cur, 8);
+
+                    if (hasSpecialByte(word)) break;
+                    _cur += 8;
+                }
+
+                if (_cur == stop) break;
+
+                unsigned char cls = _STRCLASS[(unsigned char)*_cur];
+
+                if (cls == 0) {
+                    _cur++;
+                    continue;
+                }
+
+                if (cls != 4) break;
+
+                size_t seqSize = utf8SeqSize(*_cur);
+
+                if (seqSize == 0 || (size_t)(_end - _cur) < seqSize) {
+                    return fail(JSON_ERROR_INVALID_UTF8, _cur);
+                }
+
+                for (size_t i = 1; i < seqSize; i++) {
+                    if ((_cur[i] & 0xc0) != 0x80) return fail(JSON_ERROR_INVALID_UTF8, _cur + i);
+                }
+
+                _cur += seqSize;
+            }
+
+            if (limited && _cur >= stop) return fail(JSON_ERROR_STRING_TOO_LONG, open + 1 + _limits.maxStringLength);
+
+            if (out && _cur != run) out->append(run, _cur - run);
+
+            if (_cur == _end) return fail(JSON_ERROR_UNCLOSED_STRING, open);
+
+            char byte = *_cur;
+
+            if (byte == '"') {
+                _cur++;
+                JSONMINI_STAT(stringBytesRead += _cur - open - 2);
+                return true;
+            }
+
+            if (byte != '\\') return fail(JSON_ERROR_CONTROL_CHARACTER, _cur);
+
+            if (++_cur == _end) return fail(JSON_ERROR_UNCLOSED_STRING, open);
+
+            JSONMINI_STAT(escapesRead++);
+
+            char letter = *_cur++;
+
+            if (letter == 'u') {
+                uint32_t code;
+                if (!scanUnicodeEscape(code)) return false;
+
+                if (out) {
+                    char seq[4];
+                    out->append(seq, encodeUtf8(code, seq));
+                }
+
+                continue;
+            }
+
+            char sub = JSON_UNESCAPE[letter];
+
+            if (sub == 0) return fail(JSON_ERROR_ILLEGAL_ESCAPE, _cur - 1);
+            if (out) out->push_back(sub);
+        }
+    }
+
+    bool JsonReader::scanUnicodeEscape(uint32_t& code) {
+        if (!scanCodeUnit(code)) return false;
+        if (isLowSurrogate(code)) return fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _cur - 4);
+        if (!isHighSurrogate(code)) return true;
+
+        if (_end - _cur < 2 || _cur[0] != '\\' || _cur[1] != 'u') return fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _cur);
+
+        _cur += 2;
+        JSONMINI_STAT(escapesRead++);
+
+        uint32_t low;
+
+        if (!scanCodeUnit(low)) return false;
+        if (!isLowSurrogate(low)) return fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _cur - 4);
+
+        code = combineSurrogates(code, low);
+        return true;
+    }
+
+    bool JsonReader::scanCodeUnit(uint32_t& unit) {
+        if (_end - _cur < 4) return fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _cur);
+
+        unit = 0;
+
+        for (int i = 0; i < 4; i++) {
+            int digit = hexDigit(_cur[i]);
+            if (digit < 0) return fail(JSON_ERROR_INVALID_UNICODE_ESCAPE, _cur + i);
+            unit = (unit << 4) | digit;
+        }
+
+        _cur += 4;
+        return true;
+    }
+
+    bool JsonReader::scanNumber(const char*& begin, bool& real) {
+        skipWhitespace();
+
+        begin = _cur;
+        real = false;
+
+        if (!countNode(_cur)) return false;
+
+        if (_cur < _end && *_cur == '-') _cur++;
+
+        if (_cur == _end || !isDigit(*_cur)) return fail(JSON_ERROR_NUMBER_EXPECTED, _cur);
+
+        if (*_cur == '0') {
+            _cur++;
+            if (_cur < _end && isDigit(*_cur)) return fail(JSON_ERROR_LEADING_ZERO, _cur);
+        }
+        else {
+            while (_cur < _end && isDigit(*_cur)) _cur++;
+        }
+
+        if (_cur < _end && *_cur == '.') {
+            real = true;
+            _cur++;
+
+            if (_cur == _end || !isDigit(*_cur)) return fail(JSON_ERROR_NUMBER_EXPECTED, _cur);
+            while (_cur < _end && isDigit(*_cur)) _cur++;
+        }
+
+        if (_cur < _end && (*_cur == 'e' || *_cur == 'E')) {
+            real = true;
+            _cur++;
+
+            if (_cur < _end && (*_cur == '-' || *_cur == '+')) _cur++;
+
+            if (_cur == _end || !isDigit(*_cur)) return fail(JSON_ERROR_NUMBER_EXPECTED, _cur);
+            while (_cur < _end && isDigit(*_cur)) _cur++;
+        }
+
+        JSONMINI_STAT(nodes[JSON_NUMBER]++);
+        return true;
+    }
+
+    bool JsonReader::checkRange(const char* begin, bool real) {
+        size_t size = _cur - begin;
+
+        // only an exponent or more than 300 digits can leave the range of a double
+        if (size <= 300 && (!real || std::find_if(begin, _cur, [](char c) { return c == 'e' || c == 'E'; }) == _cur)) {
+            return true;
+        }
+
+        double value;
+
+        if (std::from_chars(begin, _cur, value).ec == std::errc::result_out_of_range) {
+            return fail(JSON_ERROR_NUMBER_OUT_OF_RANGE, begin);
+        }
+
+        return true;
+    }
+
+    bool JsonReader::readKeyword(const char* kw, size_t size) {
+        const char* begin = _cur;
+        const char* end = _cur;
+
+        while (end < _end && isAlpha(*end)) end++;
+
+        if ((size_t)(end - begin) != size || std::memcmp(begin, kw, size) != 0) {
+            return fail(JSON_ERROR_UNKNOWN_IDENTIFIER, begin);
+        }
+
+        _cur = end;
+        return true;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef JSONREADER_HPP
+#define JSONREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "jsonerror.hpp"
+#include "jsonlimits.hpp"
+#include "jsontype.hpp"
+
+namespace jsonmini {
+    // pull tokenizer over a contiguous buffer, reports errors instead of throwing;
+    // depth, size, string length and value count limits are enforced on every read
+    class JsonReader {
+    public:
+        JsonReader(const char* data, size_t size, const JsonLimits& limits = JsonLimits());
+        explicit JsonReader(const std::string& str, const JsonLimits& limits = JsonLimits());
+
+        // starts over on new input with the same limits, the key scratch buffer is kept
+        void reset(const char* data, size_t size);
+
+        const JsonLimits& limits() const;
+
+        // next significant character without consuming it, '\0' at the end of input
+        char peek();
+        bool consume(char c);
+        bool atEnd();
+
+        // type of the next value, fails if no value can start at the current position
+        bool peekType(JsonType& type);
+
+        bool readString(std::string& out);
+        // decodes the next string onto the end of out
+        bool appendString(std::string& out);
+        bool readKey(std::string_view& key);
+        bool readNumber(double& value, bool& real);
+        // integers are also returned exactly, ones that do not fit are reported as real
+        bool readNumber(double& value, long& integer, bool& real);
+        bool readInteger(long long& value);
+        bool readBoolean(bool& value);
+        bool readNull();
+        // validates and skips the next value, allocating only for nesting past SKIP_DEPTH
+        bool skipValue();
+
+        // fails at the current position once a map has more members than allowed
+        bool checkKeys(size_t count);
+
+        // marks the input as malformed at the current position
+        bool reject(JsonError error);
+
+        // container traversal, returns false once the closing bracket is consumed
+        bool beginMap();
+        bool beginArray();
+        bool nextMember(bool& first);
+        bool nextItem(bool& first);
+
+        bool failed() const;
+        JsonError error() const;
+        size_t errorPos() const;
+        size_t pos() const;
+        JsonResult result() const;
+
+        // throws JsonObjectException describing the failure, if any
+        void check() const;
+
+        // levels skipValue tracks on the stack, deeper ones allocate
+        static const size_t SKIP_DEPTH = 4096;
+
+    private:
+        const char* _begin;
+        const char* _cur;
+        const char* _end;
+
+        JsonError _error = JSON_OK;
+        size_t _errorPos = 0;
+
+        JsonLimits _limits;
+        size_t _depth = 0;
+        size_t _nodes = 0;
+
+        std::string _scratch;
+
+        bool fail(JsonError error, const char* at);
+        bool countNode(const char* at);
+        bool enter(const char* at);
+        void skipWhitespace();
+        bool next(bool& first, char closeChar);
+        bool skipKey();
+        bool scanString(std::string* out);
+        // a \u escape after its letter, surrogate pairs are read as one code point
+        bool scanUnicodeEscape(uint32_t& code);
+        bool scanCodeUnit(uint32_t& unit);
+        bool scanNumber(const char*& begin, bool& real);
+        // cheap out-of-range check for validation, which does not convert numbers
+        bool checkRange(const char* begin, bool real);
+        bool readKeyword(const char* kw, size_t size);
+    };
+}
+
+#endif
@@ -0,0 +1,448 @@
+#include "jsonschema.hpp"
+
+#include <cmath>
+#include "jsonpatch.hpp"
+#include "jsonstats.hpp"
+
+namespace jsonmini {
+    static unsigned int typeBit(JsonType type) {
+        return 1u << type;
+    }
+
+    static bool failCompile(JsonSchemaResult& result, const std::string& path) {
+        result.error = JSON_ERROR_INVALID_SCHEMA;
+        result.path = path;
+        return false;
+    }
+
+    static bool isCount(const JsonObject& value) {
+        return value.isNumber() && value.number() >= 0 && value.number() == std::floor(value.number());
+    }
+
+    // number of code points, continuation bytes are not counted
+    static size_t codePoints(const std::string& str) {
+        size_t count = 0;
+
+        for (char c : str) {
+            if (((unsigned char)c & 0xc0) != 0x80) count++;
+        }
+
+        return count;
+    }
+
+    JsonSchemaResult JsonSchema::compile(const JsonObject& schema, JsonSchema& out) {
+        JsonSchemaResult result;
+
+        out._nodes.assign(2, Node());
+        out._nodes[NEVER].types = 0;
+        out._nodes[NEVER].any = false;
+
+        if (!out.compileNode(schema, "", out._root, result)) {
+            out._nodes.clear();
+            out._root = ANY;
+        }
+
+        return result;
+    }
+
+    bool JsonSchema::compileNode(const JsonObject& schema, const std::string& path, size_t& index, JsonSchemaResult& result) {
+        if (schema.isBoolean()) {
+            index = schema.boolean() ? ANY : NEVER;
+            return true;
+        }
+
+        auto map = schema.asMap();
+        if (!map) return failCompile(result, path);
+
+        index = _nodes.size();
+        _nodes.emplace_back();
+
+        // nodes are added while this one is filled in, it is only reached by index
+        auto node = [&]() -> Node& { return _nodes[index]; };
+
+        for (auto& member : *map) {
+            const std::string& keyword = member.first;
+            const JsonObject& value = member.second;
+            const std::string at = path + "/" + JsonPatch::escapeToken(keyword);
+
+            if (keyword == "type") {
+                const char* names[] = { "object", "array", "string", "number", "boolean", "null", "integer" };
+                std::vector<JsonObject> listed;
+
+                if (value.isArray()) {
+                    for (size_t i = 0; i < value.size(); i++) listed.push_back(value.itemAt(i));
+                }
+                else listed.push_back(value);
+
+                node().types = 0;
+
+                for (auto& name : listed) {
+                    size_t i = 0;
+
+                    while (i < 7 && !(name.isString() && name.str() == names[i])) i++;
+                    if (i == 7) return failCompile(result, at);
+
+                    node().types |= 1u << i;
+                }
+            }
+            else if (keyword == "properties") {
+                auto properties = value.asMap();
+                if (!properties) return failCompile(result, at);
+
+                for (auto& property : *properties) {
+                    size_t child;
+                    if (!compileNode(property.second, at + "/" + JsonPatch::escapeToken(property.first), child, result)) return false;
+
+                    auto& entry = node().properties.try_emplace(property.first, Property{ ANY, 0 }).first->second;
+                    entry.node = child;
+                }
+            }
+            else if (keyword == "required") {
+                auto keys = value.asVector();
+                if (!keys) return failCompile(result, at);
+
+                for (auto& key : *keys) {
+                    if (!key.isString()) return failCompile(result, at);
+
+                    auto& entry = node().properties.try_emplace(key.str(), Property{ ANY, 0 }).first->second;
+                    if (entry.bit) continue;
+
+                    size_t count = 0;
+                    for (uint64_t bits = node().required; bits; bits &= bits - 1) count++;
+
+                    if (count == MAX_REQUIRED) return failCompile(result, at);
+
+                    entry.bit = (uint64_t)1 << count;
+                    node().required |= entry.bit;
+                }
+            }
+            else if (keyword == "additionalProperties" || keyword == "items") {
+                size_t child;
+                if (!compileNode(value, at, child, result)) return false;
+
+                if (keyword == "items") node().items = child;
+                else node().additional = child;
+            }
+            else if (keyword == "enum" || keyword == "const") {
+                std::vector<JsonObject> values;
+
+                if (keyword == "const") values.push_back(value);
+                else if (value.isArray() && value.size() > 0) {
+                    // packed arrays of numbers are read without being unpacked
+                    for (size_t i = 0; i < value.size(); i++) values.push_back(value.itemAt(i));
+                }
+                else return failCompile(result, at);
+
+                // only scalars are compared, containers would need a built tree
+                for (auto& allowed : values) {
+                    if (allowed.isMap() || allowed.isArray()) return failCompile(result, at);
+                }
+
+                node().values.insert(node().values.end(), values.begin(), values.end());
+                node().enumerated = true;
+            }
+            else if (keyword == "minimum" || keyword == "exclusiveMinimum") {
+                if (!value.isNumber()) return failCompile(result, at);
+
+                // with both keywords the stricter bound is kept
+                bool exclusive = keyword == "exclusiveMinimum";
+                Node& n = node();
+
+                if (!n.hasMinimum || value.number() > n.minimum || (value.number() == n.minimum && exclusive)) {
+                    n.minimum = value.number();
+                    n.hasMinimum = true;
+                    n.exclusiveMinimum = exclusive;
+                }
+            }
+            else if (keyword == "maximum" || keyword == "exclusiveMaximum") {
+                if (!value.isNumber()) return failCompile(result, at);
+
+                bool exclusive = keyword == "exclusiveMaximum";
+                Node& n = node();
+
+                if (!n.hasMaximum || value.number() < n.maximum || (value.number() == n.maximum && exclusive)) {
+                    n.maximum = value.number();
+                    n.hasMaximum = true;
+                    n.exclusiveMaximum = exclusive;
+                }
+            }
+            else if (keyword == "minLength" || keyword == "maxLength" || keyword == "minItems" || keyword == "maxItems") {
+                if (!isCount(value)) return failCompile(result, at);
+
+                size_t count = value.number() < (double)SIZE_MAX ? (size_t)value.number() : SIZE_MAX;
+
+                if (keyword == "minLength") node().minLength = count;
+                else if (keyword == "maxLength") node().maxLength = count;
+                else if (keyword == "minItems") node().minItems = count;
+                else node().maxItems = count;
+            }
+            else if (keyword != "$schema" && keyword != "$id" && keyword != "$comment" && keyword != "title" &&
+                keyword != "description" && keyword != "default" && keyword != "examples") {
+                return failCompile(result, at);
+            }
+        }
+
+        Node& done = node();
+        done.any = done.types == ALL_TYPES && done.properties.empty() && done.additional == ANY && done.items == ANY &&
+            !done.enumerated && !done.hasMinimum && !done.hasMaximum && done.minLength == 0 && done.maxLength == SIZE_MAX &&
+            done.minItems == 0 && done.maxItems == SIZE_MAX;
+
+        // "number" covers integers
+        if (done.types & typeBit(JSON_NUMBER)) done.types |= INTEGER_BIT;
+
+        return true;
+    }
+
+    JsonSchemaResult JsonSchema::parse(const char* data, size_t size, JsonObject& out, const JsonLimits& limits) const noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_PARSE);
+
+        out.reset();
+
+        JsonSchemaResult result = run(data, size, &out, limits);
+
+        if (!result.ok()) out.reset();
+
+        return result;
+    }
+
+    JsonSchemaResult JsonSchema::parse(const std::string& str, JsonObject& out, const JsonLimits& limits) const noexcept {
+        return parse(str.data(), str.size(), out, limits);
+    }
+
+    JsonSchemaResult JsonSchema::validate(const char* data, size_t size, const JsonLimits& limits) const noexcept {
+        JSONMINI_STAT_PHASE(JSON_PHASE_VALIDATE);
+        return run(data, size, nullptr, limits);
+    }
+
+    JsonSchemaResult JsonSchema::validate(const std::string& str, const JsonLimits& limits) const noexcept {
+        return validate(str.data(), str.size(), limits);
+    }
+
+    JsonSchemaResult JsonSchema::run(const char* data, size_t size, JsonObject* out, const JsonLimits& limits) const {
+        JsonReader reader(data, size, limits);
+        std::vector<Frame> stack;
+        JsonSchemaResult result;
+        size_t depth = 0;
+
+        // an uncompiled schema accepts anything
+        if (_nodes.empty()) {
+            if (out ? out->read(reader) : reader.skipValue()) {
+                if (!reader.atEnd()) reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+            }
+        }
+        else if (walk(reader, out, stack, result, depth) && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        JSONMINI_STAT(bytesRead += reader.pos());
+
+        if (reader.failed()) {
+            static_cast<JsonResult&>(result) = reader.result();
+            result.path = failurePath(data, size, limits, stack, stack.size());
+        }
+        else if (!result.ok()) {
+            result.path = failurePath(data, size, limits, stack, depth) + result.path;
+        }
+
+        return result;
+    }
+
+    // the traversal of JsonObject::read with every value checked against its schema node before it is kept;
+    // a violation fills in result with the number of frames leading to it, syntax errors are left in the reader
+    bool JsonSchema::walk(JsonReader& reader, JsonObject* value, std::vector<Frame>& stack, JsonSchemaResult& result, size_t& depth) const {
+        const Node* node = &_nodes[_root];
+        // scalars land here when no tree is built
+        JsonObject scratch;
+        std::string_view key;
+
+        auto violate = [&](JsonError error, size_t pos, size_t at) {
+            result.error = error;
+            result.pos = pos;
+            depth = at;
+            return false;
+        };
+
+        while (true) {
+            JsonType type;
+
+            if (!reader.peekType(type)) return false;
+
+            const size_t start = reader.pos();
+
+            if (!(node->types & (typeBit(type) | (type == JSON_NUMBER ? INTEGER_BIT : 0)))) {
+                return violate(JSON_ERROR_TYPE_MISMATCH, start, stack.size());
+            }
+
+            if (node->any) {
+                if (!(value ? value->read(reader) : reader.skipValue())) return false;
+            }
+            else if (type == JSON_MAP || type == JSON_ARRAY) {
+                // enum and const only hold scalars, no container can match them
+                if (node->enumerated) return violate(JSON_ERROR_VALUE_NOT_ALLOWED, start, stack.size());
+
+                if (!(type == JSON_MAP ? reader.beginMap() : reader.beginArray())) return false;
+
+                if (value) {
+                    value->_type = type;
+
+                    if (type == JSON_MAP) value->_map.mut();
+                    else value->_arr.mut();
+                }
+
+                stack.push_back(Frame{ node, value, 0, 0, 0, type == JSON_MAP, true });
+            }
+            else {
+                JsonObject& scalar = value ? *value : scratch;
+
+                scalar.touch();
+                scalar._type = type;
+
+                switch (type) {
+                    case JSON_STRING:
+                        if (!reader.readString(scalar._str)) return false;
+                        if (!checkString(*node, scalar._str)) return violate(JSON_ERROR_OUT_OF_BOUNDS, start, stack.size());
+                    break;
+                    case JSON_NUMBER:
+                        if (!reader.readNumber(scalar._num, scalar._long, scalar._realNum)) return false;
+
+                        if (!(node->types & typeBit(JSON_NUMBER)) && scalar._realNum && scalar._num != std::floor(scalar._num)) {
+                            return violate(JSON_ERROR_TYPE_MISMATCH, start, stack.size());
+                        }
+
+                        if (!checkNumber(*node, scalar._num)) return violate(JSON_ERROR_OUT_OF_BOUNDS, start, stack.size());
+                    break;
+                    case JSON_BOOLEAN:
+                        if (!reader.readBoolean(scalar._bool)) return false;
+                    break;
+                    default:
+                        if (!reader.readNull()) return false;
+                    break;
+                }
+
+                if (!checkEnum(*node, scalar)) return violate(JSON_ERROR_VALUE_NOT_ALLOWED, start, stack.size());
+            }
+
+            // closes finished containers until one has another element
+            node = nullptr;
+
+            while (!stack.empty()) {
+                Frame& frame = stack.back();
+
+                if (frame.map && reader.nextMember(frame.first)) {
+                    reader.peek();
+                    frame.keyPos = reader.pos();
+
+                    if (!reader.checkKeys(++frame.count) || !reader.readKey(key)) return false;
+
+                    auto property = frame.node->properties.find(key);
+                    size_t index = frame.node->additional;
+
+                    if (property != frame.node->properties.end()) {
+                        index = property->second.node;
+                        frame.seen |= property->second.bit;
+                    }
+                    else if (index == NEVER) {
+                        return violate(JSON_ERROR_KEY_NOT_ALLOWED, frame.keyPos, stack.size());
+                    }
+
+                    node = &_nodes[index];
+
+                    if (frame.container) {
+                        auto pair = frame.container->_map.mut().try_emplace(std::string(key));
+
+                        // duplicate keys keep the last value
+                        if (!pair.second) pair.first->second.reset();
+
+                        value = &pair.first->second;
+                    }
+
+                    break;
+                }
+
+                if (!frame.map && reader.nextItem(frame.first)) {
+                    reader.peek();
+
+                    if (frame.count++ == frame.node->maxItems) return violate(JSON_ERROR_OUT_OF_BOUNDS, reader.pos(), stack.size());
+
+                    node = &_nodes[frame.node->items];
+                    if (frame.container) value = &frame.container->_arr.mut().emplace_back();
+
+                    break;
+                }
+
+                if (reader.failed()) return false;
+
+                // the closing bracket has been consumed
+                const size_t end = reader.pos() - 1;
+
+                if (frame.map && (frame.seen & frame.node->required) != frame.node->required) {
+                    for (auto& property : frame.node->properties) {
+                        if (property.second.bit & ~frame.seen & frame.node->required) {
+                            result.path = "/" + JsonPatch::escapeToken(property.first);
+                            return violate(JSON_ERROR_REQUIRED_KEY_MISSING, end, stack.size() - 1);
+                        }
+                    }
+                }
+
+                if (!frame.map && frame.count < frame.node->minItems) {
+                    return violate(JSON_ERROR_OUT_OF_BOUNDS, end, stack.size() - 1);
+                }
+
+                stack.pop_back();
+            }
+
+            if (!node) return true;
+        }
+    }
+
+    bool JsonSchema::checkString(const Node& node, const std::string& str) const {
+        if (node.minLength == 0 && node.maxLength == SIZE_MAX) return true;
+
+        // a code point takes at least one byte and at most four
+        if (str.size() < node.minLength || str.size() / 4 > node.maxLength) return false;
+
+        size_t length = codePoints(str);
+        return length >= node.minLength && length <= node.maxLength;
+    }
+
+    bool JsonSchema::checkNumber(const Node& node, double value) const {
+        if (node.hasMinimum && (node.exclusiveMinimum ? value <= node.minimum : value < node.minimum)) return false;
+        if (node.hasMaximum && (node.exclusiveMaximum ? value >= node.maximum : value > node.maximum)) return false;
+
+        return true;
+    }
+
+    bool JsonSchema::checkEnum(const Node& node, const JsonObject& value) const {
+        if (!node.enumerated) return true;
+
+        for (auto& allowed : node.values) {
+            if (allowed == value) return true;
+        }
+
+        return false;
+    }
+
+    // keys are read again from the input only now, the walk keeps no copies of them
+    std::string JsonSchema::failurePath(const char* data, size_t size, const JsonLimits& limits,
+        const std::vector<Frame>& stack, size_t depth) {
+        std::string path;
+
+        for (size_t i = 0; i < depth; i++) {
+            const Frame& frame = stack[i];
+            if (frame.count == 0) break;
+
+            if (!frame.map) {
+                path += "/" + std::to_string(frame.count - 1);
+                continue;
+            }
+
+            JsonReader reader(data + frame.keyPos, size - frame.keyPos, limits);
+            std::string_view key;
+
+            if (!reader.readKey(key)) break;
+            path += "/" + JsonPatch::escapeToken(std::string(key));
+        }
+
+        return path;
+    }
+}
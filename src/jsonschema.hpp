@@ -0,0 +1,108 @@
+#ifndef JSONSCHEMA_HPP
+#define JSONSCHEMA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "jsonerror.hpp"
+#include "jsonlimits.hpp"
+#include "jsonobject.hpp"
+#include "jsonreader.hpp"
+
+namespace jsonmini {
+    // a failure also says where it happened, as a JSON Pointer into the input (or into the schema when compiling)
+    struct JsonSchemaResult : JsonResult {
+        std::string path;
+    };
+
+    // a compiled subset of JSON Schema checked while the input is read, the first violation stops the parse:
+    // type (with "integer"), properties, required, additionalProperties, items, enum and const of scalars,
+    // minimum, maximum, exclusiveMinimum, exclusiveMaximum, minLength, maxLength, minItems, maxItems;
+    // annotations such as title or description are ignored, any other keyword makes the schema invalid
+    class JsonSchema {
+    public:
+        static JsonSchemaResult compile(const JsonObject& schema, JsonSchema& out);
+
+        // parses and checks in one pass, out is reset to null on failure
+        JsonSchemaResult parse(const char* data, size_t size, JsonObject& out, const JsonLimits& limits = JsonLimits()) const noexcept;
+        JsonSchemaResult parse(const std::string& str, JsonObject& out, const JsonLimits& limits = JsonLimits()) const noexcept;
+
+        // the same checks without building a tree
+        JsonSchemaResult validate(const char* data, size_t size, const JsonLimits& limits = JsonLimits()) const noexcept;
+        JsonSchemaResult validate(const std::string& str, const JsonLimits& limits = JsonLimits()) const noexcept;
+
+        // at most that many required keys per map
+        static const size_t MAX_REQUIRED = 64;
+
+    private:
+        // node indices every schema has: one accepting anything, one accepting nothing
+        static const size_t ANY = 0;
+        static const size_t NEVER = 1;
+
+        // JsonType bits, integers are numbers without a fractional part
+        static const unsigned int INTEGER_BIT = 1u << 6;
+        static const unsigned int ALL_TYPES = 0x7f;
+
+        struct Property {
+            size_t node;
+            uint64_t bit;
+        };
+
+        struct Node {
+            unsigned int types = ALL_TYPES;
+            // nothing to check below this value, it is skipped or read as it is
+            bool any = true;
+
+            std::map<std::string, Property, std::less<>> properties;
+            uint64_t required = 0;
+            size_t additional = ANY;
+            size_t items = ANY;
+
+            std::vector<JsonObject> values;
+            bool enumerated = false;
+
+            double minimum = 0;
+            double maximum = 0;
+            bool hasMinimum = false;
+            bool hasMaximum = false;
+            bool exclusiveMinimum = false;
+            bool exclusiveMaximum = false;
+
+            size_t minLength = 0;
+            size_t maxLength = SIZE_MAX;
+            size_t minItems = 0;
+            size_t maxItems = SIZE_MAX;
+        };
+
+        struct Frame {
+            const Node* node;
+            // null while only validating
+            JsonObject* container;
+            size_t count;
+            // offset of the key of the current member, read again only to describe a failure
+            size_t keyPos;
+            uint64_t seen;
+            bool map;
+            bool first;
+        };
+
+        std::vector<Node> _nodes;
+        size_t _root = ANY;
+
+        bool compileNode(const JsonObject& schema, const std::string& path, size_t& index, JsonSchemaResult& result);
+
+        bool walk(JsonReader& reader, JsonObject* value, std::vector<Frame>& stack, JsonSchemaResult& result, size_t& depth) const;
+        bool checkString(const Node& node, const std::string& str) const;
+        bool checkNumber(const Node& node, double value) const;
+        bool checkEnum(const Node& node, const JsonObject& value) const;
+
+        JsonSchemaResult run(const char* data, size_t size, JsonObject* out, const JsonLimits& limits) const;
+        static std::string failurePath(const char* data, size_t size, const JsonLimits& limits,
+            const std::vector<Frame>& stack, size_t depth);
+    };
+}
+
+#endif
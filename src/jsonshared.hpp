@@ -0,0 +1,51 @@
+#ifndef JSONSHARED_HPP
+#define JSONSHARED_HPP
+
+#include <memory>
+
+namespace jsonmini {
+    // copy-on-write holder: copies share the value until one of them asks for write access
+    template<class T>
+    class JsonShared {
+    public:
+        // read access never copies, an unset holder reads as an empty value
+        const T& get() const {
+            return _ptr ? *_ptr : empty();
+        }
+
+        // detaches from the other owners before handing out a mutable reference
+        T& mut() {
+            if (!_ptr) _ptr = std::make_shared<T>();
+            else if (_ptr.use_count() > 1) _ptr = std::make_shared<T>(*_ptr);
+
+            return *_ptr;
+        }
+
+        void reset() {
+            _ptr.reset();
+        }
+
+        bool isSet() const {
+            return _ptr != nullptr;
+        }
+
+        bool isShared() const {
+            return _ptr.use_count() > 1;
+        }
+
+        // true if both holders point at the same value
+        bool sameAs(const JsonShared& other) const {
+            return _ptr == other._ptr;
+        }
+
+    private:
+        std::shared_ptr<T> _ptr;
+
+        static const T& empty() {
+            static const T value;
+            return value;
+        }
+    };
+}
+
+#endif
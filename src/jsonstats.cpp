@@ -0,0 +1,106 @@
+#include "jsonstats.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace jsonmini {
+    static thread_local JsonStats* _sink = nullptr;
+    static thread_local JsonStatsCallback _callback = nullptr;
+    static thread_local void* _user = nullptr;
+
+    thread_local JsonStatsPhase* JsonStatsPhase::_active = nullptr;
+
+    static uint64_t nowNanoseconds() {
+        auto since = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(since).count();
+    }
+
+    size_t JsonStats::totalNodes() const {
+        size_t total = 0;
+        for (size_t count : nodes) total += count;
+        return total;
+    }
+
+    void JsonStats::reset() {
+        *this = JsonStats();
+    }
+
+    JsonStats& JsonStats::operator +=(const JsonStats& other) {
+        bytesRead += other.bytesRead;
+        bytesWritten += other.bytesWritten;
+        maxDepth = std::max(maxDepth, other.maxDepth);
+        stringBytesRead += other.stringBytesRead;
+        stringBytesWritten += other.stringBytesWritten;
+        escapesRead += other.escapesRead;
+        escapesWritten += other.escapesWritten;
+        allocations += other.allocations;
+
+        for (size_t i = 0; i < 6; i++) nodes[i] += other.nodes[i];
+
+        for (size_t i = 0; i < JSON_PHASE_COUNT; i++) {
+            calls[i] += other.calls[i];
+            nanoseconds[i] += other.nanoseconds[i];
+        }
+
+        return *this;
+    }
+
+    void JsonStats::enter() {
+        reach(++_depth);
+    }
+
+    void JsonStats::leave() {
+        if (_depth > 0) _depth--;
+    }
+
+    void JsonStats::reach(size_t depth) {
+        if (depth > maxDepth) maxDepth = depth;
+    }
+
+    bool JsonStats::enabled() {
+#ifdef JSONMINI_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void JsonStats::setSink(JsonStats* sink) {
+        _sink = sink;
+    }
+
+    void JsonStats::setCallback(JsonStatsCallback callback, void* user) {
+        _callback = callback;
+        _user = user;
+    }
+
+    JsonStatsPhase::JsonStatsPhase(JsonPhase phase) : _phase(phase) {
+        // nested operations always report to the enclosing one
+        _collecting = (_active || _sink || _callback);
+        if (!_collecting) return;
+
+        _outer = _active;
+        _active = this;
+        _begin = nowNanoseconds();
+    }
+
+    JsonStatsPhase::~JsonStatsPhase() {
+        if (!_collecting) return;
+
+        uint64_t elapsed = nowNanoseconds() - _begin;
+
+        _stats.calls[_phase]++;
+        _stats.nanoseconds[_phase] += elapsed - _nested;
+        _active = _outer;
+
+        if (_outer) {
+            _outer->_stats += _stats;
+            _outer->_nested += elapsed;
+        }
+        else if (_sink) {
+            *_sink += _stats;
+        }
+
+        if (_callback) _callback(_phase, _stats, _user);
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef JSONSTATS_HPP
+#define JSONSTATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// hooks are only compiled in with JSONMINI_STATS defined (cmake -DJSONMINI_STATS=ON),
+// otherwise they expand to nothing and the parser and the writer are left untouched
+#ifdef JSONMINI_STATS
+#define JSONMINI_STAT(update) do { if (::jsonmini::JsonStats* _stats = ::jsonmini::JsonStats::current()) _stats->update; } while (0)
+#define JSONMINI_STAT_PHASE(phase) ::jsonmini::JsonStatsPhase _statsPhase(phase)
+#else
+#define JSONMINI_STAT(update) do { } while (0)
+#define JSONMINI_STAT_PHASE(phase) do { } while (0)
+#endif
+
+namespace jsonmini {
+    enum JsonPhase {
+        JSON_PHASE_PARSE,
+        JSON_PHASE_VALIDATE,
+        JSON_PHASE_SERIALIZE,
+        JSON_PHASE_COUNT
+    };
+
+    struct JsonStats;
+
+    // called on the thread that did the work, once per finished operation
+    typedef void (*JsonStatsCallback)(JsonPhase phase, const JsonStats& stats, void* user);
+
+    // work done by parsing and serialization on one thread
+    struct JsonStats {
+        size_t bytesRead = 0;          // input consumed by the parsers, rejected input included
+        size_t bytesWritten = 0;       // serialized output
+        size_t nodes[6] = {};          // values read, or written from a JsonObject tree, by JsonType
+        size_t maxDepth = 0;           // deepest container nesting, a root container is 1
+        size_t stringBytesRead = 0;    // string and key contents scanned by the reader, without quotes
+        size_t stringBytesWritten = 0; // string and key contents passed through escaping by the writer
+        size_t escapesRead = 0;        // escape sequences decoded
+        size_t escapesWritten = 0;     // escape sequences produced
+        size_t allocations = 0;        // heap blocks requested while building a tree, an estimate
+        size_t calls[JSON_PHASE_COUNT] = {};
+        uint64_t nanoseconds[JSON_PHASE_COUNT] = {}; // time of nested operations is only counted in their own phase
+
+        size_t totalNodes() const;
+        void reset();
+        JsonStats& operator +=(const JsonStats& other);
+
+        // nesting bookkeeping of the hooks
+        void enter();
+        void leave();
+        void reach(size_t depth);
+
+        // false if the library was built without JSONMINI_STATS, nothing is ever collected then
+        static bool enabled();
+
+        // collection is per thread and only happens while a sink or a callback is set
+        static void setSink(JsonStats* sink);
+        static void setCallback(JsonStatsCallback callback, void* user = nullptr);
+
+        // statistics of the operation running on this thread, null while nothing is collected
+        static JsonStats* current();
+
+    private:
+        size_t _depth = 0;
+    };
+
+    // scope of a parse, validation or serialization, hands its statistics over when it ends
+    class JsonStatsPhase {
+        friend struct JsonStats;
+    public:
+        explicit JsonStatsPhase(JsonPhase phase);
+        ~JsonStatsPhase();
+
+        JsonStatsPhase(const JsonStatsPhase&) = delete;
+        JsonStatsPhase& operator =(const JsonStatsPhase&) = delete;
+
+    private:
+        static thread_local JsonStatsPhase* _active;
+
+        JsonPhase _phase;
+        bool _collecting = false;
+        JsonStatsPhase* _outer = nullptr;
+        JsonStats _stats;
+        uint64_t _begin = 0;
+        uint64_t _nested = 0;
+    };
+
+    inline JsonStats* JsonStats::current() {
+        JsonStatsPhase* phase = JsonStatsPhase::_active;
+        return phase ? &phase->_stats : nullptr;
+    }
+}
+
+#endif
@@ -0,0 +1,423 @@
+#include "jsontape.hpp"
+
+#include "jsonobject.hpp"
+#include "jsonreader.hpp"
+#include <cstring>
+
+namespace jsonmini {
+    // word layout: tag in the top byte, 56-bit payload below it
+    //   'n' 't' 'f'  no payload
+    //   'l' 'd'      integer or double bits in the following word
+    //   '"'          offset of a 32-bit length, the bytes and a NUL in the string buffer
+    //   '[' '{'      element count (24 bits, saturated) and index past the closing word (32 bits)
+    //   ']' '}'      index of the opening word
+    // map members are a key string word followed by the value
+
+    static const uint64_t _PAYLOAD_MASK = ((uint64_t)1 << 56) - 1;
+    static const size_t _COUNT_SATURATED = 0xffffff;
+    static const size_t _MAX_END = UINT32_MAX;
+
+    JsonTapeView::JsonTapeView(const JsonTape* tape, size_t index) : _tape(tape), _index(index) { }
+
+    uint64_t JsonTapeView::word() const {
+        return _tape->_words[_index];
+    }
+
+    char JsonTapeView::tag() const {
+        return _tape ? JsonTape::wordTag(word()) : 'n';
+    }
+
+    bool JsonTapeView::valid() const {
+        return _tape != nullptr;
+    }
+
+    JsonType JsonTapeView::type() const {
+        switch (tag()) {
+            case '{': return JSON_MAP;
+            case '[': return JSON_ARRAY;
+            case '"': return JSON_STRING;
+            case 'l':
+            case 'd': return JSON_NUMBER;
+            case 't':
+            case 'f': return JSON_BOOLEAN;
+            default: return JSON_NULL;
+        }
+    }
+
+    size_t JsonTapeView::size() const {
+        switch (tag()) {
+            case '"':
+                return str().size();
+            case '[':
+            case '{':
+            {
+                size_t count = JsonTape::wordPayload(word()) >> 32;
+                if (count < _COUNT_SATURATED) return count;
+
+                count = 0;
+                for (auto it = begin(); it != end(); ++it) count++;
+                return count;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    bool JsonTapeView::isArray() const {
+        return tag() == '[';
+    }
+
+    bool JsonTapeView::isMap() const {
+        return tag() == '{';
+    }
+
+    bool JsonTapeView::isString() const {
+        return tag() == '"';
+    }
+
+    bool JsonTapeView::isNumber() const {
+        char t = tag();
+        return t == 'l' || t == 'd';
+    }
+
+    bool JsonTapeView::isBoolean() const {
+        char t = tag();
+        return t == 't' || t == 'f';
+    }
+
+    bool JsonTapeView::isNull() const {
+        return tag() == 'n';
+    }
+
+    std::string_view JsonTapeView::str() const {
+        if (!isString()) return std::string_view();
+        return _tape->stringAt(_index);
+    }
+
+    const char* JsonTapeView::c_str() const {
+        return isString() ? str().data() : "";
+    }
+
+    bool JsonTapeView::boolean() const {
+        return tag() == 't';
+    }
+
+    double JsonTapeView::number() const {
+        switch (tag()) {
+            case 'l':
+                return (double)(int64_t)_tape->_words[_index + 1];
+            case 'd':
+            {
+                double value;
+                std::memcpy(&value, &_tape->_words[_index + 1], sizeof(double));
+                return value;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    long JsonTapeView::numberLong() const {
+        if (tag() == 'l') return (long)(int64_t)_tape->_words[_index + 1];
+        return (long)number();
+    }
+
+    JsonTapeView JsonTapeView::operator [](size_t index) const {
+        if (!isArray()) return JsonTapeView();
+
+        for (auto it = begin(); it != end(); ++it) {
+            if (index-- == 0) return *it;
+        }
+
+        return JsonTapeView();
+    }
+
+    JsonTapeView JsonTapeView::operator [](std::string_view key) const {
+        JsonTapeView found;
+
+        if (!isMap()) return found;
+
+        for (auto it = begin(); it != end(); ++it) {
+            if (it.key() == key) found = *it;
+        }
+
+        return found;
+    }
+
+    bool JsonTapeView::hasKey(std::string_view key) const {
+        return (*this)[key].valid();
+    }
+
+    JsonTapeIterator JsonTapeView::begin() const {
+        char t = tag();
+
+        if (t != '[' && t != '{') return end();
+        return JsonTapeIterator(_tape, _index + 1, t == '{');
+    }
+
+    JsonTapeIterator JsonTapeView::end() const {
+        char t = tag();
+
+        if (t != '[' && t != '{') return JsonTapeIterator(_tape, _index, false);
+        return JsonTapeIterator(_tape, (uint32_t)JsonTape::wordPayload(word()) - 1, t == '{');
+    }
+
+    JsonObject JsonTapeView::toObject() const {
+        switch (tag()) {
+            case '[':
+            {
+                JsonObject obj = JsonObject::makeArray();
+                auto arr = obj.vector();
+
+                for (auto it = begin(); it != end(); ++it) {
+                    arr->push_back((*it).toObject());
+                }
+
+                return obj;
+            }
+            case '{':
+            {
+                JsonObject obj = JsonObject::makeMap();
+                auto map = obj.map();
+
+                for (auto it = begin(); it != end(); ++it) {
+                    (*map)[std::string(it.key())] = (*it).toObject();
+                }
+
+                return obj;
+            }
+            case '"':
+                return JsonObject(std::string(str()));
+            case 'l':
+                return JsonObject(numberLong());
+            case 'd':
+                return JsonObject(number());
+            case 't':
+            case 'f':
+                return JsonObject(boolean());
+            default:
+                return JsonObject();
+        }
+    }
+
+    JsonTapeIterator::JsonTapeIterator(const JsonTape* tape, size_t index, bool map)
+        : _tape(tape), _index(index), _map(map) { }
+
+    JsonTapeView JsonTapeIterator::operator *() const {
+        return JsonTapeView(_tape, _map ? _index + 1 : _index);
+    }
+
+    JsonTapeIterator& JsonTapeIterator::operator ++() {
+        _index = _tape->skip(_map ? _index + 1 : _index);
+        return *this;
+    }
+
+    bool JsonTapeIterator::operator ==(const JsonTapeIterator& other) const {
+        return _index == other._index;
+    }
+
+    bool JsonTapeIterator::operator !=(const JsonTapeIterator& other) const {
+        return _index != other._index;
+    }
+
+    std::string_view JsonTapeIterator::key() const {
+        if (!_map) return std::string_view();
+        return _tape->stringAt(_index);
+    }
+
+    JsonResult JsonTape::parse(const char* data, size_t size, JsonTape& out, const JsonLimits& limits) noexcept {
+        JsonReader reader(data, size, limits);
+
+        out.clear();
+
+        if (out.build(reader) && !reader.atEnd()) {
+            reader.reject(JSON_ERROR_UNEXPECTED_CHARACTER);
+        }
+
+        if (reader.failed()) out.clear();
+
+        return reader.result();
+    }
+
+    JsonResult JsonTape::parse(const std::string& str, JsonTape& out, const JsonLimits& limits) noexcept {
+        return parse(str.data(), str.size(), out, limits);
+    }
+
+    JsonTapeView JsonTape::root() const {
+        if (_words.empty()) return JsonTapeView();
+        return JsonTapeView(this, 0);
+    }
+
+    void JsonTape::clear() {
+        _words.clear();
+        _strings.clear();
+    }
+
+    size_t JsonTape::tapeSize() const {
+        return _words.size();
+    }
+
+    size_t JsonTape::stringsSize() const {
+        return _strings.size();
+    }
+
+    uint64_t JsonTape::makeWord(char tag, uint64_t payload) {
+        return ((uint64_t)(unsigned char)tag << 56) | (payload & _PAYLOAD_MASK);
+    }
+
+    char JsonTape::wordTag(uint64_t word) {
+        return (char)(word >> 56);
+    }
+
+    uint64_t JsonTape::wordPayload(uint64_t word) {
+        return word & _PAYLOAD_MASK;
+    }
+
+    bool JsonTape::build(JsonReader& reader) {
+        struct Frame {
+            size_t start;
+            size_t count;
+            bool map;
+            bool first;
+        };
+
+        // containers are tracked on an explicit stack so the tape is written in one forward pass
+        std::vector<Frame> stack;
+
+        while (true) {
+            JsonType type;
+
+            if (!reader.peekType(type)) return false;
+
+            switch (type) {
+                case JSON_MAP:
+                case JSON_ARRAY:
+                    // the reader enforces the depth limit
+                    if (type == JSON_MAP ? !reader.beginMap() : !reader.beginArray()) return false;
+
+                    stack.push_back(Frame { _words.size(), 0, type == JSON_MAP, true });
+                    _words.push_back(0);
+                break;
+                case JSON_STRING:
+                    if (!pushString(reader)) return false;
+                break;
+                case JSON_NUMBER:
+                {
+                    double num;
+                    long integer;
+                    bool real;
+
+                    if (!reader.readNumber(num, integer, real)) return false;
+
+                    if (real) {
+                        uint64_t bits;
+                        std::memcpy(&bits, &num, sizeof(bits));
+                        _words.push_back(makeWord('d', 0));
+                        _words.push_back(bits);
+                    }
+                    else {
+                        _words.push_back(makeWord('l', 0));
+                        _words.push_back((uint64_t)(int64_t)integer);
+                    }
+                }
+                break;
+                case JSON_BOOLEAN:
+                {
+                    bool value;
+
+                    if (!reader.readBoolean(value)) return false;
+                    _words.push_back(makeWord(value ? 't' : 'f', 0));
+                }
+                break;
+                default:
+                    if (!reader.readNull()) return false;
+                    _words.push_back(makeWord('n', 0));
+                break;
+            }
+
+            // close finished containers until one has another element to read
+            while (true) {
+                if (stack.empty()) return true;
+
+                Frame& frame = stack.back();
+                bool more = (frame.map ? reader.nextMember(frame.first) : reader.nextItem(frame.first));
+
+                if (more) {
+                    frame.count++;
+
+                    if (frame.map) {
+                        std::string_view key;
+
+                        if (!reader.checkKeys(frame.count) || !reader.readKey(key)) return false;
+                        if (!pushKey(reader, key)) return false;
+                    }
+
+                    break;
+                }
+
+                if (reader.failed()) return false;
+
+                size_t count = (frame.count < _COUNT_SATURATED ? frame.count : _COUNT_SATURATED);
+
+                // the index past the closing word has to fit the 32 bits below the count
+                if (_words.size() + 1 > _MAX_END) return reader.reject(JSON_ERROR_INPUT_TOO_LARGE);
+
+                _words.push_back(makeWord(frame.map ? '}' : ']', frame.start));
+                _words[frame.start] = makeWord(frame.map ? '{' : '[', ((uint64_t)count << 32) | _words.size());
+                stack.pop_back();
+            }
+        }
+    }
+
+    bool JsonTape::pushString(JsonReader& reader) {
+        size_t offset = _strings.size();
+        uint32_t size;
+
+        _strings.append(sizeof(size), '\0');
+        if (!reader.appendString(_strings)) return false;
+
+        if (_strings.size() - offset - sizeof(size) > UINT32_MAX) return reader.reject(JSON_ERROR_INPUT_TOO_LARGE);
+
+        size = _strings.size() - offset - sizeof(size);
+        std::memcpy(&_strings[offset], &size, sizeof(size));
+        _strings.push_back('\0');
+
+        _words.push_back(makeWord('"', offset));
+        return true;
+    }
+
+    bool JsonTape::pushKey(JsonReader& reader, std::string_view key) {
+        if (key.size() > UINT32_MAX) return reader.reject(JSON_ERROR_INPUT_TOO_LARGE);
+
+        size_t offset = _strings.size();
+        uint32_t size = key.size();
+
+        _strings.append((const char*)&size, sizeof(size));
+        _strings.append(key.data(), key.size());
+        _strings.push_back('\0');
+
+        _words.push_back(makeWord('"', offset));
+        return true;
+    }
+
+    size_t JsonTape::skip(size_t index) const {
+        switch (wordTag(_words[index])) {
+            case '[':
+            case '{':
+                return (uint32_t)wordPayload(_words[index]);
+            case 'l':
+            case 'd':
+                return index + 2;
+            default:
+                return index + 1;
+        }
+    }
+
+    std::string_view JsonTape::stringAt(size_t index) const {
+        size_t offset = wordPayload(_words[index]);
+        uint32_t size;
+
+        std::memcpy(&size, &_strings[offset], sizeof(size));
+        return std::string_view(_strings.data() + offset + sizeof(size), size);
+    }
+}
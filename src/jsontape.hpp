@@ -0,0 +1,122 @@
+#ifndef JSONTAPE_HPP
+#define JSONTAPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "jsonerror.hpp"
+#include "jsonlimits.hpp"
+#include "jsontype.hpp"
+
+namespace jsonmini {
+    class JsonObject;
+    class JsonReader;
+    class JsonTape;
+    class JsonTapeIterator;
+
+    // read-only accessor over a value of a tape, cheap to copy
+    class JsonTapeView {
+    public:
+        JsonTapeView() = default;
+
+        // false for views of missing elements
+        bool valid() const;
+
+        JsonType type() const;
+        size_t size() const;
+
+        bool isArray() const;
+        bool isMap() const;
+        bool isString() const;
+        bool isNumber() const;
+        bool isBoolean() const;
+        bool isNull() const;
+
+        std::string_view str() const;
+        const char* c_str() const;
+        bool boolean() const;
+        double number() const;
+        long numberLong() const;
+
+        // both are linear scans: an index steps over every item before it, a key is compared with every member;
+        // missing elements give an invalid null view, duplicate keys resolve to the last one
+        JsonTapeView operator [](size_t index) const;
+        JsonTapeView operator [](std::string_view key) const;
+        bool hasKey(std::string_view key) const;
+
+        // walks array items or map values in document order
+        JsonTapeIterator begin() const;
+        JsonTapeIterator end() const;
+
+        JsonObject toObject() const;
+
+    private:
+        friend class JsonTape;
+        friend class JsonTapeIterator;
+
+        const JsonTape* _tape = nullptr;
+        size_t _index = 0;
+
+        JsonTapeView(const JsonTape* tape, size_t index);
+        uint64_t word() const;
+        char tag() const;
+    };
+
+    class JsonTapeIterator {
+    public:
+        JsonTapeView operator *() const;
+        JsonTapeIterator& operator ++();
+        bool operator ==(const JsonTapeIterator& other) const;
+        bool operator !=(const JsonTapeIterator& other) const;
+
+        // key of the current member when iterating a map
+        std::string_view key() const;
+
+    private:
+        friend class JsonTapeView;
+
+        const JsonTape* _tape;
+        size_t _index;
+        bool _map;
+
+        JsonTapeIterator(const JsonTape* tape, size_t index, bool map);
+    };
+
+    // immutable document stored as a flat array of tagged 64-bit words plus one string buffer;
+    // a tape of more than UINT32_MAX words or a string longer than UINT32_MAX bytes fails with JSON_ERROR_INPUT_TOO_LARGE
+    class JsonTape {
+    public:
+        static JsonResult parse(const char* data, size_t size, JsonTape& out, const JsonLimits& limits = JsonLimits()) noexcept;
+        static JsonResult parse(const std::string& str, JsonTape& out, const JsonLimits& limits = JsonLimits()) noexcept;
+
+        JsonTapeView root() const;
+        void clear();
+
+        // words on the tape and bytes in the string buffer
+        size_t tapeSize() const;
+        size_t stringsSize() const;
+
+    private:
+        friend class JsonTapeView;
+        friend class JsonTapeIterator;
+
+        std::vector<uint64_t> _words;
+        std::string _strings;
+
+        static uint64_t makeWord(char tag, uint64_t payload);
+        static char wordTag(uint64_t word);
+        static uint64_t wordPayload(uint64_t word);
+
+        bool build(JsonReader& reader);
+        bool pushString(JsonReader& reader);
+        bool pushKey(JsonReader& reader, std::string_view key);
+
+        // index of the word following the value starting at index
+        size_t skip(size_t index) const;
+        std::string_view stringAt(size_t index) const;
+    };
+}
+
+#endif
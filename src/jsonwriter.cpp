@@ -0,0 +1,230 @@
+#include "jsonwriter.hpp"
+
+#include "jsonstats.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace jsonmini {
+    // escape sequences by byte, 'u' stands for \u00XX and 0 for no escaping
+    static const char _ESCAPE[256] = {
+        'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+        'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+        0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0
+    };
+
+    static const char _HEX[] = "0123456789abcdef";
+
+    // a line break followed by the widest indentation written in a single append
+    static const size_t _INDENT_SIZE = 256;
+
+    struct IndentBuffer {
+        char data[_INDENT_SIZE + 1] = {};
+
+        constexpr IndentBuffer(char c) {
+            data[0] = '\n';
+            for (size_t i = 1; i <= _INDENT_SIZE; i++) data[i] = c;
+        }
+    };
+
+    static constexpr IndentBuffer _TABS('\t');
+    static constexpr IndentBuffer _SPACES(' ');
+
+    JsonWriter::JsonWriter(std::string& out, const JsonStyle& style) : _out(out), _style(style), _begin(out.size()) { }
+
+    // nothing is reserved up front, the buffer grows with the output of small documents
+    // and keeps its capacity across syncs once it has reached the sync size
+    JsonWriter::JsonWriter(std::ostream& stream, const JsonStyle& style)
+        : _out(_buffer), _stream(&stream), _style(style) { }
+
+    JsonWriter::~JsonWriter() {
+        flush();
+        if (!_stream) JSONMINI_STAT(bytesWritten += _out.size() - _begin);
+    }
+
+    const JsonStyle& JsonWriter::style() const {
+        return _style;
+    }
+
+    void JsonWriter::put(char c) {
+        _out.push_back(c);
+    }
+
+    void JsonWriter::writeRaw(const char* data, size_t size) {
+        _out.append(data, size);
+    }
+
+    void JsonWriter::writeString(const char* data, size_t size) {
+        const char* end = data + size;
+        const char* run = data;
+
+        _out.push_back('"');
+
+        for (const char* p = data; p < end; p++) {
+            char esc = _ESCAPE[(unsigned char)*p];
+
+            if (esc == 0) continue;
+
+            _out.append(run, p - run);
+            run = p + 1;
+            JSONMINI_STAT(escapesWritten++);
+
+            if (esc == 'u') {
+                char seq[6] = { '\\', 'u', '0', '0', _HEX[(*p >> 4) & 0xf], _HEX[*p & 0xf] };
+                _out.append(seq, 6);
+            }
+            else {
+                char seq[2] = { '\\', esc };
+                _out.append(seq, 2);
+            }
+        }
+
+        _out.append(run, end - run);
+        _out.push_back('"');
+        JSONMINI_STAT(stringBytesWritten += size);
+    }
+
+    void JsonWriter::writeString(const std::string& str) {
+        writeString(str.data(), str.size());
+    }
+
+    // room for the longest number either formatter writes
+    static const size_t _NUMBER_SIZE = 32;
+
+    static char* formatNumber(char* at, long long value) {
+        return std::to_chars(at, at + _NUMBER_SIZE, value).ptr;
+    }
+
+    static char* formatNumber(char* at, long value) {
+        return std::to_chars(at, at + _NUMBER_SIZE, value).ptr;
+    }
+
+    static char* formatNumber(char* at, double value) {
+        // the sign of zero would be lost on an integer-looking "-0"
+        if (value == 0 && std::signbit(value)) {
+            std::memcpy(at, "-0.0", 4);
+            return at + 4;
+        }
+
+        // shortest form that parses back to the same double
+        return std::to_chars(at, at + _NUMBER_SIZE, value).ptr;
+    }
+
+    void JsonWriter::writeNumber(double value, bool real) {
+        if (!real) {
+            writeInteger((long long)value);
+            return;
+        }
+
+        char buff[_NUMBER_SIZE];
+        _out.append(buff, formatNumber(buff, value) - buff);
+    }
+
+    void JsonWriter::writeInteger(long long value) {
+        char buff[_NUMBER_SIZE];
+        _out.append(buff, formatNumber(buff, value) - buff);
+    }
+
+    template<class T>
+    void JsonWriter::writeItems(const T* values, size_t count, bool min, bool compact, unsigned int depth) {
+        std::string separator(1, ',');
+
+        if (compact) separator.push_back(' ');
+        else if (!min) appendNewLine(separator, depth);
+
+        // deep indentation goes straight to the output instead of through the block
+        bool buffered = separator.size() <= BLOCK_SIZE / 2;
+        char block[BLOCK_SIZE];
+        char* at = block;
+
+        for (size_t i = 0; i < count; i++) {
+            if (at + separator.size() + _NUMBER_SIZE > block + BLOCK_SIZE) {
+                _out.append(block, at - block);
+                at = block;
+                sync();
+            }
+
+            if (i > 0 && buffered) {
+                std::memcpy(at, separator.data(), separator.size());
+                at += separator.size();
+            }
+            else if (i > 0) {
+                _out.append(block, at - block);
+                _out.append(separator);
+                at = block;
+            }
+
+            at = formatNumber(at, values[i]);
+        }
+
+        _out.append(block, at - block);
+    }
+
+    void JsonWriter::writeIntegers(const long* values, size_t count, bool min, bool compact, unsigned int depth) {
+        writeItems(values, count, min, compact, depth);
+    }
+
+    void JsonWriter::writeReals(const double* values, size_t count, bool min, bool compact, unsigned int depth) {
+        writeItems(values, count, min, compact, depth);
+    }
+
+    void JsonWriter::writeBoolean(bool value) {
+        if (value) _out.append("true", 4);
+        else _out.append("false", 5);
+    }
+
+    void JsonWriter::writeNull() {
+        _out.append("null", 4);
+    }
+
+    void JsonWriter::writeNewLine(unsigned int depth) {
+        appendNewLine(_out, depth);
+    }
+
+    void JsonWriter::appendNewLine(std::string& out, unsigned int depth) const {
+        const char* indent = (_style.indentChar == ' ' ? _SPACES.data : _TABS.data);
+        size_t size = (size_t)depth * _style.indentWidth;
+
+        if (size <= _INDENT_SIZE) {
+            out.append(indent, size + 1);
+            return;
+        }
+
+        out.append(indent, _INDENT_SIZE + 1);
+        size -= _INDENT_SIZE;
+
+        while (size > 0) {
+            size_t chunk = (size < _INDENT_SIZE ? size : _INDENT_SIZE);
+            out.append(indent + 1, chunk);
+            size -= chunk;
+        }
+    }
+
+    void JsonWriter::sync() {
+        if (_stream && _marks == 0 && _buffer.size() >= SYNC_SIZE) flush();
+    }
+
+    void JsonWriter::flush() {
+        if (!_stream || _buffer.empty()) return;
+
+        _stream->write(_buffer.data(), _buffer.size());
+        JSONMINI_STAT(bytesWritten += _buffer.size());
+        _buffer.clear();
+    }
+
+    size_t JsonWriter::mark() {
+        _marks++;
+        return _out.size();
+    }
+
+    std::string_view JsonWriter::since(size_t mark) const {
+        return std::string_view(_out).substr(mark);
+    }
+
+    void JsonWriter::release() {
+        _marks--;
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef JSONWRITER_HPP
+#define JSONWRITER_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace jsonmini {
+    // non-minified output layout
+    struct JsonStyle {
+        char indentChar = '\t';          // '\t' or ' '
+        unsigned int indentWidth = 1;    // characters per nesting level
+        size_t compactArrayThreshold = 0; // arrays of at most that many scalars stay on one line
+    };
+
+    // appends JSON tokens to a string buffer, optionally draining it into a stream
+    class JsonWriter {
+    public:
+        explicit JsonWriter(std::string& out, const JsonStyle& style = JsonStyle());
+        explicit JsonWriter(std::ostream& stream, const JsonStyle& style = JsonStyle());
+        ~JsonWriter();
+
+        const JsonStyle& style() const;
+
+        void put(char c);
+        void writeRaw(const char* data, size_t size);
+        void writeString(const char* data, size_t size);
+        void writeString(const std::string& str);
+        void writeNumber(double value, bool real);
+        void writeInteger(long long value);
+        // items of a packed array, laid out as if written one by one: minified, after ", " on a compact line
+        // or one per line at depth; they are formatted into a block on the stack that is appended at once
+        void writeIntegers(const long* values, size_t count, bool min, bool compact, unsigned int depth);
+        void writeReals(const double* values, size_t count, bool min, bool compact, unsigned int depth);
+        void writeBoolean(bool value);
+        void writeNull();
+
+        // line break followed by the indentation of the given depth, written in one copy
+        void writeNewLine(unsigned int depth);
+
+        // hands the buffered output over to the stream once enough has been collected
+        void sync();
+        void flush();
+
+        // output written after a mark is held in the buffer until the mark is released,
+        // since() returns it for as long as the mark is open
+        size_t mark();
+        std::string_view since(size_t mark) const;
+        void release();
+
+    private:
+        static const size_t SYNC_SIZE = 64 * 1024;
+        static const size_t BLOCK_SIZE = 4 * 1024;
+
+        std::string _buffer;
+        std::string& _out;
+        std::ostream* _stream = nullptr;
+        JsonStyle _style;
+        unsigned int _marks = 0;
+
+        // size of the output when the writer was made, what it wrote is counted from there
+        size_t _begin = 0;
+
+        void appendNewLine(std::string& out, unsigned int depth) const;
+
+        template<class T>
+        void writeItems(const T* values, size_t count, bool min, bool compact, unsigned int depth);
+    };
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include <jsonbind.hpp>
+#include <jsonobjectexception.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+struct NextPage {
+    long id = 0;
+    long from = 0;
+};
+
+struct Profile {
+    std::string firstName;
+    int age = 0;
+    bool employed = false;
+    std::optional<std::string> transport;
+    std::vector<std::string> pets;
+    double popularityIndex = 0;
+    std::string aboutMe;
+};
+
+struct Page {
+    long requestId = 0;
+    double pageNum = 0;
+    NextPage nextPage;
+    std::vector<std::string> tags;
+    std::vector<std::string> languages;
+    std::vector<Profile> profiles;
+};
+
+JSONMINI_FIELDS(NextPage, id, from)
+JSONMINI_FIELDS(Profile, firstName, age, employed, transport, pets, popularityIndex, aboutMe)
+JSONMINI_FIELDS(Page, requestId, pageNum, nextPage, tags, languages, profiles)
+
+static void checkPage(const Page& page) {
+    assert(page.requestId == 5412985);
+    assert(page.pageNum == 80);
+    assert(page.nextPage.id == -1);
+    assert(page.tags.size() == 2);
+    assert(page.languages.size() == 7);
+    assert(page.languages[2] == "English");
+    assert(page.profiles.size() == 2);
+    assert(page.profiles[0].firstName == "Felix");
+    assert(page.profiles[0].age == 19);
+    assert(!page.profiles[0].transport);
+    assert(page.profiles[0].pets.size() == 3);
+    assert(page.profiles[0].aboutMe.front() == '\t');
+    assert(page.profiles[1].employed);
+    assert(page.profiles[1].transport == "Honda Civic");
+    assert(page.profiles[1].popularityIndex == 0.78);
+}
+
+int main() {
+    std::cout << "=== Binding test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    Page page;
+    decode(ss.str(), page);
+    checkPage(page);
+
+    std::string encoded = encode(page);
+    std::cout << encoded << std::endl;
+
+    Page copy;
+    decode(encoded, copy);
+    checkPage(copy);
+    assert(encode(copy) == encoded);
+
+    const char* malformed[] = {
+        "{\"id\": 1, \"from\": 2,}",
+        "{\"id\": \"1\"}",
+        "{\"id\": 1.5}",
+        "{\"id\": 1} []",
+        "{\"id\": 1"
+    };
+
+    for (auto json : malformed) {
+        NextPage next;
+
+        try {
+            decode(std::string(json), next);
+        }
+        catch (JsonObjectException& e) {
+            std::cout << e.what() << std::endl;
+            continue;
+        }
+
+        throw std::runtime_error("no JsonException has been caught!");
+    }
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <jsonobject.hpp>
+#include <jsonparser.hpp>
+#include <jsonpatch.hpp>
+#include <jsonstats.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+// linked against jsonmini_stats, written node counts tell cached subtrees from regenerated ones
+
+using namespace jsonmini;
+
+static std::string serialize(JsonObject& obj, size_t* nodes = nullptr) {
+    JsonStats stats;
+    JsonStats::setSink(&stats);
+
+    std::stringstream out;
+    obj >> out;
+
+    JsonStats::setSink(nullptr);
+    if (nodes) *nodes = stats.totalNodes();
+
+    return out.str();
+}
+
+// the cached output has to be the one the tree gives without the cache
+static size_t expectFresh(JsonObject& obj) {
+    obj.setSerializationCacheEnabled(false);
+    std::string expected = serialize(obj);
+
+    obj.setSerializationCacheEnabled(true);
+    size_t nodes;
+    std::string cached = serialize(obj, &nodes);
+    assert(cached == expected);
+
+    // an unchanged tree is one copy of the root, unless it is too short to be kept
+    size_t again;
+    cached = serialize(obj, &again);
+    assert(cached == expected && again == (expected.size() < JsonObject::CACHE_MIN_SIZE ? nodes : 1));
+
+    return nodes;
+}
+
+int main() {
+    std::cout << "=== Cache test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonResult result = JsonObject::parse(ss.str(), page);
+    assert(result.ok());
+
+    // a catalog of pages
+    JsonObject doc = JsonObject::makeArray();
+    for (size_t i = 0; i < 100; i++) doc[i] = page;
+
+    doc.setSerializationCacheEnabled(true);
+
+    size_t full = expectFresh(doc);
+    assert(doc.footprint().cacheBytes > 0);
+
+    // a changed leaf regenerates its path only, each sibling is one copy
+    doc[42]["name"] = "changed";
+    size_t partial = expectFresh(doc);
+    std::cout << "nodes written: " << full << " for the whole tree, " << partial << " after one change" << std::endl;
+    assert(partial < full / 4);
+
+    // every way of writing into the tree drops the cached bytes on the path it takes
+    doc[7].remove(std::string("name"));
+    expectFresh(doc);
+
+    doc[8].clear();
+    expectFresh(doc);
+
+    doc.vector()->push_back(JsonObject("appended"));
+    expectFresh(doc);
+
+    doc.get(9)->merge(JsonObject::makeMap());
+    result = doc.get(10)->mergeFrom("{\"name\":null,\"extra\":[1,2]}");
+    assert(result.ok());
+    expectFresh(doc);
+
+    JsonObject patch;
+    result = JsonObject::parse("[{\"op\":\"replace\",\"path\":\"/11\",\"value\":{\"v\":1}}]", patch);
+    assert(result.ok());
+    result = JsonPatch::apply(doc, patch);
+    assert(result.ok());
+    expectFresh(doc);
+
+    doc.remove(12);
+    expectFresh(doc);
+
+    // copies share the cached bytes until one of them changes
+    JsonObject copy = doc;
+    copy[0]["name"] = "only in the copy";
+    expectFresh(copy);
+    expectFresh(doc);
+    assert(serialize(copy) != serialize(doc));
+
+    // output settings are part of what was cached
+    doc.setMinificationEnabled(false);
+    expectFresh(doc);
+
+    JsonStyle style;
+    style.indentChar = ' ';
+    style.indentWidth = 2;
+    style.compactArrayThreshold = 4;
+    doc.setStyle(style);
+    expectFresh(doc);
+
+    doc.setNullPropertyIgnoringEnabled(true);
+    expectFresh(doc);
+
+    // a subtree serialized on its own is at another depth than inside of the tree
+    JsonObject& item = doc[3];
+    item.setMinificationEnabled(false);
+    item.setSerializationCacheEnabled(true);
+    expectFresh(item);
+    expectFresh(doc);
+
+    // every level of a deep tree is cached, each byte of the output is kept once and not once per level
+    std::string deepText;
+    for (size_t i = 0; i < 1000; i++) deepText += "{\"a\":[" + std::to_string(i) + ",";
+    deepText += "\"" + std::string(100000, 'x') + "\"";
+    for (size_t i = 0; i < 1000; i++) deepText += "]}";
+
+    JsonObject deep;
+    result = JsonObject::parse(deepText, deep);
+    assert(result.ok());
+
+    deep.setSerializationCacheEnabled(true);
+    expectFresh(deep);
+    size_t held = deep.footprint().cacheBytes;
+    std::cout << "cache held for " << deepText.size() << " bytes 1000 levels deep: " << held << " bytes" << std::endl;
+    // a copy per container would be 2000 times the string
+    assert(held < 4 * deepText.size());
+
+    JsonObject* level = &deep;
+    for (size_t i = 0; i < 500; i++) level = &(*level)["a"][1];
+    (*level)["a"][(size_t)0] = "changed";
+    expectFresh(deep);
+
+    // a document refilled by JsonParser is rewritten
+    JsonParser parser;
+    JsonDocument reused;
+    result = parser.parse(ss.str(), reused);
+    assert(result.ok());
+    reused.root().setSerializationCacheEnabled(true);
+    expectFresh(reused.root());
+    result = parser.parse("{\"title\":\"other\",\"list\":[1,2,3]}", reused);
+    assert(result.ok());
+    expectFresh(reused.root());
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <jsoncbor.hpp>
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <climits>
+
+using namespace jsonmini;
+
+static std::string minified(JsonObject& obj) {
+    std::stringstream ss;
+    obj.setMinificationEnabled(true);
+    obj >> ss;
+    return ss.str();
+}
+
+int main() {
+    std::cout << "=== CBOR test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonResult result = JsonObject::parse(ss.str(), page);
+    assert(result.ok());
+
+    std::string cbor = JsonCbor::encode(page);
+    std::string text = minified(page);
+
+    JsonObject decoded;
+    result = JsonCbor::decode(cbor, decoded);
+    assert(result.ok());
+    assert(minified(decoded) == text);
+    assert(JsonCbor::encode(decoded) == cbor);
+
+    std::cout << "page.json: " << text.size() << " bytes as text, " << cbor.size() << " bytes as CBOR" << std::endl;
+
+    // values a double cannot carry through text and back
+    std::string exact = "[9007199254740993, -9223372036854775808, 9223372036854775807, 0.1, 2.0, -1.5e-300, 0]";
+    JsonObject numbers;
+    result = JsonObject::parse(exact, numbers);
+    assert(result.ok());
+
+    result = JsonCbor::decode(JsonCbor::encode(numbers), decoded);
+    assert(result.ok());
+    assert(decoded[(size_t)0].numberLong() == 9007199254740993L);
+    assert(decoded[1].numberLong() == LONG_MIN);
+    assert(decoded[2].numberLong() == LONG_MAX);
+    assert(decoded[3].number() == 0.1);
+    assert(decoded[6].numberLong() == 0);
+    assert(minified(decoded) == minified(numbers));
+
+    // RFC 8949 appendix A vectors
+    const unsigned char half[] = { 0xf9, 0x3c, 0x00 };
+    result = JsonCbor::decode((const char*)half, sizeof(half), decoded);
+    assert(result.ok() && decoded.number() == 1.0);
+
+    const unsigned char nested[] = { 0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03 };
+    result = JsonCbor::decode((const char*)nested, sizeof(nested), decoded);
+    assert(result.ok());
+    assert(minified(decoded) == "{\"a\":1,\"b\":[2,3]}");
+
+    // malformed input
+    result = JsonCbor::decode(cbor.data(), cbor.size() - 1, decoded);
+    assert(result.error == JSON_ERROR_UNEXPECTED_END && decoded.isNull());
+
+    const unsigned char intKey[] = { 0xa1, 0x01, 0x02 };
+    result = JsonCbor::decode((const char*)intKey, sizeof(intKey), decoded);
+    assert(result.error == JSON_ERROR_KEY_EXPECTED);
+
+    const unsigned char hugeArray[] = { 0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+    result = JsonCbor::decode((const char*)hugeArray, sizeof(hugeArray), decoded);
+    assert(result.error == JSON_ERROR_UNEXPECTED_END);
+
+    // JSON has no NaN or Infinity, and text must be UTF-8 as in JsonReader
+    const unsigned char halfNan[] = { 0xf9, 0x7e, 0x00 };
+    result = JsonCbor::decode((const char*)halfNan, sizeof(halfNan), decoded);
+    assert(result.error == JSON_ERROR_NUMBER_OUT_OF_RANGE && result.pos == 0);
+
+    const unsigned char singleInf[] = { 0x81, 0xfa, 0x7f, 0x80, 0x00, 0x00 };
+    result = JsonCbor::decode((const char*)singleInf, sizeof(singleInf), decoded);
+    assert(result.error == JSON_ERROR_NUMBER_OUT_OF_RANGE && result.pos == 1);
+
+    const unsigned char doubleInf[] = { 0xfb, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    result = JsonCbor::decode((const char*)doubleInf, sizeof(doubleInf), decoded);
+    assert(result.error == JSON_ERROR_NUMBER_OUT_OF_RANGE);
+
+    const unsigned char badText[] = { 0x82, 0x01, 0x63, 'a', 0xff, 'b' };
+    result = JsonCbor::decode((const char*)badText, sizeof(badText), decoded);
+    assert(result.error == JSON_ERROR_INVALID_UTF8 && result.pos == 4 && decoded.isNull());
+
+    const unsigned char badKey[] = { 0xa1, 0x62, 0xc3, 'x', 0x01 };
+    result = JsonCbor::decode((const char*)badKey, sizeof(badKey), decoded);
+    assert(result.error == JSON_ERROR_INVALID_UTF8 && result.pos == 3);
+
+    const unsigned char cutText[] = { 0x62, 'a', 0xe2 };
+    result = JsonCbor::decode((const char*)cutText, sizeof(cutText), decoded);
+    assert(result.error == JSON_ERROR_INVALID_UTF8 && result.pos == 2);
+
+    const unsigned char goodText[] = { 0x64, 0xe2, 0x82, 0xac, '!' };
+    result = JsonCbor::decode((const char*)goodText, sizeof(goodText), decoded);
+    assert(result.ok() && decoded.str() == "\xe2\x82\xac!");
+
+    // encoding takes no call stack per level, decoding stops at MAX_DEPTH
+    JsonLimits limits;
+    limits.maxDepth = JsonLimits::UNLIMITED;
+
+    const size_t deepDepth = 200000;
+    JsonObject deep;
+    result = JsonObject::parse(std::string(deepDepth, '[') + "1" + std::string(deepDepth, ']'), deep, limits);
+    assert(result.ok());
+
+    std::string deepCbor = JsonCbor::encode(deep);
+    assert(deepCbor == std::string(deepDepth, (char)0x81) + (char)0x01);
+
+    result = JsonCbor::decode(deepCbor, decoded);
+    assert(result.error == JSON_ERROR_DEPTH_EXCEEDED && result.pos == JsonCbor::MAX_DEPTH);
+
+    // a long run of tags is skipped without nesting
+    std::string tags(2000000, (char)0xc0);
+    result = JsonCbor::decode(tags + (char)0xf6, decoded);
+    assert(result.ok() && decoded.isNull());
+
+    result = JsonCbor::decode(tags, decoded);
+    assert(result.error == JSON_ERROR_UNEXPECTED_END);
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static size_t countNodes(const JsonObject& obj) {
+    size_t count = 1;
+
+    if (auto arr = obj.asVector()) {
+        for (auto& item : *arr) count += countNodes(item);
+    }
+
+    if (auto map = obj.asMap()) {
+        for (auto& pair : *map) count += countNodes(pair.second);
+    }
+
+    return count;
+}
+
+int main() {
+    std::cout << "=== Footprint test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(ss.str(), obj);
+    assert(result.ok());
+
+    JsonFootprint before = obj.footprint();
+
+    assert(before.nodes == countNodes(obj));
+    assert(before.nodeBytes == before.nodes * sizeof(JsonObject));
+    assert(before.stringBytes > 0 && before.containerBytes > 0);
+    assert(before.total() > before.nodeBytes);
+
+    std::cout << "nodes: " << before.nodes << ", allocations: " << before.allocations
+        << ", total: " << before.total() << " bytes, slack: " << before.slackBytes << " bytes" << std::endl;
+
+    std::stringstream expected, actual;
+    obj >> expected;
+
+    obj.shrinkToFit();
+
+    JsonFootprint after = obj.footprint();
+    obj >> actual;
+
+    assert(after.nodes == before.nodes);
+    assert(after.slackBytes < before.slackBytes);
+    assert(after.total() <= before.total());
+    assert(expected.str() == actual.str());
+
+    std::cout << "after shrinkToFit: " << after.total() << " bytes, slack: " << after.slackBytes << " bytes" << std::endl;
+
+    JsonObject str(std::string(100, 'x'));
+    JsonFootprint strFp = str.footprint();
+    assert(strFp.allocations == 1 && strFp.stringBytes >= 101);
+    assert(JsonObject("short").footprint().allocations == 0);
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <jsonimage.hpp>
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <cstdio>
+
+using namespace jsonmini;
+
+static std::string minified(JsonObject& obj) {
+    std::stringstream ss;
+    obj.setMinificationEnabled(true);
+    obj >> ss;
+    return ss.str();
+}
+
+int main() {
+    std::cout << "=== Image test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonResult result = JsonObject::parse(ss.str(), page);
+    assert(result.ok());
+
+    const char* path = "page_image.bin";
+    bool written = JsonImage::write(page, path);
+    assert(written);
+
+    JsonImage image;
+    result = image.open(path);
+    assert(result.ok() && image.verify());
+
+    JsonView root = image.root();
+    assert(root.isMap() && root.size() == 8);
+    assert(root["requestId"].numberLong() == 5412985);
+    assert(!root["missing"].valid() && !root.hasKey("missing"));
+    assert(root.hasKey("profiles"));
+
+    JsonView profiles = root["profiles"];
+    assert(profiles.isArray());
+    assert(profiles[1]["transport"].str() == "Honda Civic");
+    assert(!profiles[2].valid());
+
+    for (size_t i = 1; i < root.size(); i++) assert(root.key(i - 1) < root.key(i));
+
+    JsonObject restored = root.toObject();
+    assert(minified(restored) == minified(page));
+
+    std::cout << "page.json: " << minified(page).size() << " bytes as text" << std::endl;
+
+    // damaged images are refused by the header check or by verify
+    std::string bytes;
+    written = JsonImage::write(page, bytes);
+    assert(written);
+
+    JsonImage memory;
+    result = memory.open(bytes.data(), bytes.size());
+    assert(result.ok() && memory.verify());
+    assert(memory.root()["requestId"].numberLong() == 5412985);
+
+    result = memory.open(bytes.data(), 16);
+    assert(result.error == JSON_ERROR_UNEXPECTED_END);
+
+    std::string broken = bytes;
+    broken[0] = 'X';
+    result = memory.open(broken.data(), broken.size());
+    assert(result.error == JSON_ERROR_UNSUPPORTED_ITEM);
+
+    broken = bytes;
+    broken[24] = (char)0xff; // root slot payload offset
+    result = memory.open(broken.data(), broken.size());
+    assert(result.ok() && !memory.verify());
+
+    JsonObject scalar(3.25);
+    written = JsonImage::write(scalar, bytes);
+    assert(written);
+    result = memory.open(bytes.data(), bytes.size());
+    assert(result.ok() && memory.verify());
+    assert(memory.root().isNumber() && memory.root().number() == 3.25);
+
+    // files that cannot be read are told apart from images that are cut short
+    JsonImage unopened;
+    result = unopened.open("no_such_image.bin");
+    assert(result.error == JSON_ERROR_IO);
+
+    result = unopened.open(".");
+    assert(result.error == JSON_ERROR_IO);
+
+    std::ofstream(path, std::ios_base::trunc).close();
+    result = unopened.open(path);
+    assert(result.error == JSON_ERROR_UNEXPECTED_END);
+
+    std::remove(path);
+    std::cout << std::endl;
+
+    return 0;
+}
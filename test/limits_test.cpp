@@ -0,0 +1,131 @@
+#include <jsonobject.hpp>
+#include <jsonobjectexception.hpp>
+#include <jsontape.hpp>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+// the buffer parser, validation, the tape and the stream parser must fail the same way
+static void expectFailure(const std::string& text, const JsonLimits& limits, JsonError error, size_t pos) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(text, obj, limits);
+    assert(result.error == error && result.pos == pos);
+    assert(obj.isNull());
+
+    result = JsonObject::validate(text, limits);
+    assert(result.error == error && result.pos == pos);
+
+    JsonTape tape;
+    result = JsonTape::parse(text, tape, limits);
+    assert(result.error == error && result.pos == pos);
+
+    std::stringstream input(text);
+    bool thrown = false;
+
+    try {
+        obj.readStream(input, limits);
+    }
+    catch (const JsonObjectException& e) {
+        assert(std::string(e.what()).find(errorMessage(error)) == 0 && e.pos() == pos);
+        thrown = true;
+    }
+
+    assert(thrown);
+    std::cout << errorMessage(error) << " at " << pos << std::endl;
+}
+
+static void expectSuccess(const std::string& text, const JsonLimits& limits) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(text, obj, limits);
+    assert(result.ok());
+
+    result = JsonObject::validate(text, limits);
+    assert(result.ok());
+
+    JsonTape tape;
+    result = JsonTape::parse(text, tape, limits);
+    assert(result.ok());
+
+    std::stringstream input(text);
+    JsonObject streamed;
+    streamed.readStream(input, limits);
+    assert(streamed == obj);
+}
+
+int main() {
+    std::cout << "=== Limits test ===" << std::endl;
+
+    JsonLimits limits;
+
+    // nesting
+    limits.maxDepth = 3;
+    expectSuccess("[[[1]],{\"a\":[]}]", limits);
+    expectFailure("[[[[1]]]]", limits, JSON_ERROR_DEPTH_EXCEEDED, 3);
+    expectFailure("{\"a\":{\"b\":[ {}]}}", limits, JSON_ERROR_DEPTH_EXCEEDED, 12);
+
+    // the default stops hostile nesting before the stack is at risk
+    std::string deep = std::string(4096, '[') + std::string(4096, ']');
+    expectSuccess(deep, JsonLimits());
+    deep = std::string(100000, '[') + std::string(100000, ']');
+    expectFailure(deep, JsonLimits(), JSON_ERROR_DEPTH_EXCEEDED, 4096);
+
+    // a raised limit holds past the levels validation keeps on the stack, merging validates first
+    std::string mixed;
+    for (int i = 0; i < 2500; i++) mixed += "{\"a\":[";
+    mixed += "1";
+    for (int i = 0; i < 2500; i++) mixed += "],\"b\":2}";
+
+    limits.maxDepth = 5000;
+    limits.maxKeys = 2;
+    expectSuccess(mixed, limits);
+
+    JsonObject merged = JsonObject::makeMap();
+    JsonResult result = merged.mergeFrom(mixed, limits);
+    assert(result.ok() && merged["b"].numberLong() == 2 && merged["a"][(size_t)0]["a"].isArray());
+
+    limits.maxDepth = 4999;
+    expectFailure(mixed, limits, JSON_ERROR_DEPTH_EXCEEDED, 4998 / 2 * 6 + 5);
+
+    limits.maxDepth = 5000;
+    limits.maxKeys = 1;
+    expectFailure(mixed, limits, JSON_ERROR_TOO_MANY_KEYS, 2500 * 6 + 3);
+
+    // whole input
+    limits = JsonLimits();
+    limits.maxBytes = 10;
+    expectSuccess("[1, 2, 3 ]", limits);
+    expectFailure("[1, 2, 3, 4]", limits, JSON_ERROR_INPUT_TOO_LARGE, 10);
+
+    // strings and keys, escapes count as written
+    limits = JsonLimits();
+    limits.maxStringLength = 4;
+    expectSuccess("{\"abcd\":\"\\n\\t\",\"k\":\"wxyz\"}", limits);
+    expectFailure("[\"abcde\"]", limits, JSON_ERROR_STRING_TOO_LONG, 6);
+    expectFailure("{\"abcde\":1}", limits, JSON_ERROR_STRING_TOO_LONG, 6);
+    expectFailure("[\"ab\\n\\t\"]", limits, JSON_ERROR_STRING_TOO_LONG, 6);
+
+    // values of any type, keys excluded
+    limits = JsonLimits();
+    limits.maxNodes = 5;
+    expectSuccess("{\"a\":[1,null],\"b\":true}", limits);
+    expectFailure("{\"a\":[1,null],\"b\":true,\"c\":\"x\"}", limits, JSON_ERROR_TOO_MANY_NODES, 27);
+    expectFailure("[[],[],[],[],[]]", limits, JSON_ERROR_TOO_MANY_NODES, 13);
+
+    // members of one map, duplicates included
+    limits = JsonLimits();
+    limits.maxKeys = 2;
+    expectSuccess("{\"a\":{\"x\":1,\"y\":2},\"b\":{\"z\":3}}", limits);
+    expectFailure("{\"a\":1,\"a\":2,\"a\":3}", limits, JSON_ERROR_TOO_MANY_KEYS, 13);
+    expectFailure("[{\"a\":1, \"b\":{}, \"c\":null}]", limits, JSON_ERROR_TOO_MANY_KEYS, 17);
+
+    // a violation wins over a later syntax error
+    limits = JsonLimits();
+    limits.maxDepth = 1;
+    expectFailure("[[1,,]", limits, JSON_ERROR_DEPTH_EXCEEDED, 1);
+
+    std::cout << std::endl;
+
+    return 0;
+}
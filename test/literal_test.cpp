@@ -0,0 +1,187 @@
+#include <jsonliteral.hpp>
+#include <jsonobject.hpp>
+#include <jsonobjectexception.hpp>
+#include <jsonwriter.hpp>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cassert>
+
+using namespace jsonmini;
+
+static constexpr auto CONFIG = JSONMINI_JSON(R"({
+    "name": "jsonmini",
+    "port": 8080,
+    "ratio": 0.25,
+    "debug": false,
+    "hosts": ["alpha", "beta", "gamma"],
+    "limits": { "depth": 64, "scale": -1.5e3 },
+    "note": "tab\there, \u00e9 and \ud83d\ude00",
+    "empty": {},
+    "port": 9090
+})");
+
+static constexpr auto ERROR_BODY = JSONMINI_JSON(R"({"error": {"code": 404, "message": "not found"}})");
+
+// everything below is answered by the compiler
+static_assert(CONFIG.root().isMap() && CONFIG.root().size() == 9);
+static_assert(CONFIG.root()["name"].str() == "jsonmini");
+static_assert(CONFIG.root()["port"].numberLong() == 9090);
+static_assert(CONFIG.root()["ratio"].number() == 0.25);
+static_assert(CONFIG.root()["limits"]["scale"].number() == -1500);
+static_assert(CONFIG.root()["hosts"][2].str() == "gamma");
+static_assert(!CONFIG.root()["hosts"][3].valid());
+static_assert(CONFIG.root()["debug"].isBoolean() && !CONFIG.root()["debug"].boolean());
+static_assert(CONFIG.root()["note"].str() == "tab\there, \xc3\xa9 and \xf0\x9f\x98\x80");
+static_assert(CONFIG.root()["empty"].isMap() && CONFIG.root()["empty"].size() == 0);
+static_assert(!CONFIG.root().hasKey("missing"));
+static_assert(ERROR_BODY.minified() == R"({"error":{"code":404,"message":"not found"}})");
+static_assert(ERROR_BODY.root()["error"].minified() == R"({"code":404,"message":"not found"})");
+
+// the same text laid out at run time, to compare a literal with a parse of arbitrary input
+struct RuntimeLiteral {
+    std::vector<JsonLiteralNode> nodes;
+    std::string text;
+    std::string strings;
+
+    explicit RuntimeLiteral(const std::string& json) {
+        JsonLiteralSizes sizes = JsonLiteralParser(json).parse();
+
+        nodes.resize(sizes.nodes);
+        text.resize(sizes.text);
+        strings.resize(sizes.strings);
+        JsonLiteralParser(json, nodes.data(), &text[0], &strings[0]).parse();
+    }
+
+    JsonLiteralView root() const {
+        return JsonLiteralView(nodes.data(), text.data(), strings.data(), 0);
+    }
+};
+
+static void expectSame(const JsonLiteralView& view, const JsonObject& obj) {
+    assert(view.type() == obj.type());
+
+    switch (view.type()) {
+        case JSON_MAP:
+        {
+            auto map = obj.asMap();
+            assert(view.size() >= map->size());
+
+            for (auto& member : *map) expectSame(view[member.first], member.second);
+        }
+        break;
+        case JSON_ARRAY:
+        {
+            assert(view.size() == obj.size());
+
+            for (size_t i = 0; i < obj.size(); i++) expectSame(view[i], obj.itemAt(i));
+        }
+        break;
+        case JSON_STRING:
+            assert(view.str() == obj.str());
+        break;
+        case JSON_NUMBER:
+            assert(view.number() == obj.number() && std::signbit(view.number()) == std::signbit(obj.number()));
+            assert(view.numberLong() == obj.numberLong());
+        break;
+        case JSON_BOOLEAN:
+            assert(view.boolean() == obj.boolean());
+        break;
+        default:
+        break;
+    }
+}
+
+static void expectValid(const std::string& text) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(text, obj);
+    assert(result.ok());
+
+    RuntimeLiteral literal(text);
+    expectSame(literal.root(), obj);
+    assert(literal.root().toObject() == obj);
+}
+
+static void expectInvalid(const std::string& text) {
+    bool thrown = false;
+
+    try {
+        JsonLiteralParser(text).parse();
+    }
+    catch (const JsonObjectException& e) {
+        std::cout << text << ": " << e.what() << std::endl;
+        thrown = true;
+    }
+
+    assert(thrown);
+}
+
+int main() {
+    std::cout << "=== Literal test ===" << std::endl;
+
+    // a literal reads like the parsed text, duplicate keys included
+    JsonObject config = CONFIG.toObject();
+    assert(config["port"].numberLong() == 9090);
+    expectSame(CONFIG.root(), config);
+
+    JsonObject parsed;
+    JsonResult result = JsonObject::parse(std::string(CONFIG.minified()), parsed);
+    assert(result.ok());
+    assert(parsed == config);
+
+    // the pre-serialized form goes out as it is
+    std::string out;
+    {
+        JsonWriter writer(out);
+        ERROR_BODY.write(writer);
+    }
+    assert(out == ERROR_BODY.minified());
+
+    std::stringstream stream;
+    CONFIG.root()["hosts"] >> stream;
+    assert(stream.str() == "[\"alpha\",\"beta\",\"gamma\"]");
+
+    // iteration in document order
+    std::string keys;
+    for (auto it = CONFIG.root().begin(); it != CONFIG.root().end(); ++it) keys += std::string(it.key()) + ",";
+    assert(keys == "name,port,ratio,debug,hosts,limits,note,empty,port,");
+
+    // numbers, both the ones the compiler converts and the ones converted from the text
+    const char* numbers[] = {
+        "0", "-0", "-0.0", "12345678901234567", "9223372036854775807", "-9223372036854775808",
+        "9223372036854775808", "123456789012345678901234567890", "0.1", "3.14159", "1e22", "1e23",
+        "2.5E-3", "1.7976931348623157e307", "2.2250738585072014e-307", "0.30000000000000004",
+        "9007199254740993", "9007199254740993.0", "4.35679e-5", "100e-2"
+    };
+
+    for (const char* number : numbers) {
+        expectValid(number);
+        expectValid(std::string("[") + number + "]");
+    }
+
+    static_assert(JSONMINI_JSON("1e22").root().number() == 1e22);
+    static_assert(JSONMINI_JSON("-0.1").root().number() == -0.1);
+    static_assert(JSONMINI_JSON("-9223372036854775808").root().numberLong() == INT64_MIN);
+
+    expectValid("\"\\\"\\\\\\/\\b\\f\\n\\r\\t\\u0041\\u00ff\\u20ac\\ud834\\udd1e\"");
+    expectValid("{\"a\":[1,{\"b\":null}],\"c\":\"\xe2\x82\xac\",\"a\":true}");
+    expectValid(" [ ] ");
+
+    // the compile-time grammar rejects what the parser rejects
+    const char* malformed[] = {
+        "", "{", "[1,]", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "[1 2]", "01", "-", "1.", "1e", ".5",
+        "tru", "nul", "\"abc", "\"\\x\"", "\"\\u12g4\"", "\"\\ud800\"", "\"\\udc00\"", "\"\\ud800\\u0041\"",
+        "\"\x01\"", "\"\xff\"", "\"\xc3\"", "1e400", "-1e400", "1e-400", "[1] 2"
+    };
+
+    for (const char* text : malformed) {
+        result = JsonObject::parse(text, parsed);
+        assert(!result.ok());
+        expectInvalid(text);
+    }
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#ifndef LOOPBACKSERVER_HPP
+#define LOOPBACKSERVER_HPP
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <istream>
+#include <map>
+#include <string>
+#include <thread>
+
+// an HTTP/1.1 stand-in on 127.0.0.1 for tests and benchmarks that must run offline:
+// GET of a known path answers with its JSON body and closes the connection
+class LoopbackServer {
+public:
+    // bytesPerSecond paces the body like a slower link, 0 sends it as fast as the socket takes it
+    explicit LoopbackServer(const std::map<std::string, std::string>& routes, size_t bytesPerSecond = 0)
+        : _routes(routes), _bytesPerSecond(bytesPerSecond) {
+        _listener = socket(AF_INET, SOCK_STREAM, 0);
+        assert(_listener >= 0);
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+
+        // benchmarks build without assertions, the calls stay outside of them
+        socklen_t size = sizeof(addr);
+        int bound = bind(_listener, (sockaddr*)&addr, size);
+        int listening = listen(_listener, 16);
+        int named = getsockname(_listener, (sockaddr*)&addr, &size);
+        assert(bound == 0 && listening == 0 && named == 0);
+
+        _port = ntohs(addr.sin_port);
+        _thread = std::thread(&LoopbackServer::run, this);
+    }
+
+    ~LoopbackServer() {
+        // wakes the blocked accept
+        shutdown(_listener, SHUT_RDWR);
+        _thread.join();
+        close(_listener);
+    }
+
+    int port() const {
+        return _port;
+    }
+
+private:
+    std::map<std::string, std::string> _routes;
+    size_t _bytesPerSecond;
+    int _listener;
+    int _port;
+    std::thread _thread;
+
+    void run() {
+        while (true) {
+            int client = accept(_listener, nullptr, nullptr);
+            if (client < 0) return;
+
+            serve(client);
+            close(client);
+        }
+    }
+
+    void serve(int client) {
+        std::string request;
+        char buffer[4096];
+
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            ssize_t size = recv(client, buffer, sizeof(buffer), 0);
+            if (size <= 0) return;
+
+            request.append(buffer, size);
+        }
+
+        // "GET /path HTTP/1.1"
+        size_t begin = request.find(' ') + 1;
+        std::string path = request.substr(begin, request.find(' ', begin) - begin);
+
+        auto route = _routes.find(path);
+        bool found = route != _routes.end();
+        const std::string body = found ? route->second : "{\"error\":\"not found\"}";
+
+        std::string head = std::string(found ? "HTTP/1.1 200 OK" : "HTTP/1.1 404 Not Found") +
+            "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+
+        if (!sendAll(client, head.data(), head.size())) return;
+
+        // paced in slices of 64 KB, each one when the link would have delivered it
+        const size_t slice = 65536;
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t sent = 0; sent < body.size(); sent += slice) {
+            if (_bytesPerSecond > 0) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(sent * 1000000 / _bytesPerSecond));
+            }
+
+            if (!sendAll(client, body.data() + sent, std::min(slice, body.size() - sent))) return;
+        }
+    }
+
+    // a client that hangs up early must not end the process with SIGPIPE
+    static bool sendAll(int client, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t sent = send(client, data, size, MSG_NOSIGNAL);
+            if (sent <= 0) return false;
+
+            data += sent;
+            size -= sent;
+        }
+
+        return true;
+    }
+};
+
+// connects and sends the request, the response is read from the returned socket
+static int httpGet(int port, const std::string& path) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    assert(fd >= 0);
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    int connected = connect(fd, (sockaddr*)&addr, sizeof(addr));
+
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nAccept: application/json\r\n\r\n";
+    ssize_t sent = send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    assert(connected == 0 && sent == (ssize_t)request.size());
+
+    return fd;
+}
+
+// reads the status line and the headers, the stream is left at the start of the body
+static int readStatus(std::istream& in) {
+    std::string line;
+    int status = 0;
+
+    if (std::getline(in, line) && line.size() > 12) status = std::stoi(line.substr(9, 3));
+
+    while (std::getline(in, line) && line != "\r") {}
+
+    return status;
+}
+
+#endif
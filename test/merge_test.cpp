@@ -0,0 +1,99 @@
+#include <jsonobject.hpp>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static JsonObject parse(const std::string& str) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(str, obj);
+    assert(result.ok());
+    return obj;
+}
+
+// every merge flavour must give the same result
+static void expectMerge(const char* target, const char* patch, const char* expected) {
+    JsonObject result = parse(expected);
+
+    JsonObject copied = parse(target);
+    JsonObject patchObj = parse(patch);
+    copied.merge(patchObj);
+    assert(copied == result);
+    assert(patchObj == parse(patch));
+
+    JsonObject moved = parse(target);
+    moved.merge(parse(patch));
+    assert(moved == result);
+
+    JsonObject streamed = parse(target);
+    JsonResult merged = streamed.mergeFrom(patch);
+    assert(merged.ok() && streamed == result);
+}
+
+int main() {
+    std::cout << "=== Merge test ===" << std::endl;
+
+    // RFC 7386 appendix A
+    expectMerge("{\"a\":\"b\"}", "{\"a\":\"c\"}", "{\"a\":\"c\"}");
+    expectMerge("{\"a\":\"b\"}", "{\"b\":\"c\"}", "{\"a\":\"b\",\"b\":\"c\"}");
+    expectMerge("{\"a\":\"b\"}", "{\"a\":null}", "{}");
+    expectMerge("{\"a\":\"b\",\"b\":\"c\"}", "{\"a\":null}", "{\"b\":\"c\"}");
+    expectMerge("{\"a\":[\"b\"]}", "{\"a\":\"c\"}", "{\"a\":\"c\"}");
+    expectMerge("{\"a\":\"c\"}", "{\"a\":[\"b\"]}", "{\"a\":[\"b\"]}");
+    expectMerge("{\"a\":{\"b\":\"c\"}}", "{\"a\":{\"b\":\"d\",\"c\":null}}", "{\"a\":{\"b\":\"d\"}}");
+    expectMerge("{\"a\":[{\"b\":\"c\"}]}", "{\"a\":[1]}", "{\"a\":[1]}");
+    expectMerge("[\"a\",\"b\"]", "[\"c\",\"d\"]", "[\"c\",\"d\"]");
+    expectMerge("{\"a\":\"b\"}", "[\"c\"]", "[\"c\"]");
+    expectMerge("{\"a\":\"foo\"}", "null", "null");
+    expectMerge("{\"a\":\"foo\"}", "\"bar\"", "\"bar\"");
+    expectMerge("{\"e\":null}", "{\"a\":1}", "{\"e\":null,\"a\":1}");
+    expectMerge("[1,2]", "{\"a\":\"b\",\"c\":null}", "{\"a\":\"b\"}");
+    expectMerge("{}", "{\"a\":{\"bb\":{\"ccc\":null}}}", "{\"a\":{\"bb\":{}}}");
+
+    // layered configuration
+    JsonObject config = parse("{\"server\":{\"port\":80,\"host\":\"localhost\",\"tls\":{\"enabled\":false}},\"log\":\"info\"}");
+    JsonObject env = parse("{\"server\":{\"port\":8080,\"tls\":{\"enabled\":true,\"cert\":\"/etc/cert\"}}}");
+    JsonObject tenant = parse("{\"log\":null,\"limits\":{\"rps\":100}}");
+
+    config.merge(env);
+    config.merge(std::move(tenant));
+
+    assert(config == parse("{\"server\":{\"port\":8080,\"host\":\"localhost\",\"tls\":{\"enabled\":true,\"cert\":\"/etc/cert\"}},\"limits\":{\"rps\":100}}"));
+    assert(env == parse("{\"server\":{\"port\":8080,\"tls\":{\"enabled\":true,\"cert\":\"/etc/cert\"}}}"));
+
+    // merging from a subtree of the target itself
+    JsonObject self = parse("{\"a\":{\"x\":1,\"a\":{\"y\":2}}}");
+    self.merge(*self.get("a"));
+    assert(self == parse("{\"a\":{\"x\":1,\"a\":{\"y\":2},\"y\":2},\"x\":1}"));
+
+    // formatting settings of the target survive a replacing patch
+    JsonObject styled = parse("{\"a\":1}");
+    styled.setMinificationEnabled(false);
+    styled.merge(JsonObject(true));
+
+    std::stringstream out;
+    styled >> out;
+    assert(out.str() == "true");
+
+    // malformed text leaves the target untouched
+    JsonObject target = parse("{\"a\":1,\"b\":2}");
+    JsonResult result = target.mergeFrom("{\"a\":null,\"b\":}");
+    assert(!result);
+    assert(target == parse("{\"a\":1,\"b\":2}"));
+
+    // so does a patch nested deeper than the limits allow
+    JsonLimits limits;
+    limits.maxDepth = 2;
+
+    result = target.mergeFrom("{\"a\":{\"b\":{\"c\":1}}}", limits);
+    assert(result.error == JSON_ERROR_DEPTH_EXCEEDED && result.pos == 10);
+    assert(target == parse("{\"a\":1,\"b\":2}"));
+
+    result = target.mergeFrom("{\"a\":{\"b\":null}}", limits);
+    assert(result.ok() && target == parse("{\"a\":{},\"b\":2}"));
+
+    std::cout << std::endl;
+
+    return 0;
+}
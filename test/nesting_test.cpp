@@ -0,0 +1,106 @@
+#include <jsonobject.hpp>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+// far deeper than the call stack could take with one frame per level
+static const size_t DEPTH = 200000;
+
+int main() {
+    std::cout << "=== Nesting test ===" << std::endl;
+
+    JsonLimits limits;
+    limits.maxDepth = JsonLimits::UNLIMITED;
+
+    std::string arrays = std::string(DEPTH, '[') + "1" + std::string(DEPTH, ']');
+
+    std::string maps;
+    for (size_t i = 0; i < DEPTH; i++) maps += "{\"a\":";
+    maps += "[]";
+    maps += std::string(DEPTH, '}');
+
+    for (const std::string& text : { arrays, maps }) {
+        JsonObject parsed;
+        JsonResult result = JsonObject::parse(text, parsed, limits);
+        assert(result.ok());
+
+        std::stringstream input(text);
+        JsonObject streamed;
+        streamed.readStream(input, limits);
+
+        std::stringstream output;
+        streamed >> output;
+        assert(output.str() == text);
+
+        // a shared copy outlives the tree it was taken from
+        JsonObject copy = parsed;
+        parsed = JsonObject();
+
+        std::stringstream copied;
+        copy >> copied;
+        assert(copied.str() == text);
+    }
+
+    // a malformed tail is still found at the bottom
+    std::stringstream input(std::string(DEPTH, '[') + "1," + std::string(DEPTH, ']'));
+    bool thrown = false;
+
+    try {
+        JsonObject obj;
+        obj.readStream(input, limits);
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    // merge patches as deep, new members with nested nulls included
+    std::string prefix;
+    for (size_t i = 0; i < DEPTH; i++) prefix += "{\"a\":";
+
+    const std::string closing(DEPTH, '}');
+    const std::string merged = prefix + "{\"y\":2,\"z\":{}}" + closing;
+
+    for (bool moved : { false, true }) {
+        JsonObject target, patch;
+        JsonResult result = JsonObject::parse(prefix + "{\"x\":1,\"y\":2}" + closing, target, limits);
+        assert(result.ok());
+        result = JsonObject::parse(prefix + "{\"x\":null,\"z\":{\"n\":null}}" + closing, patch, limits);
+        assert(result.ok());
+
+        if (moved) target.merge(std::move(patch));
+        else target.merge(patch);
+
+        std::stringstream output;
+        target >> output;
+        assert(output.str() == merged);
+    }
+
+    // and straight from text, validated first as deep as the limit allows
+    JsonObject target;
+    JsonResult result = JsonObject::parse(prefix + "{\"x\":1,\"y\":2}" + closing, target, limits);
+    assert(result.ok());
+    result = target.mergeFrom(prefix + "{\"x\":null,\"z\":{\"n\":null}}" + closing, limits);
+    assert(result.ok());
+
+    std::stringstream mergedText;
+    target >> mergedText;
+    assert(mergedText.str() == merged);
+
+    // pretty output indents every level
+    JsonObject nested;
+    nested << "{\"a\":[1,{\"b\":[]},[true,null]],\"c\":{}}";
+    nested.setMinificationEnabled(false);
+
+    std::stringstream pretty;
+    nested >> pretty;
+    assert(pretty.str() == "{\n\t\"a\": [\n\t\t1,\n\t\t{\n\t\t\t\"b\": []\n\t\t},\n\t\t[\n\t\t\ttrue,\n\t\t\tnull\n\t\t]\n\t],\n\t\"c\": {}\n}");
+
+    std::cout << "Documents " << DEPTH << " levels deep parsed, serialized, merged and released" << std::endl << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <jsoncbor.hpp>
+#include <jsonimage.hpp>
+#include <jsonobject.hpp>
+#include <jsonpatch.hpp>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static std::string serialize(JsonObject& obj) {
+    std::stringstream out;
+    obj >> out;
+    return out.str();
+}
+
+// the stream parser keeps one node per item, it is what packed arrays are compared with
+static JsonObject parseNodes(const std::string& text) {
+    JsonObject obj;
+    obj << text.c_str();
+    return obj;
+}
+
+static JsonResult parsePacked(const std::string& text, JsonObject& out) {
+    JsonLimits packing;
+    packing.packNumbers = true;
+    return JsonObject::parse(text, out, packing);
+}
+
+static void setLayout(JsonObject& obj, bool min, const JsonStyle& style) {
+    obj.setMinificationEnabled(min);
+    obj.setStyle(style);
+}
+
+// packing is invisible in everything but the representation
+static void expectSameAsNodes(const std::string& text) {
+    JsonObject packed;
+    JsonResult result = parsePacked(text, packed);
+    assert(result.ok());
+    JsonObject nodes = parseNodes(text);
+
+    assert(packed == nodes && nodes == packed);
+    assert(packed.hash() == nodes.hash());
+    assert(JsonCbor::encode(packed) == JsonCbor::encode(nodes));
+
+    std::string a, b;
+    bool written = JsonImage::write(packed, a) && JsonImage::write(nodes, b);
+    assert(written && a == b);
+
+    JsonStyle lines;
+    JsonStyle compact;
+    compact.indentChar = ' ';
+    compact.indentWidth = 2;
+    compact.compactArrayThreshold = 3;
+
+    // an indentation too wide for the formatting block
+    JsonStyle wide;
+    wide.indentChar = ' ';
+    wide.indentWidth = 1500;
+
+    for (const JsonStyle& style : { lines, compact, wide }) {
+        for (bool min : { true, false }) {
+            setLayout(packed, min, style);
+            setLayout(nodes, min, style);
+            assert(serialize(packed) == serialize(nodes));
+
+            packed.setSerializationCacheEnabled(true);
+            serialize(packed);
+            assert(serialize(packed) == serialize(nodes));
+            packed.setSerializationCacheEnabled(false);
+        }
+    }
+}
+
+int main() {
+    std::cout << "=== Packed test ===" << std::endl;
+
+    // by default the parser keeps one node per item and the const accessors reach them
+    JsonObject plain;
+    JsonResult result = JsonObject::parse("[1,2,3]", plain);
+    assert(result.ok() && !plain.isPacked());
+    const JsonObject& constPlain = plain;
+    assert(constPlain.get(2) && constPlain.get(2)->numberLong() == 3 && !constPlain.get(3));
+    assert(constPlain.asVector() && constPlain.asVector()->size() == 3 && (*constPlain.asVector())[0].numberLong() == 1);
+    assert(!constPlain.asLongs() && constPlain.itemAt(1).numberLong() == 2);
+
+    // arrays of one kind of number are packed by the parser when asked to
+    JsonObject ints;
+    result = parsePacked("[1, -2, 3, 9223372036854775807, -9223372036854775808]", ints);
+    assert(result.ok());
+    assert(ints.isPacked() && ints.size() == 5 && !ints.asDoubles());
+    assert((*ints.asLongs())[3] == LONG_MAX && (*ints.asLongs())[4] == LONG_MIN);
+
+    JsonObject reals;
+    result = parsePacked("[1.5,-0.0,1e300,5e-324,2.0,9223372036854775808]", reals);
+    assert(result.ok());
+    assert(reals.isPacked() && reals.size() == 6 && !reals.asLongs());
+    assert(std::signbit((*reals.asDoubles())[1]) && (*reals.asDoubles())[5] == 9223372036854775808.0);
+
+    // mixed kinds, other values, "-0" and empty arrays stay nodes, with the values the parser always gave
+    const char* generic[] = { "[1,2.5]", "[1.5,2]", "[1,2,\"x\",3]", "[null]", "[[1]]", "[1,-0]", "[]" };
+
+    for (const char* text : generic) {
+        JsonObject obj;
+        result = parsePacked(text, obj);
+        assert(result.ok());
+        assert(!obj.isPacked() && obj == parseNodes(text));
+    }
+
+    JsonObject negativeZero;
+    result = parsePacked("[1,-0]", negativeZero);
+    assert(result.ok());
+    assert(std::signbit(negativeZero[1].number()) && negativeZero[1].numberLong() == 0);
+
+    // nested, long enough to be formatted in several blocks
+    std::string coords = "{\"type\":\"LineString\",\"coordinates\":[";
+
+    for (int i = 0; i < 2000; i++) {
+        if (i > 0) coords += ",";
+        coords += "[" + std::to_string(13.0 + i * 0.001) + "," + std::to_string(52.5 - i * 0.0007) + "]";
+    }
+
+    coords += "],\"ids\":[";
+
+    for (int i = 0; i < 3000; i++) coords += (i > 0 ? "," : "") + std::to_string(i * 7919L - 1000000);
+
+    coords += "],\"empty\":[],\"one\":[2]}";
+
+    expectSameAsNodes(coords);
+    expectSameAsNodes("[1,2,3]");
+    expectSameAsNodes("[0.1,-0.0,1e22,2.5E-3]");
+    expectSameAsNodes("{\"a\":[1,-2],\"b\":{\"c\":[3.5]}}");
+
+    JsonObject geo;
+    result = parsePacked(coords, geo);
+    assert(result.ok());
+
+    // one buffer per array instead of one node per item
+    JsonObject nodes = parseNodes(coords);
+    JsonFootprint packedFootprint = geo.footprint();
+    JsonFootprint nodeFootprint = nodes.footprint();
+
+    std::cout << "footprint: " << packedFootprint.total() << " bytes packed, " << nodeFootprint.total() << " bytes as nodes" << std::endl;
+    assert(packedFootprint.total() * 2 < nodeFootprint.total());
+    assert(nodeFootprint.nodes - packedFootprint.nodes == 2000 * 2 + 3000 + 1);
+
+    // typed access changes the buffer in place
+    JsonObject copy = geo;
+    size_t hash = geo.hash();
+    std::vector<long>* ids = geo["ids"].asLongs();
+    assert(ids && ids->size() == 3000);
+    ids->push_back(42);
+    assert(geo.hash() != hash && geo != copy && copy["ids"].size() == 3000);
+    assert(serialize(geo).find(",42],") != std::string::npos);
+
+    // access to the items as nodes unpacks them, the other copies stay packed
+    JsonObject pair = copy["coordinates"][0];
+    pair[0] = "x";
+    assert(!pair.isPacked() && pair[1].number() == (*copy["coordinates"][0].asDoubles())[1]);
+    assert(copy["coordinates"][0].isPacked());
+
+    // const access only reads, the items stay packed and are copied out of the buffer
+    const JsonObject& constIds = copy["ids"];
+    assert(constIds.itemAt(1).numberLong() == 7919L - 1000000);
+    assert(!constIds.get(1) && !constIds.asVector() && constIds.isPacked());
+
+    // patches read and copy packed items without unpacking the source
+    JsonObject ops;
+    result = JsonObject::parse("[{\"op\":\"test\",\"path\":\"/ids/2\",\"value\":" + std::to_string(2 * 7919L - 1000000) +
+        "},{\"op\":\"copy\",\"from\":\"/ids/1\",\"path\":\"/first\"},{\"op\":\"move\",\"from\":\"/one/0\",\"path\":\"/two\"}]", ops);
+    assert(result.ok());
+    JsonObject patched = copy;
+    result = JsonPatch::apply(patched, ops);
+    assert(result.ok() && patched["first"].numberLong() == 7919L - 1000000 && patched["two"].numberLong() == 2);
+    assert(copy["ids"].isPacked() && copy["one"].size() == 1);
+
+    JsonObject diffed = JsonObject::makeArray(std::vector<long>{ 1, 2 });
+    JsonObject target = JsonObject::makeArray(std::vector<long>{ 1, 3, 4 });
+    result = JsonPatch::apply(diffed, JsonPatch::diff(diffed, target));
+    assert(result.ok() && diffed == target);
+
+    // built arrays
+    JsonObject built = JsonObject::makeArray(std::vector<double>{ 0.5, 1.5 });
+    assert(built.isPacked() && built == parseNodes("[0.5,1.5]"));
+    assert(serialize(built) == "[0.5,1.5]");
+
+    JsonObject empty = JsonObject::makeArray(std::vector<long>());
+    assert(empty.isPacked() && empty.asLongs()->empty() && serialize(empty) == "[]");
+
+    JsonObject hand = JsonObject::makeArray();
+    hand[0] = 1L;
+    hand[1] = 2L;
+    bool packed = hand.pack();
+    assert(packed && hand.isPacked() && (*hand.asLongs())[1] == 2);
+    hand[2] = 2.5;
+    packed = hand.pack();
+    assert(!packed && !hand.isPacked() && hand.size() == 3);
+
+    std::cout << std::endl;
+
+    return 0;
+}
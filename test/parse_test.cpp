@@ -0,0 +1,104 @@
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+// built with -fno-exceptions, only the non-throwing API may fail here
+
+using namespace jsonmini;
+
+static std::string readFile(const char* path) {
+    std::ifstream ifs(path);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+int main() {
+    std::cout << "=== Parse test ===" << std::endl;
+
+    std::string page = readFile(PAGE_JSON_PATH);
+    JsonObject obj;
+
+    JsonResult result = JsonObject::parse(page, obj);
+    assert(result.ok());
+    assert(JsonObject::validate(page).ok());
+
+    assert(obj.get("requestId") && obj.get("requestId")->numberLong() == 5412985);
+    assert(obj.get("missing") == nullptr);
+    assert(obj.get(0) == nullptr);
+    assert(obj.asVector() == nullptr);
+    assert(obj.asMap()->size() == 8);
+
+    const JsonObject* profiles = obj.get("profiles");
+    assert(profiles && profiles->get(1) && profiles->get(2) == nullptr);
+    assert(profiles->get(1)->get("transport")->str() == "Honda Civic");
+
+    // the tree must be the same as the one built by the stream parser
+    JsonObject reference;
+    std::stringstream input(page);
+    reference << input;
+
+    std::stringstream expected, actual;
+    reference >> expected;
+    obj >> actual;
+    assert(expected.str() == actual.str());
+
+    std::string malformed = readFile(MALFORMED_JSON_PATH);
+    size_t begin = 0;
+    int cases = 0;
+
+    while (begin < malformed.size()) {
+        size_t end = malformed.find("\n\n", begin);
+        if (end == std::string::npos) end = malformed.size();
+
+        result = JsonObject::parse(malformed.data() + begin, end - begin, obj);
+
+        if (end > begin) {
+            JsonResult validation = JsonObject::validate(malformed.data() + begin, end - begin);
+
+            assert(!result);
+            assert(obj.isNull());
+            assert(validation.error == result.error && validation.pos == result.pos);
+            std::cout << "Case " << (++cases) << " error: " << result.message() << " at " << result.pos << std::endl;
+        }
+
+        begin = end + 2;
+    }
+
+    assert(cases == 7);
+
+    // surrogate pairs become one 4-byte character, the stream parser decodes the same way
+    const std::string escaped = "[\"\\ud83d\\ude00 \\u00e9\\u20AC\\/\\t\", \"\\uD834\\uDD1E\"]";
+    result = JsonObject::parse(escaped, obj);
+    assert(result.ok());
+    assert(obj.get(0)->str() == "\xf0\x9f\x98\x80 \xc3\xa9\xe2\x82\xac/\t");
+    assert(obj.get(1)->str() == "\xf0\x9d\x84\x9e");
+
+    std::stringstream escapedInput(escaped);
+    reference << escapedInput;
+    assert(reference == obj);
+
+    // a lone or misordered surrogate is not a character
+    const char* lone[] = { "\"\\ud83d\"", "\"\\ude00\\ud83d\"", "\"\\ud83d\\u0041\"", "\"\\ud83dx\"" };
+    const size_t lonePos[] = { 7, 3, 9, 7 };
+
+    for (size_t i = 0; i < 4; i++) {
+        result = JsonObject::parse(lone[i], obj);
+        assert(result.error == JSON_ERROR_INVALID_UNICODE_ESCAPE && result.pos == lonePos[i]);
+        assert(JsonObject::validate(lone[i]).pos == lonePos[i]);
+    }
+
+    std::string nested = std::string(4000, '[') + std::string(4000, ']');
+    assert(JsonObject::validate(nested).ok());
+
+    nested = std::string(5000, '[') + std::string(5000, ']');
+    assert(JsonObject::validate(nested).error == JSON_ERROR_DEPTH_EXCEEDED);
+
+    std::cout << std::endl;
+
+    return 0;
+}
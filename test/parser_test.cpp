@@ -0,0 +1,114 @@
+#include <jsonparser.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+// heap blocks requested by the whole program
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// the recycled tree has to be the one a fresh parse builds
+static void expectSame(JsonParser& parser, JsonDocument& doc, const std::string& text) {
+    JsonObject fresh;
+    JsonResult expected = JsonObject::parse(text, fresh);
+    JsonResult result = parser.parse(text, doc);
+    assert(expected.ok() && result.ok() && doc.root() == fresh);
+
+    std::stringstream a, b;
+    doc.root() >> a;
+    fresh >> b;
+    assert(a.str() == b.str());
+}
+
+int main() {
+    std::cout << "=== Parser test ===" << std::endl;
+
+    JsonParser parser;
+    JsonDocument doc;
+
+    // shapes change between messages: members come and go, arrays grow and shrink, types switch
+    const char* messages[] = {
+        "{\"id\":1,\"name\":\"first message with a long name\",\"tags\":[\"a\",\"b\",\"c\"],\"pos\":{\"x\":1.5,\"y\":-2}}",
+        "{\"id\":2,\"name\":\"second\",\"tags\":[\"d\"],\"pos\":{\"x\":3,\"y\":4,\"z\":5}}",
+        "{\"id\":3,\"tags\":[\"e\",\"f\",\"g\",\"h\"],\"pos\":null,\"extra\":{\"deep\":[[1],[2,3]]}}",
+        "{\"id\":\"four\",\"tags\":{\"k\":true},\"pos\":[1,2],\"name\":\"x\",\"id\":4}",
+        "[1,\"two\",{\"three\":3},[4]]",
+        "[{\"a\":1},{\"b\":2},{\"c\":3}]",
+        "\"scalar\"",
+        "{\"id\":5,\"name\":\"back to a map\",\"tags\":[],\"pos\":{\"x\":0,\"y\":0}}"
+    };
+
+    for (const char* message : messages) {
+        expectSame(parser, doc, message);
+    }
+
+    // messages of one shape reuse everything once the largest strings have been seen
+    const std::string steady = "{\"user\":{\"id\":123456,\"name\":\"someone with a long display name\",\"roles\":[\"admin\",\"editor\"]},"
+        "\"event\":\"update\",\"values\":[1.25,2.5,3.75,5],\"ok\":true,\"note\":null}";
+
+    expectSame(parser, doc, steady);
+    expectSame(parser, doc, steady);
+
+    size_t before = allocations;
+    JsonResult result = parser.parse(steady, doc);
+    assert(result.ok() && allocations == before);
+
+    // a copy taken from the document keeps its values through later parses
+    JsonObject copy = doc.root();
+    expectSame(parser, doc, "{\"user\":{\"id\":7,\"name\":\"other\",\"roles\":[]},\"event\":\"delete\",\"values\":[],\"ok\":false,\"note\":null}");
+    assert((*copy.get("user")->get("name")).str() == "someone with a long display name");
+    assert(copy.get("values")->size() == 4);
+
+    // dropped members and items are kept for the next messages
+    doc.clear();
+    expectSame(parser, doc, "{\"a\":[1,2,3,4,5,6]}");
+    expectSame(parser, doc, "{\"a\":[1]}");
+    assert(doc.spareValues() == 5);
+    expectSame(parser, doc, "{\"b\":[]}");
+    assert(doc.spareMembers() == 1);
+    expectSame(parser, doc, "{\"a\":[1,2,3],\"b\":[4],\"c\":[]}");
+    assert(doc.spareMembers() == 0 && doc.spareValues() == 2);
+
+    // a malformed message leaves a null root, the next one parses as usual
+    JsonObject fresh;
+    JsonResult expected = JsonObject::parse("{\"a\":[1,2,]}", fresh);
+    result = parser.parse("{\"a\":[1,2,]}", doc);
+    assert(result.error == JSON_ERROR_REDUNDANT_COMMA && result.error == expected.error && result.pos == expected.pos);
+    assert(doc.root().isNull());
+    expectSame(parser, doc, steady);
+
+    // limits are enforced the same way
+    JsonLimits limits;
+    limits.maxDepth = 2;
+    JsonParser shallow(limits);
+    result = shallow.parse("[[1]]", doc);
+    assert(result.ok());
+
+    result = shallow.parse("[[[1]]]", doc);
+    assert(result.error == JSON_ERROR_DEPTH_EXCEEDED);
+
+    doc.clear();
+    assert(doc.root().isNull() && doc.spareMembers() == 0 && doc.spareValues() == 0);
+
+    std::cout << "Recycled trees match fresh parses, steady messages parsed without allocating" << std::endl << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <jsonpatch.hpp>
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <unordered_set>
+
+using namespace jsonmini;
+
+static JsonObject parse(const std::string& str) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(str, obj);
+    assert(result.ok());
+    return obj;
+}
+
+static std::string minified(JsonObject obj) {
+    std::stringstream ss;
+    obj.setMinificationEnabled(true);
+    obj >> ss;
+    return ss.str();
+}
+
+static void expectPatch(const char* doc, const char* patch, const char* expected) {
+    JsonObject obj = parse(doc);
+    JsonResult result = JsonPatch::apply(obj, parse(patch));
+    assert(result.ok() && obj == parse(expected));
+}
+
+int main() {
+    std::cout << "=== Patch test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page = parse(ss.str());
+    JsonObject same = parse(ss.str());
+
+    // equality and hashing
+    assert(page == same && page.hash() == same.hash());
+    assert(parse("[1, 2.0, {\"a\": null}]") == parse("[1.0, 2, {\"a\": null}]"));
+    assert(parse("[1, 2.0]").hash() == parse("[1.0, 2]").hash());
+    assert(parse("1.5") != parse("1") && parse("\"1\"") != parse("1"));
+    assert(parse("{\"a\": 1}") != parse("{\"b\": 1}") && parse("[1]") != parse("[1, 1]"));
+    assert(parse("9007199254740993") != parse("9007199254740992.0"));
+
+    std::unordered_set<JsonObject> set = { page, same, parse("[]") };
+    assert(set.size() == 2);
+
+    // the cached hash follows modifications
+    size_t before = same.hash();
+    same["profiles"][1]["transport"] = JsonObject("Bicycle");
+    assert(same.hash() != before && page != same);
+
+    same["profiles"][1]["transport"] = *page.get("profiles")->get(1)->get("transport");
+    assert(same.hash() == before && page == same);
+
+    // diff and apply round trip, only the changed fields are shipped
+    JsonObject changed = page;
+    changed["requestId"] = JsonObject(42L);
+    changed["profiles"][1].remove("transport");
+    changed["profiles"].vector()->push_back(JsonObject("extra"));
+    changed["a/b~c"] = JsonObject(true);
+
+    JsonObject patch = JsonPatch::diff(page, changed);
+    std::cout << "diff: " << minified(patch) << std::endl;
+
+    assert(patch.size() == 4);
+    assert(JsonPatch::diff(page, page).size() == 0);
+
+    JsonObject target = page;
+    JsonResult applied = JsonPatch::apply(target, patch);
+    assert(applied.ok() && target == changed && target.hash() == changed.hash());
+    assert(target["a/b~c"].boolean());
+
+    JsonObject shrunk = parse("[1, 2, 3, 4]");
+    target = parse("[1, 5]");
+    applied = JsonPatch::apply(shrunk, JsonPatch::diff(shrunk, target));
+    assert(applied.ok() && shrunk == target);
+
+    target = parse("\"scalar\"");
+    JsonObject root = page;
+    applied = JsonPatch::apply(root, JsonPatch::diff(root, target));
+    assert(applied.ok() && root == target);
+
+    // RFC 6902 appendix A
+    expectPatch("{\"foo\": \"bar\"}", "[{\"op\": \"add\", \"path\": \"/baz\", \"value\": \"qux\"}]", "{\"baz\": \"qux\", \"foo\": \"bar\"}");
+    expectPatch("{\"foo\": [\"bar\", \"baz\"]}", "[{\"op\": \"add\", \"path\": \"/foo/1\", \"value\": \"qux\"}]", "{\"foo\": [\"bar\", \"qux\", \"baz\"]}");
+    expectPatch("{\"baz\": \"qux\", \"foo\": \"bar\"}", "[{\"op\": \"remove\", \"path\": \"/baz\"}]", "{\"foo\": \"bar\"}");
+    expectPatch("{\"foo\": [\"bar\", \"qux\", \"baz\"]}", "[{\"op\": \"remove\", \"path\": \"/foo/1\"}]", "{\"foo\": [\"bar\", \"baz\"]}");
+    expectPatch("{\"baz\": \"qux\", \"foo\": \"bar\"}", "[{\"op\": \"replace\", \"path\": \"/baz\", \"value\": \"boo\"}]", "{\"baz\": \"boo\", \"foo\": \"bar\"}");
+    expectPatch("{\"foo\": {\"bar\": \"baz\", \"waldo\": \"fred\"}, \"qux\": {\"corge\": \"grault\"}}",
+        "[{\"op\": \"move\", \"from\": \"/foo/waldo\", \"path\": \"/qux/thud\"}]",
+        "{\"foo\": {\"bar\": \"baz\"}, \"qux\": {\"corge\": \"grault\", \"thud\": \"fred\"}}");
+    expectPatch("{\"foo\": [\"all\", \"grass\", \"cows\", \"eat\"]}", "[{\"op\": \"move\", \"from\": \"/foo/1\", \"path\": \"/foo/3\"}]",
+        "{\"foo\": [\"all\", \"cows\", \"eat\", \"grass\"]}");
+    expectPatch("{\"baz\": \"qux\", \"foo\": [\"a\", 2, \"c\"]}",
+        "[{\"op\": \"test\", \"path\": \"/baz\", \"value\": \"qux\"}, {\"op\": \"test\", \"path\": \"/foo/1\", \"value\": 2}]",
+        "{\"baz\": \"qux\", \"foo\": [\"a\", 2, \"c\"]}");
+    expectPatch("{\"foo\": [\"bar\"]}", "[{\"op\": \"add\", \"path\": \"/foo/-\", \"value\": [\"abc\", \"def\"]}]", "{\"foo\": [\"bar\", [\"abc\", \"def\"]]}");
+    expectPatch("{\"foo\": 1}", "[{\"op\": \"copy\", \"from\": \"/foo\", \"path\": \"/bar\"}]", "{\"foo\": 1, \"bar\": 1}");
+    expectPatch("{\"/\": 9, \"~1\": 10}", "[{\"op\": \"test\", \"path\": \"/~01\", \"value\": 10}, {\"op\": \"remove\", \"path\": \"/~1\"}]", "{\"~1\": 10}");
+
+    // failures leave the document untouched and report the failing operation
+    JsonObject doc = parse("{\"baz\": \"qux\", \"list\": [1]}");
+    JsonObject original = doc;
+
+    JsonResult result = JsonPatch::apply(doc, parse("[{\"op\": \"add\", \"path\": \"/x\", \"value\": 1}, {\"op\": \"test\", \"path\": \"/baz\", \"value\": \"bar\"}]"));
+    assert(result.error == JSON_ERROR_TEST_FAILED && result.pos == 1 && doc == original);
+
+    result = JsonPatch::apply(doc, parse("[{\"op\": \"add\", \"path\": \"/baz/bat\", \"value\": \"qux\"}]"));
+    assert(result.error == JSON_ERROR_PATH_NOT_FOUND && doc == original);
+
+    result = JsonPatch::apply(doc, parse("[{\"op\": \"remove\", \"path\": \"/list/1\"}]"));
+    assert(result.error == JSON_ERROR_PATH_NOT_FOUND);
+
+    result = JsonPatch::apply(doc, parse("[{\"op\": \"add\", \"path\": \"/list/01\", \"value\": 0}]"));
+    assert(result.error == JSON_ERROR_PATH_NOT_FOUND);
+
+    result = JsonPatch::apply(doc, parse("[{\"op\": \"move\", \"from\": \"/list\", \"path\": \"/list/0\"}]"));
+    assert(result.error == JSON_ERROR_INVALID_PATCH);
+
+    result = JsonPatch::apply(doc, parse("[{\"op\": \"frobnicate\", \"path\": \"/baz\"}]"));
+    assert(result.error == JSON_ERROR_INVALID_PATCH);
+
+    result = JsonPatch::apply(doc, parse("[{\"op\": \"add\", \"path\": \"baz\", \"value\": 1}]"));
+    assert(result.error == JSON_ERROR_INVALID_PATCH);
+
+    assert(doc == original);
+    std::cout << std::endl;
+
+    return 0;
+}
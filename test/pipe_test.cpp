@@ -0,0 +1,198 @@
+#include <jsonobject.hpp>
+#include <jsonobjectexception.hpp>
+#include <jsonpipe.hpp>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+#include "loopbackserver.hpp"
+
+using namespace jsonmini;
+
+// records with strings, numbers and nesting, large enough to take many blocks
+static std::string generate(size_t records) {
+    std::string text = "{\"total\":" + std::to_string(records) + ",\"records\":[";
+
+    for (size_t i = 0; i < records; i++) {
+        if (i > 0) text += ",";
+        text += "{\"id\":" + std::to_string(i) + ",\"name\":\"r\\u00e9cord " + std::to_string(i) + "\",\"score\":" +
+            std::to_string(i * 0.25) + ",\"tags\":[\"a\",null,true],\"pos\":{\"x\":" + std::to_string(i % 17) + ",\"y\":-1}}";
+    }
+
+    return text + "]}";
+}
+
+static JsonObject parse(const std::string& text) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(text, obj);
+    assert(result.ok());
+    return obj;
+}
+
+// a GET through the pipe parses to the tree the whole body parses to
+static void expectFetched(int port, const std::string& path, const std::string& body, size_t blockSize = JsonPipe::BLOCK_SIZE) {
+    int fd = httpGet(port, path);
+    {
+        JsonPipe pipe(fd, blockSize);
+        std::istream in(&pipe);
+        int status = readStatus(in);
+        assert(status == 200);
+
+        JsonObject obj;
+        obj.readStream(in, JsonLimits());
+        assert(obj == parse(body));
+        assert(pipe.error() == 0 && pipe.bytesRead() > body.size());
+    }
+    close(fd);
+}
+
+int main() {
+    std::cout << "=== Pipe test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    std::string page = ss.str();
+    std::string large = generate(20000);
+    std::string paced = generate(2000);
+
+    std::map<std::string, std::string> routes = {
+        { "/page", page },
+        { "/large", large },
+        { "/malformed", "{\"records\":[{\"id\":1},{\"id\":2,}]}" }
+    };
+
+    {
+        LoopbackServer server(routes);
+        std::cout << "serving " << large.size() << " bytes on 127.0.0.1:" << server.port() << std::endl;
+
+        expectFetched(server.port(), "/page", page);
+        expectFetched(server.port(), "/large", large);
+        // values, escapes and the end of the headers cut at every block boundary
+        expectFetched(server.port(), "/page", page, 1);
+        expectFetched(server.port(), "/large", large, 4093);
+
+        // unknown paths get an error document; a pipe is destroyed before its descriptor is closed,
+        // its thread would read from the next socket given the same number otherwise
+        int fd = httpGet(server.port(), "/missing");
+        {
+            JsonPipe missing(fd);
+            std::istream in(&missing);
+            int status = readStatus(in);
+            assert(status == 404);
+
+            JsonObject error;
+            error << in;
+            assert(error["error"].str() == "not found");
+        }
+        close(fd);
+
+        // errors are reported at the same offset of the body as for the whole text
+        JsonObject expected;
+        JsonResult result = JsonObject::parse(routes["/malformed"], expected);
+
+        fd = httpGet(server.port(), "/malformed");
+        {
+            JsonPipe malformed(fd, 5);
+            std::istream bad(&malformed);
+            int status = readStatus(bad);
+            assert(status == 200);
+
+            bool thrown = false;
+
+            try {
+                JsonObject obj;
+                obj.readStream(bad, JsonLimits());
+            }
+            catch (const JsonObjectException& e) {
+                std::cout << e.what() << std::endl;
+                assert(e.pos() == result.pos);
+                thrown = true;
+            }
+
+            assert(thrown);
+        }
+        close(fd);
+
+        // stops early, the server sees the connection closed
+        fd = httpGet(server.port(), "/large");
+        {
+            JsonPipe abandoned(fd);
+            std::istream partial(&abandoned);
+            int status = readStatus(partial);
+            int first = partial.get();
+            assert(status == 200 && first == '{');
+        }
+        close(fd);
+    }
+
+    // a slow link: the parser waits for blocks instead of for the whole body, how often depends on timing
+    {
+        LoopbackServer slow({ { "/paced", paced } }, 2 * 1024 * 1024);
+        int fd = httpGet(slow.port(), "/paced");
+        {
+            JsonPipe pipe(fd);
+            std::istream in(&pipe);
+            int status = readStatus(in);
+            assert(status == 200);
+
+            JsonObject obj;
+            obj.readStream(in, JsonLimits());
+            assert(obj == parse(paced));
+        }
+        close(fd);
+    }
+
+    // files and pipes are read the same way
+    int file = open(PAGE_JSON_PATH, O_RDONLY);
+    assert(file >= 0);
+    {
+        JsonPipe pipe(file, 1000);
+        std::istream in(&pipe);
+        JsonObject obj;
+        obj << in;
+        assert(obj == parse(page) && pipe.bytesRead() == page.size());
+    }
+    close(file);
+
+    int ends[2];
+    int opened = ::pipe(ends);
+    assert(opened == 0);
+
+    std::thread writer([&]() {
+        // odd sizes, so writes and reads do not line up
+        for (size_t i = 0; i < large.size(); i += 3001) {
+            size_t size = std::min<size_t>(3001, large.size() - i);
+            ssize_t written = write(ends[1], large.data() + i, size);
+            assert(written == (ssize_t)size);
+        }
+
+        close(ends[1]);
+    });
+
+    {
+        JsonPipe pipe(ends[0]);
+        std::istream in(&pipe);
+        JsonObject obj;
+        obj.readStream(in, JsonLimits());
+        assert(obj == parse(large));
+    }
+
+    writer.join();
+    close(ends[0]);
+
+    // a descriptor that never delivers does not keep the pipe from being destroyed
+    opened = ::pipe(ends);
+    assert(opened == 0);
+    {
+        JsonPipe idle(ends[0]);
+    }
+    close(ends[0]);
+    close(ends[1]);
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <jsonquery.hpp>
+#include <iostream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static const char* STORE = R"({
+    "name": "store",
+    "books": [
+        { "title": "a", "price": 8.5, "tags": ["new"], "stock": 3, "author": { "name": "x" } },
+        { "title": "b", "price": 12, "tags": [], "stock": 0, "author": { "name": "y" } },
+        { "title": "c", "price": 30, "stock": 7, "used": true, "author": { "name": "x" } },
+        { "title": "d", "price": null, "stock": -1, "used": false }
+    ],
+    "totals": { "a": 1, "b": 2.5, "c": "n/a" },
+    "readings": [3, 1, 4, 1, 5, 9, 2, 6],
+    "ratios": [0.5, 0.25, 2.0],
+    "weird key": { "x y": 1 }
+})";
+
+static JsonObject parse(const std::string& text, const JsonLimits& limits = JsonLimits()) {
+    JsonObject obj;
+    JsonResult result = JsonObject::parse(text, obj, limits);
+    assert(result.ok());
+    return obj;
+}
+
+// the tree, the same tree on several threads and the text give the same result
+static void expect(const std::string& expression, const std::string& expected, const std::string& text = STORE) {
+    JsonQuery query;
+    JsonResult compiled = JsonQuery::compile(expression, query);
+
+    if (!compiled) std::cout << expression << ": " << compiled.message() << " at " << compiled.pos << std::endl;
+    assert(compiled);
+
+    JsonObject root = parse(text);
+    JsonObject result = query.evaluate(root);
+
+    assert(result == parse(expected));
+    assert(query.evaluate(root, 4) == result);
+
+    JsonObject streamed;
+    JsonResult evaluated = query.evaluate(text, streamed);
+    assert(evaluated.ok() && streamed == result);
+}
+
+static void expectInvalid(const std::string& expression, size_t pos) {
+    JsonQuery query;
+    JsonResult result = JsonQuery::compile(expression, query);
+
+    std::cout << expression << ": " << result.message() << " at " << result.pos << std::endl;
+    assert(result.error == JSON_ERROR_INVALID_QUERY && result.pos == pos);
+}
+
+int main() {
+    std::cout << "=== Query test ===" << std::endl;
+
+    // paths
+    expect("name", R"(["store"])");
+    expect("@", std::string("[") + STORE + "]");
+    expect("books[0].title", R"(["a"])");
+    expect("books[-1].title", R"(["d"])");
+    expect("books[4].title", "[]");
+    expect("books[*].title", R"(["a","b","c","d"])");
+    expect("books[*].author.name", R"(["x","y","x"])");
+    expect("totals.*", R"([1,2.5,"n/a"])");
+    expect(R"(["weird key"]["x y"])", "[1]");
+    expect("name.first", "[]");
+    expect("readings[2]", "[4]");
+    expect("readings[-2]", "[2]");
+    expect("missing[*]", "[]");
+
+    // filters
+    expect("books[?price > 10].title", R"(["b","c"])");
+    expect("books[?price <= 8.5].title", R"(["a"])");
+    expect(R"(books[?author.name == "x"].title)", R"(["a","c"])");
+    expect(R"(books[?author.name != "x"].title)", R"(["b","d"])");
+    expect("books[?price == null].title", R"(["d"])");
+    expect("books[?used].title", R"(["c"])");
+    expect("books[?!used].title", R"(["a","b","d"])");
+    expect("books[?stock > 0 && price < 20].title", R"(["a"])");
+    expect("books[?stock < 1 || used].title", R"(["b","c","d"])");
+    expect("books[?!(stock > 0 || used == false)].title", R"(["b"])");
+    expect("books[?tags == `[]`].title", R"(["b"])");
+    expect("books[?tags[0] == `\"new\"`].title", R"(["a"])");
+    expect("books[?title >= \"c\"].title", R"(["c","d"])");
+    // values of different types are not ordered
+    expect("books[?title > 1].title", "[]");
+    expect("readings[?@ > 4]", "[5,9,6]");
+    expect("ratios[?@ == 2]", "[2.0]");
+
+    // projections
+    expect("books[?stock > 0].{t: title, who: author.name}", R"([{"t":"a","who":"x"},{"t":"c","who":"x"}])");
+    expect(R"(books[-1].{"the title": title, author: author.name})", R"([{"the title":"d","author":null}])");
+
+    // aggregates
+    expect("count(books[*])", "4");
+    expect("count(books[?used])", "1");
+    expect("sum(books[*].price)", "50.5");
+    expect("sum(readings[*])", "31");
+    expect("sum(totals.*)", "3.5");
+    expect("sum(missing[*])", "0");
+    expect("min(readings[*])", "1");
+    expect("max(books[*].price)", "30");
+    expect("min(ratios[*])", "0.25");
+    expect("max(books[*].title)", "null");
+    expect("sum(@)", "0", "[1]");
+    expect("sum(@[*])", "-9223372036854775808", "[-9223372036854775807,-1]");
+
+    // sums past the range of integers are reals
+    JsonQuery sum;
+    JsonResult compiled = JsonQuery::compile("sum([*])", sum);
+    assert(compiled.ok());
+    JsonObject big = sum.evaluate(parse("[9223372036854775807,1]"));
+    assert(big.isNumber() && big.number() == 9223372036854775808.0);
+
+    // large arrays are split between threads, results keep the order of the items
+    std::string text = "{\"items\":[";
+    long expectedSum = 0;
+
+    for (long i = 0; i < 50000; i++) {
+        if (i > 0) text += ",";
+        text += "{\"id\":" + std::to_string(i) + ",\"v\":" + std::to_string(i % 97) + "}";
+        if (i % 97 > 90) expectedSum += i;
+    }
+
+    text += "],\"packed\":[";
+    for (long i = 0; i < 50000; i++) text += (i > 0 ? "," : "") + std::to_string(i % 1000);
+    text += "]}";
+
+    JsonLimits packing;
+    packing.packNumbers = true;
+    JsonObject root = parse(text, packing);
+
+    JsonQuery ids;
+    compiled = JsonQuery::compile("items[?v > 90].id", ids);
+    assert(compiled.ok());
+    JsonObject serial = ids.evaluate(root);
+    JsonObject parallel = ids.evaluate(root, 4);
+    assert(serial == parallel && serial.size() == 50000 / 97 * 6);
+
+    for (size_t i = 1; i < parallel.size(); i++) assert(parallel[i - 1].numberLong() < parallel[i].numberLong());
+
+    JsonQuery sumIds;
+    compiled = JsonQuery::compile("sum(items[?v > 90].id)", sumIds);
+    assert(compiled.ok());
+    assert(sumIds.evaluate(root, 4).numberLong() == expectedSum);
+
+    JsonQuery maxPacked;
+    compiled = JsonQuery::compile("max(packed[?@ < 500])", maxPacked);
+    assert(compiled.ok());
+    assert(root["packed"].isPacked());
+    assert(maxPacked.evaluate(root, 3).numberLong() == 499);
+
+    // the tree is not touched
+    assert(root["packed"].isPacked());
+
+    // compile errors point at where the expression stops making sense
+    expectInvalid("", 0);
+    expectInvalid("books[", 6);
+    expectInvalid("books[*", 7);
+    expectInvalid("books..title", 6);
+    expectInvalid("books[?]", 7);
+    expectInvalid("books[?price >]", 14);
+    expectInvalid("books[?1]", 8);
+    expectInvalid("books[?a[*]]", 9);
+    expectInvalid("books[1.5]", 6);
+    expectInvalid("books.{t: title}.x", 16);
+    expectInvalid("books.{t: 1}", 10);
+    expectInvalid("avg(books[*])", 0);
+    expectInvalid("count(books", 11);
+    expectInvalid("books[?price == \"x]", 16);
+    expectInvalid("books[?price == `[1,]`]", 20);
+    expectInvalid("a b", 2);
+
+    std::string deep = "a[?";
+    for (int i = 0; i < 100; i++) deep += "(";
+    expectInvalid(deep + "b" + std::string(100, ')') + "]", 67);
+
+    // a failed compile leaves a query that gives the root
+    JsonQuery failed;
+    compiled = JsonQuery::compile("books[", failed);
+    assert(!compiled.ok());
+    assert(failed.evaluate(parse("[1]")) == parse("[[1]]"));
+
+    // on text, errors are those of JsonObject::parse, members the query skips are checked too
+    JsonQuery titles;
+    compiled = JsonQuery::compile("books[*].title", titles);
+    assert(compiled.ok());
+
+    const char* malformed[] = {
+        R"({"books":[{"title":"a"},]})",
+        R"({"books":[{"title":"a"}]} [])",
+        R"({"other":[1,2,}], "books":[]})",
+        R"({"books":[{"title":"a","x":01}]})",
+        R"({"books":[{"title":"a")"
+    };
+
+    for (const char* bad : malformed) {
+        JsonObject obj;
+        JsonResult expected = JsonObject::parse(bad, obj);
+
+        JsonObject out = JsonObject::makeMap();
+        JsonResult result = titles.evaluate(bad, out);
+
+        assert(!expected.ok() && result.error == expected.error && result.pos == expected.pos);
+        assert(out.isNull());
+    }
+
+    JsonLimits limits;
+    limits.maxDepth = 2;
+    JsonObject limited;
+    JsonResult evaluated = titles.evaluate(R"({"books":[{"title":"a"}]})", limited, limits);
+    assert(evaluated.error == JSON_ERROR_DEPTH_EXCEEDED);
+
+    std::cout << std::endl;
+
+    return 0;
+}
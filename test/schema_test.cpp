@@ -0,0 +1,172 @@
+#include <jsonschema.hpp>
+#include <iostream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static const char* ORDER_SCHEMA = R"({
+    "$schema": "https://json-schema.org/draft/2020-12/schema",
+    "title": "order",
+    "type": "object",
+    "required": ["id", "name", "items"],
+    "additionalProperties": false,
+    "properties": {
+        "id": { "type": "integer", "minimum": 1 },
+        "name": { "type": "string", "minLength": 1, "maxLength": 8 },
+        "status": { "enum": ["new", "open", "closed"] },
+        "price": { "type": "number", "exclusiveMinimum": 0, "maximum": 1000 },
+        "tags": { "type": "array", "items": { "type": "string" }, "maxItems": 3 },
+        "items": {
+            "type": "array",
+            "minItems": 1,
+            "items": {
+                "type": "object",
+                "required": ["sku"],
+                "properties": { "sku": { "type": "string" }, "qty": { "type": "integer", "minimum": 1 } }
+            }
+        },
+        "a/b": { "const": true },
+        "meta": {},
+        "note": { "type": ["string", "null"] }
+    }
+})";
+
+static JsonSchema compileSchema(const char* text) {
+    JsonObject doc;
+    JsonResult parsed = JsonObject::parse(text, doc);
+    assert(parsed.ok());
+
+    JsonSchema schema;
+    JsonSchemaResult result = JsonSchema::compile(doc, schema);
+    assert(result.ok());
+    return schema;
+}
+
+// a valid document builds the tree JsonObject::parse builds
+static void expectValid(const JsonSchema& schema, const std::string& text) {
+    JsonObject expected;
+    JsonResult parsed = JsonObject::parse(text, expected);
+    assert(parsed.ok());
+
+    JsonObject obj;
+    JsonSchemaResult result = schema.parse(text, obj);
+    assert(result.ok() && obj == expected);
+
+    result = schema.validate(text);
+    assert(result.ok());
+}
+
+// parse and validate stop at the same place
+static void expectViolation(const JsonSchema& schema, const std::string& text, JsonError error, size_t pos, const std::string& path) {
+    JsonObject obj = JsonObject::makeMap();
+    JsonSchemaResult result = schema.parse(text, obj);
+
+    std::cout << result.message() << " at " << result.pos << " (" << result.path << ")" << std::endl;
+
+    assert(result.error == error && result.pos == pos && result.path == path);
+    assert(obj.isNull());
+
+    JsonSchemaResult validated = schema.validate(text);
+    assert(validated.error == error && validated.pos == pos && validated.path == path);
+}
+
+static void expectInvalidSchema(const char* text, const std::string& path) {
+    JsonObject doc;
+    JsonResult parsed = JsonObject::parse(text, doc);
+    assert(parsed.ok());
+
+    JsonSchema schema;
+    JsonSchemaResult result = JsonSchema::compile(doc, schema);
+    assert(result.error == JSON_ERROR_INVALID_SCHEMA && result.path == path);
+}
+
+int main() {
+    std::cout << "=== Schema test ===" << std::endl;
+
+    JsonSchema schema = compileSchema(ORDER_SCHEMA);
+
+    expectValid(schema, R"({"id":7,"name":"börk","status":"open","price":9.5,"tags":["a","b"],
+        "items":[{"sku":"x","qty":2},{"sku":"y","extra":[1,{"z":null}]}],"meta":{"any":[1,2,{"deep":true}]},"note":null})");
+    expectValid(schema, R"({"id":2.0,"name":"éééééééé","price":1000,"items":[{"sku":"x"}],"note":"n","a/b":true})");
+    // duplicates keep the last value
+    expectValid(schema, R"({"id":1,"name":"a","items":[{"sku":"x"}],"id":3})");
+
+    // the first violation stops the parse, with its offset and a JSON Pointer to the value
+    expectViolation(schema, R"({"id":"7","name":"a","items":[{"sku":"x"}]})", JSON_ERROR_TYPE_MISMATCH, 6, "/id");
+    expectViolation(schema, R"({"id":1.5,"name":"a","items":[{"sku":"x"}]})", JSON_ERROR_TYPE_MISMATCH, 6, "/id");
+    expectViolation(schema, R"({"id":0,"name":"a","items":[{"sku":"x"}]})", JSON_ERROR_OUT_OF_BOUNDS, 6, "/id");
+    expectViolation(schema, R"({"id":1,"name":"","items":[{"sku":"x"}]})", JSON_ERROR_OUT_OF_BOUNDS, 15, "/name");
+    expectViolation(schema, R"({"id":1,"name":"ééééééééé","items":[]})", JSON_ERROR_OUT_OF_BOUNDS, 15, "/name");
+    expectViolation(schema, R"({"id":1,"status":"done"})", JSON_ERROR_VALUE_NOT_ALLOWED, 17, "/status");
+    expectViolation(schema, R"({"id":1,"price":0})", JSON_ERROR_OUT_OF_BOUNDS, 16, "/price");
+    expectViolation(schema, R"({"id":1,"price":1000.5})", JSON_ERROR_OUT_OF_BOUNDS, 16, "/price");
+    expectViolation(schema, R"({"id":1,"tags":["a","b","c","d"]})", JSON_ERROR_OUT_OF_BOUNDS, 28, "/tags/3");
+    expectViolation(schema, R"({"id":1,"tags":["a",2]})", JSON_ERROR_TYPE_MISMATCH, 20, "/tags/1");
+    expectViolation(schema, R"({"id":1,"name":"a","items":[ ]})", JSON_ERROR_OUT_OF_BOUNDS, 29, "/items");
+    expectViolation(schema, R"({"id":1,"name":"a","items":[{"qty":1}]})", JSON_ERROR_REQUIRED_KEY_MISSING, 36, "/items/0/sku");
+    expectViolation(schema, R"({"id":1,"name":"a","items":[{"sku":"x","qty":0}]})", JSON_ERROR_OUT_OF_BOUNDS, 45, "/items/0/qty");
+    expectViolation(schema, R"({"id":1,"items":[{"sku":"x"}]})", JSON_ERROR_REQUIRED_KEY_MISSING, 29, "/name");
+    expectViolation(schema, R"({"id":1, "x":{"big":[1,2,3]}})", JSON_ERROR_KEY_NOT_ALLOWED, 9, "/x");
+    expectViolation(schema, R"({"id":1,"a/b":false})", JSON_ERROR_VALUE_NOT_ALLOWED, 14, "/a~1b");
+    expectViolation(schema, R"({"id":1,"id":"x"})", JSON_ERROR_TYPE_MISMATCH, 13, "/id");
+    expectViolation(schema, R"([{"id":1}])", JSON_ERROR_TYPE_MISMATCH, 0, "");
+
+    // a violation is reported before a later syntax error, syntax errors are those of JsonObject::parse
+    expectViolation(schema, R"({"id":"x",,,)", JSON_ERROR_TYPE_MISMATCH, 6, "/id");
+
+    const char* malformed[] = {
+        R"({"id":1,"name":"a","items":[{"sku":"x",}]})",
+        R"({"id":1,"name":"a","items":[{"sku":"x"}]} [])",
+        R"({"id":1,"name":"a","items":[{"sku":"x"}])",
+        R"({"id":01})"
+    };
+
+    for (const char* text : malformed) {
+        JsonObject obj;
+        JsonResult expected = JsonObject::parse(text, obj);
+        JsonSchemaResult result = schema.parse(text, obj);
+
+        assert(!expected.ok() && result.error == expected.error && result.pos == expected.pos);
+        assert(obj.isNull());
+        assert(schema.validate(text).error == expected.error);
+    }
+
+    // limits still apply
+    JsonLimits limits;
+    limits.maxDepth = 2;
+    assert(schema.validate(R"({"id":1,"name":"a","items":[{"sku":"x"}]})", limits).error == JSON_ERROR_DEPTH_EXCEEDED);
+
+    // boolean schemas and schemas without constraints
+    JsonSchema anything = compileSchema("{}");
+    expectValid(anything, R"([1,{"a":"b"},null])");
+
+    JsonSchema nothing = compileSchema("false");
+    expectViolation(nothing, "1", JSON_ERROR_TYPE_MISMATCH, 0, "");
+
+    // enum and const hold scalars only, containers never match them
+    JsonSchema choice = compileSchema(R"({"enum":[1,2]})");
+    expectValid(choice, "2");
+    expectViolation(choice, "[]", JSON_ERROR_VALUE_NOT_ALLOWED, 0, "");
+    expectViolation(choice, "{}", JSON_ERROR_VALUE_NOT_ALLOWED, 0, "");
+    expectViolation(choice, "[1]", JSON_ERROR_VALUE_NOT_ALLOWED, 0, "");
+
+    JsonSchema constant = compileSchema(R"({"const":"a"})");
+    expectValid(constant, "\"a\"");
+    expectViolation(constant, "[\"a\"]", JSON_ERROR_VALUE_NOT_ALLOWED, 0, "");
+    expectViolation(constant, "{\"a\":1}", JSON_ERROR_VALUE_NOT_ALLOWED, 0, "");
+    expectViolation(schema, R"({"id":1,"status":["new"]})", JSON_ERROR_VALUE_NOT_ALLOWED, 17, "/status");
+
+    JsonSchema uncompiled;
+    expectValid(uncompiled, R"({"a":[1,2]})");
+
+    // keywords outside the supported subset are refused instead of being ignored
+    expectInvalidSchema(R"({"type":"objekt"})", "/type");
+    expectInvalidSchema(R"({"properties":{"a":{"pattern":"^x"}}})", "/properties/a/pattern");
+    expectInvalidSchema(R"({"items":{"enum":[[1]]}})", "/items/enum");
+    expectInvalidSchema(R"({"minLength":-1})", "/minLength");
+    expectInvalidSchema("[]", "");
+
+    std::cout << std::endl;
+
+    return 0;
+}
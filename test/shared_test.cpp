@@ -0,0 +1,78 @@
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static std::string minified(JsonObject& obj) {
+    std::stringstream ss;
+    obj.setMinificationEnabled(true);
+    obj >> ss;
+    return ss.str();
+}
+
+int main() {
+    std::cout << "=== Shared subtree test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+
+    JsonObject page;
+    JsonResult result = JsonObject::parse(ss.str(), page);
+    assert(result.ok());
+
+    const std::string original = minified(page);
+
+    // a copy shares every container with the original
+    JsonObject copy = page;
+    const JsonObject& constPage = page;
+    const JsonObject& constCopy = copy;
+
+    assert(constCopy.asMap() == constPage.asMap());
+    assert(minified(copy) == original);
+
+    // writing through operator[] clones only the path to the modified value
+    copy["profiles"][0]["name"] = JsonObject("changed");
+    copy["requestId"] = JsonObject(1L);
+
+    assert(minified(page) == original);
+    assert(minified(copy) != original);
+    assert(copy["profiles"][0]["name"].str() == "changed");
+    assert(copy["requestId"].numberLong() == 1);
+    assert(constPage.get("requestId")->numberLong() == 5412985);
+
+    assert(constCopy.asMap() != constPage.asMap());
+    assert(constCopy.get("profiles")->asVector() != constPage.get("profiles")->asVector());
+    assert(constCopy.get("profiles")->get(1)->asMap() == constPage.get("profiles")->get(1)->asMap());
+
+    // the other non-const accessors detach as well
+    JsonObject second = page;
+    second.get("profiles")->vector()->pop_back();
+    assert(constPage.get("profiles")->size() == 2);
+    assert(second.get("profiles")->size() == 1);
+
+    JsonObject third = page;
+    bool removed = third.remove("requestId");
+    assert(removed && !third.hasKey("requestId") && page.hasKey("requestId"));
+
+    JsonObject arr = JsonObject::makeArray();
+    arr[2] = JsonObject(true);
+
+    JsonObject arrCopy = arr;
+    arrCopy.remove(0);
+    assert(arr.size() == 3 && arrCopy.size() == 2);
+
+    // a modified original leaves its copies alone too
+    JsonObject snapshot = page;
+    page["requestId"] = JsonObject(2L);
+    assert(minified(snapshot) == original);
+
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <jsonbind.hpp>
+#include <jsonobject.hpp>
+#include <jsonobjectexception.hpp>
+#include <jsonstats.hpp>
+#include <iostream>
+#include <sstream>
+#include <cassert>
+
+// linked against jsonmini_stats, the library built with JSONMINI_STATS
+
+using namespace jsonmini;
+
+struct Point {
+    long x = 0;
+    long y = 0;
+};
+
+JSONMINI_FIELDS(Point, x, y)
+
+static int callbacks = 0;
+static JsonPhase lastPhase = JSON_PHASE_COUNT;
+static JsonStats lastStats;
+
+static void onStats(JsonPhase phase, const JsonStats& stats, void* user) {
+    callbacks++;
+    lastPhase = phase;
+    lastStats = stats;
+    (*(int*)user)++;
+}
+
+int main() {
+    std::cout << "=== Stats test ===" << std::endl;
+
+    assert(JsonStats::enabled());
+    assert(JsonStats::current() == nullptr);
+
+    const std::string text = "{\"a\":[1,2.5,true,null],\"b\":{\"c\":\"x\\ny\"},\"d\":\"plain\"}";
+    JsonObject obj;
+
+    // nothing is collected without a sink or a callback
+    JsonResult result = JsonObject::parse(text, obj);
+    assert(result.ok());
+
+    JsonStats stats;
+    JsonStats::setSink(&stats);
+
+    result = JsonObject::parse(text, obj);
+    assert(result.ok());
+
+    assert(stats.calls[JSON_PHASE_PARSE] == 1);
+    assert(stats.bytesRead == text.size());
+    assert(stats.nodes[JSON_MAP] == 2 && stats.nodes[JSON_ARRAY] == 1);
+    assert(stats.nodes[JSON_NUMBER] == 2 && stats.nodes[JSON_BOOLEAN] == 1 && stats.nodes[JSON_NULL] == 1);
+    assert(stats.nodes[JSON_STRING] == 2 && stats.totalNodes() == 9);
+    assert(stats.maxDepth == 2);
+    assert(stats.escapesRead == 1);
+    // keys a, b, c, d and the contents of both strings
+    assert(stats.stringBytesRead == 4 + 4 + 5);
+    assert(stats.allocations > 0);
+    assert(JsonStats::current() == nullptr);
+
+    // serialization counts the same tree and the produced bytes
+    stats.reset();
+
+    std::stringstream out;
+    obj >> out;
+
+    assert(stats.calls[JSON_PHASE_SERIALIZE] == 1);
+    assert(stats.bytesWritten == out.str().size() && out.str() == text);
+    assert(stats.totalNodes() == 9 && stats.maxDepth == 2);
+    assert(stats.escapesWritten == 1);
+    assert(stats.stringBytesWritten == 4 + 3 + 5);
+
+    // the stream parser counts what the buffer parser counts, a thrown error still counts the bytes read
+    stats.reset();
+
+    JsonObject streamed;
+    std::stringstream in(text);
+    streamed << in;
+
+    assert(stats.calls[JSON_PHASE_PARSE] == 1 && stats.bytesRead == text.size());
+    assert(stats.totalNodes() == 9 && stats.nodes[JSON_STRING] == 2 && stats.maxDepth == 2);
+    assert(stats.escapesRead == 1 && stats.stringBytesRead == 4 + 4 + 5);
+    assert(stats.allocations > 0 && streamed == obj);
+
+    stats.reset();
+    bool thrown = false;
+
+    try {
+        std::stringstream bad("[1,2,] ");
+        streamed << bad;
+    }
+    catch (const JsonObjectException&) {
+        thrown = true;
+    }
+
+    assert(thrown && stats.calls[JSON_PHASE_PARSE] == 1 && stats.bytesRead == 6);
+
+    // validation reports its own phase, a failure still counts the bytes consumed
+    stats.reset();
+
+    result = JsonObject::validate(text);
+    assert(result.ok());
+
+    result = JsonObject::validate("[1,2,]");
+    assert(!result);
+    assert(stats.calls[JSON_PHASE_VALIDATE] == 2 && stats.calls[JSON_PHASE_PARSE] == 0);
+    assert(stats.bytesRead == text.size() + 5);
+
+    // mergeFrom validates first, both phases are reported once
+    stats.reset();
+
+    result = obj.mergeFrom("{\"d\":null}");
+    assert(result.ok());
+    assert(stats.calls[JSON_PHASE_PARSE] == 1 && stats.calls[JSON_PHASE_VALIDATE] == 1);
+    assert(stats.bytesRead == 2 * 10);
+
+    // bound types go through the same reader and writer
+    stats.reset();
+
+    Point point;
+    decode("{\"x\":3,\"y\":4}", point);
+    std::string encoded = encode(point);
+    assert(encoded == "{\"x\":3,\"y\":4}");
+    assert(stats.calls[JSON_PHASE_PARSE] == 1 && stats.calls[JSON_PHASE_SERIALIZE] == 1);
+    assert(stats.nodes[JSON_NUMBER] == 2 && stats.bytesRead == 13 && stats.bytesWritten == 13);
+
+    JsonStats::setSink(nullptr);
+
+    // a callback gets every operation on its own
+    int userCalls = 0;
+    JsonStats::setCallback(onStats, &userCalls);
+
+    result = JsonObject::parse("[[[]]]", obj);
+    assert(result.ok());
+    assert(callbacks == 1 && userCalls == 1 && lastPhase == JSON_PHASE_PARSE);
+    assert(lastStats.maxDepth == 3 && lastStats.nodes[JSON_ARRAY] == 3 && lastStats.bytesRead == 6);
+
+    result = obj.mergeFrom("[1]");
+    assert(result.ok());
+    assert(callbacks == 3 && lastPhase == JSON_PHASE_PARSE);
+    assert(lastStats.calls[JSON_PHASE_VALIDATE] == 1 && lastStats.calls[JSON_PHASE_PARSE] == 1);
+
+    JsonStats::setCallback(nullptr);
+
+    stats.reset();
+    result = JsonObject::parse(text, obj);
+    assert(result.ok());
+    assert(stats.calls[JSON_PHASE_PARSE] == 0 && callbacks == 3);
+
+    std::cout << "Parse, validate, serialize and bound types counted" << std::endl << std::endl;
+
+    return 0;
+}
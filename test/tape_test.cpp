@@ -0,0 +1,114 @@
+#include <jsontape.hpp>
+#include <jsonobject.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static std::string readFile(const char* path) {
+    std::ifstream ifs(path);
+    assert(ifs.is_open());
+
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+
+static std::string minified(JsonObject& obj) {
+    std::stringstream ss;
+    obj.setMinificationEnabled(true);
+    obj >> ss;
+    return ss.str();
+}
+
+int main() {
+    std::cout << "=== Tape test ===" << std::endl;
+
+    std::string page = readFile(PAGE_JSON_PATH);
+    JsonTape tape;
+
+    JsonResult parsed = JsonTape::parse(page, tape);
+    assert(parsed.ok());
+    std::cout << "page.json: " << tape.tapeSize() << " words, " << tape.stringsSize() << " string bytes" << std::endl;
+
+    JsonTapeView root = tape.root();
+    assert(root.isMap() && root.size() == 8);
+    assert(root["requestId"].numberLong() == 5412985);
+    assert(!root["missing"].valid() && !root.hasKey("missing"));
+
+    JsonTapeView profiles = root["profiles"];
+    assert(profiles.isArray() && profiles.size() == 2);
+    assert(profiles[1]["transport"].str() == "Honda Civic");
+    assert(!profiles[2].valid());
+
+    size_t count = 0;
+    for (JsonTapeView profile : profiles) {
+        assert(profile.isMap());
+        count++;
+    }
+    assert(count == 2);
+
+    // the tree rebuilt from the tape must match the one parsed directly
+    JsonObject expected;
+    parsed = JsonObject::parse(page, expected);
+    assert(parsed.ok());
+
+    JsonObject actual = root.toObject();
+    assert(minified(actual) == minified(expected));
+
+    // document order and duplicate keys are kept on the tape, lookups see the last value
+    parsed = JsonTape::parse("{\"b\": 1, \"a\": [], \"b\": \"x\\u0041\"}", tape);
+    assert(parsed.ok());
+    root = tape.root();
+
+    auto it = root.begin();
+    assert(it.key() == "b" && (*it).numberLong() == 1);
+    ++it;
+    assert(it.key() == "a" && (*it).isArray() && (*it).size() == 0 && (*it).begin() == (*it).end());
+    ++it;
+    assert(it.key() == "b");
+    ++it;
+    assert(it == root.end());
+    assert(root.size() == 3 && root["b"].str() == "xA");
+
+    parsed = JsonTape::parse("[-9007199254740993, 2.5e3, true, false, null]", tape);
+    assert(parsed.ok());
+    root = tape.root();
+    assert(root[0].numberLong() == -9007199254740993L);
+    assert(root[1].number() == 2500.0);
+    assert(root[2].boolean() && !root[3].boolean() && root[3].isBoolean());
+    assert(root[4].isNull() && root[4].valid());
+
+    parsed = JsonTape::parse("\"scalar\"", tape);
+    assert(parsed.ok() && tape.root().str() == "scalar");
+
+    // errors match the tree parser
+    std::string malformed = readFile(MALFORMED_JSON_PATH);
+    size_t begin = 0;
+
+    while (begin < malformed.size()) {
+        size_t end = malformed.find("\n\n", begin);
+        if (end == std::string::npos) end = malformed.size();
+
+        if (end > begin) {
+            JsonObject obj;
+            JsonResult result = JsonTape::parse(malformed.data() + begin, end - begin, tape);
+            JsonResult reference = JsonObject::parse(malformed.data() + begin, end - begin, obj);
+
+            assert(!result && !tape.root().valid());
+            assert(result.error == reference.error && result.pos == reference.pos);
+        }
+
+        begin = end + 2;
+    }
+
+    std::string nested = std::string(5000, '[') + std::string(5000, ']');
+    parsed = JsonTape::parse(nested, tape);
+    assert(parsed.error == JSON_ERROR_DEPTH_EXCEEDED);
+
+    std::cout << std::endl;
+
+    return 0;
+}
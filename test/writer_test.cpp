@@ -0,0 +1,82 @@
+#include <jsonobject.hpp>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+using namespace jsonmini;
+
+static std::string serialize(JsonObject obj) {
+    std::stringstream out;
+    obj >> out;
+    return out.str();
+}
+
+// reals are written in the shortest form that parses back to the same bits
+static void expectReal(double value, const std::string& text) {
+    assert(serialize(JsonObject(value)) == text);
+
+    JsonObject parsed;
+    JsonResult result = JsonObject::parse(text, parsed);
+    assert(result.ok());
+
+    double back = parsed.number();
+    assert(std::memcmp(&back, &value, sizeof(double)) == 0);
+}
+
+int main() {
+    std::cout << "=== Writer test ===" << std::endl;
+
+    std::ifstream ifs(PAGE_JSON_PATH);
+    assert(ifs.is_open());
+
+    JsonObject obj;
+    obj << ifs;
+
+    // indentation and short arrays of scalars on one line
+    JsonStyle style;
+    style.indentChar = ' ';
+    style.indentWidth = 2;
+    style.compactArrayThreshold = 8;
+
+    obj.setMinificationEnabled(false);
+    obj.setStyle(style);
+
+    std::stringstream styled;
+    obj >> styled;
+
+    assert(styled.str().find("\n  \"nextPage\": {\n    \"from\": 0,") != std::string::npos);
+    assert(styled.str().find("\"pets\": [\"dog\", \"cat\", \"parrot\"]") != std::string::npos);
+
+    // the styled output reads back as the same document
+    JsonObject reparsed;
+    std::stringstream expected, actual;
+
+    reparsed << styled;
+    obj.setMinificationEnabled(true);
+    obj >> expected;
+    reparsed >> actual;
+
+    assert(expected.str() == actual.str());
+
+    std::cout << "custom style output matches the original document" << std::endl;
+
+    // 15 significant digits would give 0.3 and 0.333333333333333, which are other doubles
+    expectReal(0.1, "0.1");
+    expectReal(0.1 + 0.2, "0.30000000000000004");
+    expectReal(1.0 / 3, "0.3333333333333333");
+    expectReal(1e300, "1e+300");
+    expectReal(5e-324, "5e-324");
+    expectReal(-1.5e-7, "-1.5e-07");
+    expectReal(123456789012345680.0, "123456789012345680");
+
+    // "-0" would read back as the integer 0, negative zero keeps a fraction to stay real
+    expectReal(-0.0, "-0.0");
+    assert(serialize(JsonObject::makeArray(std::vector<double>{ 0.1 + 0.2, -0.0 })) == "[0.30000000000000004,-0.0]");
+
+    std::cout << std::endl;
+
+    return 0;
+}